@@ -0,0 +1,19 @@
+#include "Game/AllocationCounter.hpp"
+
+#include <atomic>
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0u};
+std::atomic<uint64_t> allocated_bytes{0u};
+
+} // namespace
+
+void RecordAllocation(std::size_t bytes) noexcept {
+    allocation_count.fetch_add(1u, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+AllocationCounts GetAllocationCounts() noexcept {
+    return AllocationCounts{allocation_count.load(std::memory_order_relaxed), allocated_bytes.load(std::memory_order_relaxed)};
+}
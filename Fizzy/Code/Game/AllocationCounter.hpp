@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//Heap allocations made through the global operator new since the program
+//started. Only FizzyHeadless counts them: Main_Headless.cpp replaces
+//operator new to call RecordAllocation, so in the game they stay at zero.
+struct AllocationCounts {
+    uint64_t count{};
+    uint64_t bytes{};
+};
+
+void RecordAllocation(std::size_t bytes) noexcept;
+[[nodiscard]] AllocationCounts GetAllocationCounts() noexcept;
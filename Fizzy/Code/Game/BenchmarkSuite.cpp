@@ -0,0 +1,356 @@
+#include "Game/BenchmarkSuite.hpp"
+
+#include "Game/FrameProfiler.hpp"
+#include "Game/GameStateConstraints.hpp"
+#include "Game/GameStateGravityDrag.hpp"
+#include "Game/GameStateSleepManagement.hpp"
+#include "Game/GameStateStress.hpp"
+#include "Game/JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+//Timings below this are mostly noise and are not compared.
+constexpr double noise_floor_milliseconds = 0.01;
+
+BenchmarkCaseResult RunCase(const std::string& name, const HeadlessSimulationDesc& desc) noexcept {
+    auto simulation_result = HeadlessSimulationResult{};
+    {
+        HeadlessSimulation simulation{desc};
+        simulation_result = simulation.Run();
+    }
+    auto result = BenchmarkCaseResult{};
+    result.name = name;
+    result.body_count = simulation_result.body_count;
+    result.steps = simulation_result.steps;
+    result.setup_milliseconds = simulation_result.setup_milliseconds;
+    result.milliseconds_per_step = simulation_result.milliseconds_per_step;
+    result.allocations_per_step = simulation_result.allocations_per_step;
+    result.allocated_bytes_per_step = simulation_result.allocated_bytes_per_step;
+#if !defined(FINAL_BUILD)
+    for(std::size_t i = 0u; i < FrameProfiler::stage_count; ++i) {
+        const auto stage = static_cast<ProfileStage>(i);
+        const auto stats = g_theFrameProfiler.CalcStats(stage);
+        result.stages.push_back(BenchmarkStageTiming{GetProfileStageName(stage), stats.avg_ms, stats.p99_ms});
+    }
+#endif
+    return result;
+}
+
+void WriteString(std::ostream& os, const std::string& text) noexcept {
+    os << '"';
+    for(const auto c : text) {
+        if(c == '"' || c == '\\') {
+            os << '\\';
+        }
+        os << c;
+    }
+    os << '"';
+}
+
+//Reads the subset of JSON SaveJson writes: objects, arrays, strings without
+//escapes other than \" and \\, numbers, and true/false/null, which are skipped.
+class JsonReader {
+public:
+    explicit JsonReader(std::string text) noexcept
+        : _text{std::move(text)}
+    {
+        /* DO NOTHING */
+    }
+
+    [[nodiscard]] bool Consume(char c) noexcept {
+        SkipSpace();
+        if(_position < _text.size() && _text[_position] == c) {
+            ++_position;
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool Peek(char c) noexcept {
+        SkipSpace();
+        return _position < _text.size() && _text[_position] == c;
+    }
+
+    [[nodiscard]] bool ReadString(std::string& value) noexcept {
+        if(!Consume('"')) {
+            return false;
+        }
+        value.clear();
+        while(_position < _text.size() && _text[_position] != '"') {
+            if(_text[_position] == '\\') {
+                ++_position;
+            }
+            if(_position < _text.size()) {
+                value.push_back(_text[_position++]);
+            }
+        }
+        return Consume('"');
+    }
+
+    [[nodiscard]] bool ReadNumber(double& value) noexcept {
+        SkipSpace();
+        const auto* first = _text.c_str() + _position;
+        char* last = nullptr;
+        value = std::strtod(first, &last);
+        if(last == first) {
+            return false;
+        }
+        _position += static_cast<std::size_t>(last - first);
+        return true;
+    }
+
+    //Calls member_fn(key) for each member of an object; it must read the value.
+    template<typename MemberFn>
+    [[nodiscard]] bool ReadObject(MemberFn&& member_fn) noexcept {
+        if(!Consume('{')) {
+            return false;
+        }
+        if(Consume('}')) {
+            return true;
+        }
+        do {
+            auto key = std::string{};
+            if(!ReadString(key) || !Consume(':') || !member_fn(key)) {
+                return false;
+            }
+        } while(Consume(','));
+        return Consume('}');
+    }
+
+    //Calls element_fn() for each element of an array; it must read the element.
+    template<typename ElementFn>
+    [[nodiscard]] bool ReadArray(ElementFn&& element_fn) noexcept {
+        if(!Consume('[')) {
+            return false;
+        }
+        if(Consume(']')) {
+            return true;
+        }
+        do {
+            if(!element_fn()) {
+                return false;
+            }
+        } while(Consume(','));
+        return Consume(']');
+    }
+
+    //Skips a value of a member this version does not know about.
+    [[nodiscard]] bool SkipValue() noexcept {
+        if(Peek('{')) {
+            return ReadObject([this](const std::string&) { return SkipValue(); });
+        }
+        if(Peek('[')) {
+            return ReadArray([this]() { return SkipValue(); });
+        }
+        if(Peek('"')) {
+            auto ignored = std::string{};
+            return ReadString(ignored);
+        }
+        for(const auto* literal : {"true", "false", "null"}) {
+            if(_text.compare(_position, std::char_traits<char>::length(literal), literal) == 0) {
+                _position += std::char_traits<char>::length(literal);
+                return true;
+            }
+        }
+        auto ignored = 0.0;
+        return ReadNumber(ignored);
+    }
+
+    [[nodiscard]] bool IsAtEnd() noexcept {
+        SkipSpace();
+        return _position == _text.size();
+    }
+
+protected:
+private:
+    void SkipSpace() noexcept {
+        while(_position < _text.size() && std::isspace(static_cast<unsigned char>(_text[_position]))) {
+            ++_position;
+        }
+    }
+
+    std::string _text{};
+    std::size_t _position{};
+};
+
+bool ReadSize(JsonReader& reader, std::size_t& value) noexcept {
+    auto number = 0.0;
+    if(!reader.ReadNumber(number) || number < 0.0) {
+        return false;
+    }
+    value = static_cast<std::size_t>(number);
+    return true;
+}
+
+bool ReadStage(JsonReader& reader, BenchmarkStageTiming& stage) noexcept {
+    return reader.ReadObject([&](const std::string& key) {
+        if(key == "avg_ms") {
+            return reader.ReadNumber(stage.avg_milliseconds);
+        } else if(key == "p99_ms") {
+            return reader.ReadNumber(stage.p99_milliseconds);
+        }
+        return reader.SkipValue();
+    });
+}
+
+bool ReadCase(JsonReader& reader, BenchmarkCaseResult& result) noexcept {
+    return reader.ReadObject([&](const std::string& key) {
+        if(key == "name") {
+            return reader.ReadString(result.name);
+        } else if(key == "bodies") {
+            return ReadSize(reader, result.body_count);
+        } else if(key == "steps") {
+            return ReadSize(reader, result.steps);
+        } else if(key == "setup_ms") {
+            return reader.ReadNumber(result.setup_milliseconds);
+        } else if(key == "ms_per_step") {
+            return reader.ReadNumber(result.milliseconds_per_step);
+        } else if(key == "allocs_per_step") {
+            return reader.ReadNumber(result.allocations_per_step);
+        } else if(key == "alloc_bytes_per_step") {
+            return reader.ReadNumber(result.allocated_bytes_per_step);
+        } else if(key == "stages") {
+            return reader.ReadObject([&](const std::string& stage_name) {
+                auto& stage = result.stages.emplace_back();
+                stage.stage = stage_name;
+                return ReadStage(reader, stage);
+            });
+        }
+        return reader.SkipValue();
+    });
+}
+
+void CompareMetric(std::vector<BenchmarkRegression>& regressions, const std::string& name, const std::string& metric, double baseline, double current, double threshold, double floor) noexcept {
+    if((std::max)(baseline, current) < floor) {
+        return;
+    }
+    if(current > baseline * (1.0 + threshold)) {
+        regressions.push_back(BenchmarkRegression{name, metric, baseline, current});
+    }
+}
+
+} // namespace
+
+namespace BenchmarkSuite {
+
+BenchmarkSuiteResult Run(const BenchmarkSuiteDesc& desc) noexcept {
+    static const std::array<std::pair<const char*, GUID>, 3> demo_states{
+        std::make_pair("GravityDrag", GameStateGravityDrag::ID)
+        , std::make_pair("Constraints", GameStateConstraints::ID)
+        , std::make_pair("SleepManagement", GameStateSleepManagement::ID)
+    };
+    auto result = BenchmarkSuiteResult{};
+    result.workers = g_theJobSystem.GetWorkerCount();
+    auto simulation = desc.simulation;
+    for(const auto& [name, id] : demo_states) {
+        simulation.stateId = id;
+        result.cases.push_back(RunCase(name, simulation));
+    }
+    const auto stress = GameStateStress::GetSceneDescription();
+    simulation.stateId = GameStateStress::ID;
+    for(const auto body_count : desc.body_counts) {
+        //Every scaled case builds the same kind of scene, differing only in size.
+        auto scaled = StressSceneDesc{};
+        scaled.body_count = body_count;
+        GameStateStress::SetSceneDescription(scaled);
+        result.cases.push_back(RunCase("Stress/" + std::to_string(body_count), simulation));
+    }
+    GameStateStress::SetSceneDescription(stress);
+    return result;
+}
+
+bool SaveJson(const std::filesystem::path& filepath, const BenchmarkSuiteResult& result) noexcept {
+    std::error_code ec{};
+    if(filepath.has_parent_path()) {
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+    }
+    std::ofstream ofs{filepath, std::ios_base::trunc};
+    if(!ofs) {
+        return false;
+    }
+    ofs << std::setprecision(9);
+    ofs << "{\n"
+        << "  \"version\": " << current_version << ",\n"
+        << "  \"workers\": " << result.workers << ",\n"
+        << "  \"cases\": [";
+    for(std::size_t i = 0u; i < result.cases.size(); ++i) {
+        const auto& c = result.cases[i];
+        ofs << (i ? ",\n" : "\n") << "    {\n"
+            << "      \"name\": ";
+        WriteString(ofs, c.name);
+        ofs << ",\n"
+            << "      \"bodies\": " << c.body_count << ",\n"
+            << "      \"steps\": " << c.steps << ",\n"
+            << "      \"setup_ms\": " << c.setup_milliseconds << ",\n"
+            << "      \"ms_per_step\": " << c.milliseconds_per_step << ",\n"
+            << "      \"allocs_per_step\": " << c.allocations_per_step << ",\n"
+            << "      \"alloc_bytes_per_step\": " << c.allocated_bytes_per_step << ",\n"
+            << "      \"stages\": {";
+        for(std::size_t k = 0u; k < c.stages.size(); ++k) {
+            const auto& stage = c.stages[k];
+            ofs << (k ? ",\n" : "\n") << "        ";
+            WriteString(ofs, stage.stage);
+            ofs << ": {\"avg_ms\": " << stage.avg_milliseconds << ", \"p99_ms\": " << stage.p99_milliseconds << '}';
+        }
+        ofs << (c.stages.empty() ? "}\n" : "\n      }\n") << "    }";
+    }
+    ofs << (result.cases.empty() ? "]\n" : "\n  ]\n") << "}\n";
+    return static_cast<bool>(ofs);
+}
+
+bool LoadJson(const std::filesystem::path& filepath, BenchmarkSuiteResult& result) noexcept {
+    std::ifstream ifs{filepath};
+    if(!ifs) {
+        return false;
+    }
+    auto reader = JsonReader{std::string{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}}};
+    auto loaded = BenchmarkSuiteResult{};
+    auto version = 0.0;
+    const auto valid = reader.ReadObject([&](const std::string& key) {
+        if(key == "version") {
+            return reader.ReadNumber(version);
+        } else if(key == "workers") {
+            return ReadSize(reader, loaded.workers);
+        } else if(key == "cases") {
+            return reader.ReadArray([&]() { return ReadCase(reader, loaded.cases.emplace_back()); });
+        }
+        return reader.SkipValue();
+    });
+    if(!valid || !reader.IsAtEnd() || static_cast<int>(version) != current_version) {
+        return false;
+    }
+    result = std::move(loaded);
+    return true;
+}
+
+std::vector<BenchmarkRegression> Compare(const BenchmarkSuiteResult& baseline, const BenchmarkSuiteResult& current, double threshold) noexcept {
+    auto regressions = std::vector<BenchmarkRegression>{};
+    for(const auto& now : current.cases) {
+        const auto before = std::find_if(std::cbegin(baseline.cases), std::cend(baseline.cases), [&now](const BenchmarkCaseResult& c) { return c.name == now.name; });
+        if(before == std::cend(baseline.cases)) {
+            continue;
+        }
+        CompareMetric(regressions, now.name, "ms/step", before->milliseconds_per_step, now.milliseconds_per_step, threshold, noise_floor_milliseconds);
+        //Any new allocation in a case that made none is a regression.
+        CompareMetric(regressions, now.name, "allocs/step", before->allocations_per_step, now.allocations_per_step, threshold, 0.0);
+        for(const auto& stage : now.stages) {
+            const auto stage_before = std::find_if(std::cbegin(before->stages), std::cend(before->stages), [&stage](const BenchmarkStageTiming& s) { return s.stage == stage.stage; });
+            if(stage_before != std::cend(before->stages)) {
+                CompareMetric(regressions, now.name, stage.stage + " avg ms", stage_before->avg_milliseconds, stage.avg_milliseconds, threshold, noise_floor_milliseconds);
+            }
+        }
+    }
+    return regressions;
+}
+
+} // namespace BenchmarkSuite
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Game/HeadlessSimulation.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct BenchmarkSuiteDesc {
+    //Steps, rate and debug drawing of every case; stateId is ignored.
+    HeadlessSimulationDesc simulation{};
+    //Body counts of the scaled Stress cases.
+    std::vector<std::size_t> body_counts{100u, 1000u, 10000u, 100000u};
+};
+
+struct BenchmarkStageTiming {
+    std::string stage{};
+    double avg_milliseconds = 0.0;
+    double p99_milliseconds = 0.0;
+};
+
+struct BenchmarkCaseResult {
+    //The demo's name, or "Stress/<body count>" for a scaled case.
+    std::string name{};
+    std::size_t body_count = 0u;
+    std::size_t steps = 0u;
+    double setup_milliseconds = 0.0;
+    double milliseconds_per_step = 0.0;
+    double allocations_per_step = 0.0;
+    double allocated_bytes_per_step = 0.0;
+    //From the frame profiler, over the last steps it keeps. Empty in FinalBuild.
+    std::vector<BenchmarkStageTiming> stages{};
+};
+
+struct BenchmarkSuiteResult {
+    std::size_t workers = 0u;
+    std::vector<BenchmarkCaseResult> cases{};
+};
+
+struct BenchmarkRegression {
+    std::string name{};
+    //"ms/step", "allocs/step" or "<stage> avg ms".
+    std::string metric{};
+    double baseline = 0.0;
+    double current = 0.0;
+};
+
+//Runs every demo state and the Stress state at each of a list of body
+//counts headlessly, and saves what each one cost per step as JSON so a later
+//run can be compared against it.
+namespace BenchmarkSuite {
+
+inline constexpr int current_version = 1;
+
+//Changes GameStateStress's scene description while it runs and puts it back afterwards.
+[[nodiscard]] BenchmarkSuiteResult Run(const BenchmarkSuiteDesc& desc) noexcept;
+[[nodiscard]] bool SaveJson(const std::filesystem::path& filepath, const BenchmarkSuiteResult& result) noexcept;
+//Reads a file written by SaveJson. Returns false if it is missing or malformed.
+[[nodiscard]] bool LoadJson(const std::filesystem::path& filepath, BenchmarkSuiteResult& result) noexcept;
+//Metrics of the cases in both results that grew by more than threshold, a
+//fraction of the baseline: 0.1 flags anything over 10% slower. Timings too
+//small to measure reliably are not compared.
+[[nodiscard]] std::vector<BenchmarkRegression> Compare(const BenchmarkSuiteResult& baseline, const BenchmarkSuiteResult& current, double threshold) noexcept;
+
+} // namespace BenchmarkSuite
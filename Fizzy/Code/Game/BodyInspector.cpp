@@ -0,0 +1,154 @@
+#include "Game/BodyInspector.hpp"
+
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr int body_list_rows = 12;
+
+} // namespace
+
+bool BodyInspector::ShowSelectionCombo(const Scene& scene, std::size_t& selected) noexcept {
+    char label[32]{};
+    std::snprintf(label, sizeof(label), "Body %zu", selected);
+    bool changed = false;
+    if(ImGui::BeginCombo("Selected Body", label)) {
+        UpdateFilter(scene);
+        ImGuiListClipper clipper{};
+        clipper.Begin(static_cast<int>(GetVisibleCount(scene)));
+        while(clipper.Step()) {
+            for(int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const auto index = GetVisibleIndex(static_cast<std::size_t>(row));
+                const bool is_selected = index == selected;
+                std::snprintf(label, sizeof(label), "Body %zu", index);
+                if(ImGui::Selectable(label, is_selected)) {
+                    changed = !is_selected;
+                    selected = index;
+                }
+                if(is_selected) {
+                    ImGui::SetItemDefaultFocus();
+                }
+            }
+        }
+        clipper.End();
+        ImGui::EndCombo();
+    }
+    return changed;
+}
+
+bool BodyInspector::ShowBodyList(const Scene& scene, std::size_t& selected, ImGuiTreeNodeFlags header_flags /*= 0*/) noexcept {
+    const auto body_count = scene.GetBodyCount();
+    char label[48]{};
+    //### keeps the header's id stable while the count in its label changes.
+    std::snprintf(label, sizeof(label), "Bodies - %zu###Bodies", body_count);
+    if(!ImGui::CollapsingHeader(label, header_flags)) {
+        return false;
+    }
+    ShowFilterUI();
+    UpdateFilter(scene);
+    const auto visible_count = GetVisibleCount(scene);
+    if(IsFiltering()) {
+        ImGui::Text("Showing %zu of %zu", visible_count, body_count);
+    }
+    bool changed = false;
+    const auto list_height = ImGui::GetTextLineHeightWithSpacing() * static_cast<float>(body_list_rows);
+    if(ImGui::BeginChild("BodyList", ImVec2{0.0f, list_height}, true)) {
+        ImGuiListClipper clipper{};
+        clipper.Begin(static_cast<int>(visible_count));
+        while(clipper.Step()) {
+            for(int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const auto index = GetVisibleIndex(static_cast<std::size_t>(row));
+                const auto& body = scene.GetBody(index);
+                const bool is_selected = index == selected;
+                std::snprintf(label, sizeof(label), "Body %zu%s", index, body.IsAwake() ? "" : " (asleep)");
+                if(ImGui::Selectable(label, is_selected)) {
+                    changed = !is_selected;
+                    selected = index;
+                }
+            }
+        }
+        clipper.End();
+    }
+    ImGui::EndChild();
+    if(selected < body_count) {
+        ImGui::Text("Body %zu", selected);
+        ShowBodyParameters(scene.GetBody(selected));
+    }
+    return changed;
+}
+
+void BodyInspector::ShowBodyParameters(const RigidBody& body) noexcept {
+    const auto& acc = body.GetAcceleration();
+    const auto& vel = body.GetVelocity();
+    const auto& pos = body.GetPosition();
+    const auto aacc = body.GetAngularAccelerationDegrees();
+    const auto avel = body.GetAngularVelocityDegrees();
+    const auto apos = body.GetOrientationDegrees();
+    const auto mass = body.GetMass();
+    ImGui::Text("Awake: %s", (body.IsAwake() ? "true" : "false"));
+    ImGui::Text("M: %f", mass);
+    ImGui::Text("A: [%f, %f]", acc.x, acc.y);
+    ImGui::Text("V: [%f, %f]", vel.x, vel.y);
+    ImGui::Text("P: [%f, %f]", pos.x, pos.y);
+    ImGui::Text("oA: %f", aacc);
+    ImGui::Text("oV: %f", avel);
+    ImGui::Text("oP: %f", apos);
+}
+
+void BodyInspector::ShowFilterUI() noexcept {
+    if(ImGui::InputText("Index", _index_filter, sizeof(_index_filter))) {
+        //Accepts "n" or "first-last".
+        unsigned long long first{};
+        unsigned long long last{};
+        const auto fields = std::sscanf(_index_filter, "%llu-%llu", &first, &last);
+        _has_index_filter = fields >= 1;
+        _index_min = static_cast<std::size_t>(first);
+        _index_max = static_cast<std::size_t>(fields == 2 ? last : first);
+    }
+    const char* properties[] = {"All", "Awake", "Asleep", "Gravity", "No gravity"};
+    ImGui::Combo("Show", &_property_filter, properties, 5);
+}
+
+void BodyInspector::UpdateFilter(const Scene& scene) noexcept {
+    _filtered.clear();
+    if(!IsFiltering()) {
+        return;
+    }
+    const auto body_count = scene.GetBodyCount();
+    const auto first = _has_index_filter ? _index_min : std::size_t{0u};
+    const auto last = _has_index_filter ? (std::min)(_index_max + 1u, body_count) : body_count;
+    for(auto i = first; i < last; ++i) {
+        if(PassesFilter(scene.GetBody(i), i)) {
+            _filtered.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+bool BodyInspector::IsFiltering() const noexcept {
+    return _has_index_filter || static_cast<PropertyFilter>(_property_filter) != PropertyFilter::All;
+}
+
+bool BodyInspector::PassesFilter(const RigidBody& body, std::size_t index) const noexcept {
+    if(_has_index_filter && (index < _index_min || _index_max < index)) {
+        return false;
+    }
+    switch(static_cast<PropertyFilter>(_property_filter)) {
+    case PropertyFilter::All: return true;
+    case PropertyFilter::Awake: return body.IsAwake();
+    case PropertyFilter::Asleep: return !body.IsAwake();
+    case PropertyFilter::Gravity: return body.IsGravityEnabled();
+    case PropertyFilter::NoGravity: return !body.IsGravityEnabled();
+    default: return true;
+    }
+}
+
+std::size_t BodyInspector::GetVisibleCount(const Scene& scene) const noexcept {
+    return IsFiltering() ? _filtered.size() : scene.GetBodyCount();
+}
+
+std::size_t BodyInspector::GetVisibleIndex(std::size_t row) const noexcept {
+    return IsFiltering() ? _filtered[row] : row;
+}
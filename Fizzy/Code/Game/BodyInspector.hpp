@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Engine/Physics/RigidBody.hpp"
+
+#include "Engine/UI/UISystem.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+//Debug window panels for browsing a scene's bodies. Lists are clipped so
+//only visible rows are formatted, labels are formatted into stack buffers
+//and the filter reuses its index buffer, so an open panel does not allocate
+//per frame however many bodies the scene has.
+class BodyInspector {
+public:
+    BodyInspector() = default;
+    BodyInspector(const BodyInspector& other) = default;
+    BodyInspector(BodyInspector&& other) = default;
+    BodyInspector& operator=(const BodyInspector& other) = default;
+    BodyInspector& operator=(BodyInspector&& other) = default;
+    ~BodyInspector() = default;
+
+    //Returns true if the selection changed.
+    bool ShowSelectionCombo(const Scene& scene, std::size_t& selected) noexcept;
+    //Filter controls, the filtered bodies and the selected body's parameters.
+    //Returns true if the selection changed.
+    bool ShowBodyList(const Scene& scene, std::size_t& selected, ImGuiTreeNodeFlags header_flags = 0) noexcept;
+
+    static void ShowBodyParameters(const RigidBody& body) noexcept;
+
+protected:
+private:
+    enum class PropertyFilter : int {
+        All
+        , Awake
+        , Asleep
+        , Gravity
+        , NoGravity
+    };
+
+    void ShowFilterUI() noexcept;
+    void UpdateFilter(const Scene& scene) noexcept;
+    [[nodiscard]] bool IsFiltering() const noexcept;
+    [[nodiscard]] bool PassesFilter(const RigidBody& body, std::size_t index) const noexcept;
+    [[nodiscard]] std::size_t GetVisibleCount(const Scene& scene) const noexcept;
+    [[nodiscard]] std::size_t GetVisibleIndex(std::size_t row) const noexcept;
+
+    std::vector<uint32_t> _filtered{};
+    char _index_filter[32]{};
+    std::size_t _index_min{};
+    std::size_t _index_max{};
+    int _property_filter{};
+    bool _has_index_filter = false;
+};
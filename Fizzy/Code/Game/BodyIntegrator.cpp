@@ -0,0 +1,259 @@
+#include "Game/BodyIntegrator.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Game/JobSystem.hpp"
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FIZZY_HAS_X86_SIMD
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//GCC and Clang only emit AVX2 instructions in functions marked for it; MSVC emits whatever intrinsics it is given.
+#if defined(FIZZY_HAS_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define FIZZY_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FIZZY_TARGET_AVX2
+#endif
+
+namespace {
+
+//Multiple of every kernel's lane width so only the last chunk has a scalar tail.
+constexpr std::size_t integration_chunk_size = 8192u;
+
+struct IntegrationArrays {
+    float* position_x{};
+    float* position_y{};
+    float* velocity_x{};
+    float* velocity_y{};
+    const float* acceleration_x{};
+    const float* acceleration_y{};
+    const float* inverse_mass{};
+    const float* gravity_mask{};
+    const float* drag_mask{};
+};
+
+//Every kernel evaluates the same expressions in the same order.
+void IntegrateScalar(const IntegrationArrays& a, const IntegrationParams& params, float dt, std::size_t first, std::size_t last) noexcept {
+    for(auto i = first; i < last; ++i) {
+        const auto vx = a.velocity_x[i];
+        const auto vy = a.velocity_y[i];
+        const auto speed = std::sqrt(vx * vx + vy * vy);
+        const auto drag = (params.drag_k1 + params.drag_k2 * speed) * a.inverse_mass[i] * a.drag_mask[i];
+        const auto ax = a.acceleration_x[i] + params.gravity.x * a.gravity_mask[i] - drag * vx;
+        const auto ay = a.acceleration_y[i] + params.gravity.y * a.gravity_mask[i] - drag * vy;
+        const auto new_vx = vx + ax * dt;
+        const auto new_vy = vy + ay * dt;
+        a.velocity_x[i] = new_vx;
+        a.velocity_y[i] = new_vy;
+        a.position_x[i] += new_vx * dt;
+        a.position_y[i] += new_vy * dt;
+    }
+}
+
+#if defined(FIZZY_HAS_X86_SIMD)
+
+//Returns the first index left for the scalar tail.
+std::size_t IntegrateSSE(const IntegrationArrays& a, const IntegrationParams& params, float dt, std::size_t first, std::size_t last) noexcept {
+    const auto k1 = _mm_set1_ps(params.drag_k1);
+    const auto k2 = _mm_set1_ps(params.drag_k2);
+    const auto gx = _mm_set1_ps(params.gravity.x);
+    const auto gy = _mm_set1_ps(params.gravity.y);
+    const auto step = _mm_set1_ps(dt);
+    auto i = first;
+    for(; i + 4u <= last; i += 4u) {
+        const auto vx = _mm_loadu_ps(a.velocity_x + i);
+        const auto vy = _mm_loadu_ps(a.velocity_y + i);
+        const auto speed = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+        const auto drag = _mm_mul_ps(_mm_mul_ps(_mm_add_ps(k1, _mm_mul_ps(k2, speed)), _mm_loadu_ps(a.inverse_mass + i)), _mm_loadu_ps(a.drag_mask + i));
+        const auto gravity_mask = _mm_loadu_ps(a.gravity_mask + i);
+        const auto ax = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(a.acceleration_x + i), _mm_mul_ps(gx, gravity_mask)), _mm_mul_ps(drag, vx));
+        const auto ay = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(a.acceleration_y + i), _mm_mul_ps(gy, gravity_mask)), _mm_mul_ps(drag, vy));
+        const auto new_vx = _mm_add_ps(vx, _mm_mul_ps(ax, step));
+        const auto new_vy = _mm_add_ps(vy, _mm_mul_ps(ay, step));
+        _mm_storeu_ps(a.velocity_x + i, new_vx);
+        _mm_storeu_ps(a.velocity_y + i, new_vy);
+        _mm_storeu_ps(a.position_x + i, _mm_add_ps(_mm_loadu_ps(a.position_x + i), _mm_mul_ps(new_vx, step)));
+        _mm_storeu_ps(a.position_y + i, _mm_add_ps(_mm_loadu_ps(a.position_y + i), _mm_mul_ps(new_vy, step)));
+    }
+    return i;
+}
+
+FIZZY_TARGET_AVX2 std::size_t IntegrateAVX2(const IntegrationArrays& a, const IntegrationParams& params, float dt, std::size_t first, std::size_t last) noexcept {
+    const auto k1 = _mm256_set1_ps(params.drag_k1);
+    const auto k2 = _mm256_set1_ps(params.drag_k2);
+    const auto gx = _mm256_set1_ps(params.gravity.x);
+    const auto gy = _mm256_set1_ps(params.gravity.y);
+    const auto step = _mm256_set1_ps(dt);
+    auto i = first;
+    for(; i + 8u <= last; i += 8u) {
+        const auto vx = _mm256_loadu_ps(a.velocity_x + i);
+        const auto vy = _mm256_loadu_ps(a.velocity_y + i);
+        const auto speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+        const auto drag = _mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(k1, _mm256_mul_ps(k2, speed)), _mm256_loadu_ps(a.inverse_mass + i)), _mm256_loadu_ps(a.drag_mask + i));
+        const auto gravity_mask = _mm256_loadu_ps(a.gravity_mask + i);
+        const auto ax = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(a.acceleration_x + i), _mm256_mul_ps(gx, gravity_mask)), _mm256_mul_ps(drag, vx));
+        const auto ay = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(a.acceleration_y + i), _mm256_mul_ps(gy, gravity_mask)), _mm256_mul_ps(drag, vy));
+        const auto new_vx = _mm256_add_ps(vx, _mm256_mul_ps(ax, step));
+        const auto new_vy = _mm256_add_ps(vy, _mm256_mul_ps(ay, step));
+        _mm256_storeu_ps(a.velocity_x + i, new_vx);
+        _mm256_storeu_ps(a.velocity_y + i, new_vy);
+        _mm256_storeu_ps(a.position_x + i, _mm256_add_ps(_mm256_loadu_ps(a.position_x + i), _mm256_mul_ps(new_vx, step)));
+        _mm256_storeu_ps(a.position_y + i, _mm256_add_ps(_mm256_loadu_ps(a.position_y + i), _mm256_mul_ps(new_vy, step)));
+    }
+    return i;
+}
+
+bool IsAvx2Available() noexcept {
+#if defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 0);
+    if(info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const auto has_osxsave = (info[2] & (1 << 27)) != 0;
+    const auto has_avx = (info[2] & (1 << 28)) != 0;
+    //The OS must also save the YMM registers on a context switch.
+    if(!has_osxsave || !has_avx || (_xgetbv(0) & 0x6u) != 0x6u) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+} // namespace
+
+const char* GetIntegratorKernelName(IntegratorKernel kernel) noexcept {
+    switch(kernel) {
+    case IntegratorKernel::Scalar: return "Scalar";
+    case IntegratorKernel::SSE: return "SSE";
+    case IntegratorKernel::AVX2: return "AVX2";
+    default: ERROR_AND_DIE("IntegratorKernel values have changed. Refactor GetIntegratorKernelName.");
+    }
+}
+
+bool IsIntegratorKernelSupported(IntegratorKernel kernel) noexcept {
+    switch(kernel) {
+    case IntegratorKernel::Scalar: return true;
+#if defined(FIZZY_HAS_X86_SIMD)
+    //SSE2 is part of every x64 CPU.
+    case IntegratorKernel::SSE: return true;
+    case IntegratorKernel::AVX2:
+    {
+        static const auto has_avx2 = IsAvx2Available();
+        return has_avx2;
+    }
+#endif
+    default: return false;
+    }
+}
+
+IntegratorKernel CalcBestIntegratorKernel() noexcept {
+    if(IsIntegratorKernelSupported(IntegratorKernel::AVX2)) {
+        return IntegratorKernel::AVX2;
+    }
+    if(IsIntegratorKernelSupported(IntegratorKernel::SSE)) {
+        return IntegratorKernel::SSE;
+    }
+    return IntegratorKernel::Scalar;
+}
+
+void BodyIntegrationState::Gather(const Scene& scene) noexcept {
+    const auto count = scene.GetBodyCount();
+    _position_x.resize(count);
+    _position_y.resize(count);
+    _velocity_x.resize(count);
+    _velocity_y.resize(count);
+    _acceleration_x.resize(count);
+    _acceleration_y.resize(count);
+    _inverse_mass.resize(count);
+    _gravity_mask.resize(count);
+    _drag_mask.resize(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        const auto& body = scene.GetBody(i);
+        const auto& position = body.GetPosition();
+        const auto& velocity = body.GetVelocity();
+        const auto& acceleration = body.GetAcceleration();
+        const auto mass = body.GetMass();
+        _position_x[i] = position.x;
+        _position_y[i] = position.y;
+        _velocity_x[i] = velocity.x;
+        _velocity_y[i] = velocity.y;
+        _acceleration_x[i] = acceleration.x;
+        _acceleration_y[i] = acceleration.y;
+        _inverse_mass[i] = mass > 0.0f ? 1.0f / mass : 0.0f;
+        _gravity_mask[i] = body.IsGravityEnabled() ? 1.0f : 0.0f;
+        _drag_mask[i] = body.IsDragEnabled() ? 1.0f : 0.0f;
+    }
+}
+
+void BodyIntegrationState::Integrate(IntegratorKernel kernel, const IntegrationParams& params, TimeUtils::FPSeconds deltaSeconds) noexcept {
+    if(!IsIntegratorKernelSupported(kernel)) {
+        kernel = IntegratorKernel::Scalar;
+    }
+    const auto dt = deltaSeconds.count();
+    g_theJobSystem.ParallelFor(GetBodyCount(), integration_chunk_size, [&](std::size_t first, std::size_t last) {
+        IntegrateRange(kernel, params, dt, first, last);
+    });
+}
+
+void BodyIntegrationState::IntegrateRange(IntegratorKernel kernel, const IntegrationParams& params, float dt, std::size_t first, std::size_t last) noexcept {
+    const auto arrays = IntegrationArrays{
+        _position_x.data()
+        , _position_y.data()
+        , _velocity_x.data()
+        , _velocity_y.data()
+        , _acceleration_x.data()
+        , _acceleration_y.data()
+        , _inverse_mass.data()
+        , _gravity_mask.data()
+        , _drag_mask.data()
+    };
+    auto tail = first;
+    switch(kernel) {
+    case IntegratorKernel::Scalar: break;
+#if defined(FIZZY_HAS_X86_SIMD)
+    case IntegratorKernel::SSE: tail = IntegrateSSE(arrays, params, dt, first, last); break;
+    case IntegratorKernel::AVX2: tail = IntegrateAVX2(arrays, params, dt, first, last); break;
+#endif
+    default: ERROR_AND_DIE("IntegratorKernel values have changed. Refactor BodyIntegrationState::IntegrateRange.");
+    }
+    IntegrateScalar(arrays, params, dt, tail, last);
+}
+
+std::size_t BodyIntegrationState::GetBodyCount() const noexcept {
+    return _position_x.size();
+}
+
+Vector2 BodyIntegrationState::GetPosition(std::size_t index) const noexcept {
+    return Vector2{_position_x[index], _position_y[index]};
+}
+
+Vector2 BodyIntegrationState::GetVelocity(std::size_t index) const noexcept {
+    return Vector2{_velocity_x[index], _velocity_y[index]};
+}
+
+float BodyIntegrationState::CalcMaxDifference(const BodyIntegrationState& other) const noexcept {
+    const auto count = (std::min)(GetBodyCount(), other.GetBodyCount());
+    auto max_difference = 0.0f;
+    for(std::size_t i = 0u; i < count; ++i) {
+        max_difference = (std::max)(max_difference, std::abs(_position_x[i] - other._position_x[i]));
+        max_difference = (std::max)(max_difference, std::abs(_position_y[i] - other._position_y[i]));
+        max_difference = (std::max)(max_difference, std::abs(_velocity_x[i] - other._velocity_x[i]));
+        max_difference = (std::max)(max_difference, std::abs(_velocity_y[i] - other._velocity_y[i]));
+    }
+    return max_difference;
+}
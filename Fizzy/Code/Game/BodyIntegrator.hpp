@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Math/Vector2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+enum class IntegratorKernel : uint8_t {
+    Scalar
+    , SSE //4 bodies per instruction
+    , AVX2 //8 bodies per instruction
+    , Max
+};
+
+[[nodiscard]] const char* GetIntegratorKernelName(IntegratorKernel kernel) noexcept;
+//Checked against the running CPU, not just the compiler.
+[[nodiscard]] bool IsIntegratorKernelSupported(IntegratorKernel kernel) noexcept;
+[[nodiscard]] IntegratorKernel CalcBestIntegratorKernel() noexcept;
+
+struct IntegrationParams {
+    Vector2 gravity{0.0f, 10.0f};
+    //Drag force is -(k1 * |v| + k2 * |v|^2) in the direction of motion.
+    float drag_k1 = 1.0f;
+    float drag_k2 = 1.0f;
+};
+
+//Structure-of-arrays copy of the state gravity, drag and velocity
+//integration touches, one array per component. Flags are stored as 0/1
+//masks so every kernel runs the same branch-free arithmetic; the SIMD
+//kernels only differ from the scalar one in lane width, so results match
+//it bit for bit unless the compiler contracts the scalar path into FMAs.
+//A benchmark prototype: the engine integrates the live bodies itself, so
+//only FizzyHeadless --bench-integrate runs these kernels.
+class BodyIntegrationState {
+public:
+    BodyIntegrationState() = default;
+    BodyIntegrationState(const BodyIntegrationState& other) = default;
+    BodyIntegrationState(BodyIntegrationState&& other) = default;
+    BodyIntegrationState& operator=(const BodyIntegrationState& other) = default;
+    BodyIntegrationState& operator=(BodyIntegrationState&& other) = default;
+    ~BodyIntegrationState() = default;
+
+    //Copies every body's motion state, mass and gravity/drag flags.
+    void Gather(const Scene& scene) noexcept;
+    //One semi-implicit Euler step of every body, split across g_theJobSystem.
+    void Integrate(IntegratorKernel kernel, const IntegrationParams& params, TimeUtils::FPSeconds deltaSeconds) noexcept;
+
+    [[nodiscard]] std::size_t GetBodyCount() const noexcept;
+    [[nodiscard]] Vector2 GetPosition(std::size_t index) const noexcept;
+    [[nodiscard]] Vector2 GetVelocity(std::size_t index) const noexcept;
+    //Largest per-component difference in position or velocity.
+    [[nodiscard]] float CalcMaxDifference(const BodyIntegrationState& other) const noexcept;
+
+protected:
+private:
+    void IntegrateRange(IntegratorKernel kernel, const IntegrationParams& params, float dt, std::size_t first, std::size_t last) noexcept;
+
+    std::vector<float> _position_x{};
+    std::vector<float> _position_y{};
+    std::vector<float> _velocity_x{};
+    std::vector<float> _velocity_y{};
+    std::vector<float> _acceleration_x{};
+    std::vector<float> _acceleration_y{};
+    std::vector<float> _inverse_mass{};
+    std::vector<float> _gravity_mask{};
+    std::vector<float> _drag_mask{};
+};
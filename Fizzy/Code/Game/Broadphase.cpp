@@ -0,0 +1,352 @@
+#include "Game/Broadphase.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Renderer/Rgba.hpp"
+
+#include "Game/DebugDraw.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+//A body touching more cells than this is tested against every other body
+//instead of being listed in each cell, so a ground plane cannot flood the grid.
+constexpr std::size_t max_cells_per_body = 64u;
+//Keeps cell coordinates, and the spans between them, inside int32_t.
+constexpr float max_cell_coord = 1073741824.0f;
+
+bool DoBoundsOverlap(const AABB2& a, const AABB2& b) noexcept {
+    return a.mins.x <= b.maxs.x && b.mins.x <= a.maxs.x
+        && a.mins.y <= b.maxs.y && b.mins.y <= a.maxs.y;
+}
+
+bool DoesBoundsContain(const AABB2& outer, const AABB2& inner) noexcept {
+    return outer.mins.x <= inner.mins.x && inner.maxs.x <= outer.maxs.x
+        && outer.mins.y <= inner.mins.y && inner.maxs.y <= outer.maxs.y;
+}
+
+BroadphasePair MakePair(uint32_t a, uint32_t b) noexcept {
+    return a < b ? BroadphasePair{a, b} : BroadphasePair{b, a};
+}
+
+} // namespace
+
+const char* GetBroadphaseName(BroadphaseType type) noexcept {
+    switch(type) {
+    case BroadphaseType::Quadtree: return "Quadtree";
+    case BroadphaseType::SpatialHash: return "Spatial hash";
+    default: ERROR_AND_DIE("BroadphaseType values have changed. Refactor GetBroadphaseName.");
+    }
+}
+
+SpatialHashBroadphase::SpatialHashBroadphase(float cell_size) noexcept
+    : _requested_cell_size{cell_size}
+{
+    /* DO NOTHING */
+}
+
+float SpatialHashBroadphase::CalcCellSize(const std::vector<AABB2>& bounds) noexcept {
+    if(bounds.empty()) {
+        return 1.0f;
+    }
+    auto total_extent = 0.0;
+    for(const auto& b : bounds) {
+        total_extent += (std::max)(b.maxs.x - b.mins.x, b.maxs.y - b.mins.y);
+    }
+    const auto cell_size = static_cast<float>(2.0 * total_extent / static_cast<double>(bounds.size()));
+    return cell_size > 0.0f ? cell_size : 1.0f;
+}
+
+void SpatialHashBroadphase::Build(const std::vector<AABB2>& bounds) noexcept {
+    _bounds = &bounds;
+    _cell_size = _requested_cell_size > 0.0f ? _requested_cell_size : CalcCellSize(bounds);
+    _entries.clear();
+    _large_items.clear();
+    for(std::size_t i = 0u; i < bounds.size(); ++i) {
+        const auto& b = bounds[i];
+        const auto first_x = CalcCellCoord(b.mins.x);
+        const auto last_x = CalcCellCoord(b.maxs.x);
+        const auto first_y = CalcCellCoord(b.mins.y);
+        const auto last_y = CalcCellCoord(b.maxs.y);
+        const auto cells = (static_cast<uint64_t>(last_x - first_x) + 1u) * (static_cast<uint64_t>(last_y - first_y) + 1u);
+        if(cells > max_cells_per_body) {
+            _large_items.push_back(static_cast<uint32_t>(i));
+            continue;
+        }
+        for(auto y = first_y; y <= last_y; ++y) {
+            for(auto x = first_x; x <= last_x; ++x) {
+                _entries.emplace_back(MakeCellKey(x, y), static_cast<uint32_t>(i));
+            }
+        }
+    }
+    std::sort(std::begin(_entries), std::end(_entries));
+    _cell_count = 0u;
+    for(std::size_t i = 0u; i < _entries.size(); ++i) {
+        if(!i || _entries[i].first != _entries[i - 1u].first) {
+            ++_cell_count;
+        }
+    }
+}
+
+void SpatialHashBroadphase::FindPairs(std::vector<BroadphasePair>& pairs) const noexcept {
+    pairs.clear();
+    if(!_bounds) {
+        return;
+    }
+    const auto& bounds = *_bounds;
+    for(std::size_t run_first = 0u; run_first < _entries.size();) {
+        const auto key = _entries[run_first].first;
+        auto run_last = run_first + 1u;
+        while(run_last < _entries.size() && _entries[run_last].first == key) {
+            ++run_last;
+        }
+        for(auto i = run_first; i < run_last; ++i) {
+            const auto a = _entries[i].second;
+            for(auto j = i + 1u; j < run_last; ++j) {
+                const auto b = _entries[j].second;
+                if(!DoBoundsOverlap(bounds[a], bounds[b])) {
+                    continue;
+                }
+                const auto overlap_x = (std::max)(bounds[a].mins.x, bounds[b].mins.x);
+                const auto overlap_y = (std::max)(bounds[a].mins.y, bounds[b].mins.y);
+                if(MakeCellKey(CalcCellCoord(overlap_x), CalcCellCoord(overlap_y)) == key) {
+                    pairs.push_back(MakePair(a, b));
+                }
+            }
+        }
+        run_first = run_last;
+    }
+    for(std::size_t i = 0u; i < _large_items.size(); ++i) {
+        const auto large = _large_items[i];
+        for(uint32_t other = 0u; other < static_cast<uint32_t>(bounds.size()); ++other) {
+            //Pairs of two large bodies are only tested from the earlier one.
+            const auto other_is_large = std::binary_search(std::begin(_large_items), std::end(_large_items), other);
+            if(other == large || (other_is_large && other < large)) {
+                continue;
+            }
+            if(DoBoundsOverlap(bounds[large], bounds[other])) {
+                pairs.push_back(MakePair(large, other));
+            }
+        }
+    }
+}
+
+void SpatialHashBroadphase::Query(const AABB2& area, std::vector<uint32_t>& items) const noexcept {
+    items.clear();
+    if(!_bounds) {
+        return;
+    }
+    const auto& bounds = *_bounds;
+    const auto first_x = CalcCellCoord(area.mins.x);
+    const auto last_x = CalcCellCoord(area.maxs.x);
+    const auto first_y = CalcCellCoord(area.mins.y);
+    const auto last_y = CalcCellCoord(area.maxs.y);
+    const auto cells = (static_cast<uint64_t>(last_x - first_x) + 1u) * (static_cast<uint64_t>(last_y - first_y) + 1u);
+    //Looking up more cells than there are entries costs more than testing every body.
+    if(cells > _entries.size()) {
+        for(uint32_t i = 0u; i < static_cast<uint32_t>(bounds.size()); ++i) {
+            if(DoBoundsOverlap(bounds[i], area)) {
+                items.push_back(i);
+            }
+        }
+        return;
+    }
+    for(auto y = first_y; y <= last_y; ++y) {
+        for(auto x = first_x; x <= last_x; ++x) {
+            const auto key = MakeCellKey(x, y);
+            auto entry = std::lower_bound(std::begin(_entries), std::end(_entries), std::make_pair(key, uint32_t{0u}));
+            for(; entry != std::end(_entries) && entry->first == key; ++entry) {
+                const auto& b = bounds[entry->second];
+                if(!DoBoundsOverlap(b, area)) {
+                    continue;
+                }
+                //Same rule as FindPairs: only the cell holding the overlap's lower corner reports it.
+                const auto overlap_x = (std::max)(b.mins.x, area.mins.x);
+                const auto overlap_y = (std::max)(b.mins.y, area.mins.y);
+                if(MakeCellKey(CalcCellCoord(overlap_x), CalcCellCoord(overlap_y)) == key) {
+                    items.push_back(entry->second);
+                }
+            }
+        }
+    }
+    for(const auto large : _large_items) {
+        if(DoBoundsOverlap(bounds[large], area)) {
+            items.push_back(large);
+        }
+    }
+}
+
+std::size_t SpatialHashBroadphase::GetCellCount() const noexcept {
+    return _cell_count;
+}
+
+float SpatialHashBroadphase::GetCellSize() const noexcept {
+    return _cell_size;
+}
+
+void SpatialHashBroadphase::AddDebugShapes(DebugShapeBatch& batch) const noexcept {
+    for(std::size_t i = 0u; i < _entries.size(); ++i) {
+        if(i && _entries[i].first == _entries[i - 1u].first) {
+            continue;
+        }
+        const auto x = static_cast<int32_t>(static_cast<uint32_t>(_entries[i].first >> 32));
+        const auto y = static_cast<int32_t>(static_cast<uint32_t>(_entries[i].first));
+        const auto mins = Vector2{static_cast<float>(x) * _cell_size, static_cast<float>(y) * _cell_size};
+        batch.AddCell(AABB2{mins, mins + Vector2{_cell_size, _cell_size}}, Rgba::Cyan);
+    }
+}
+
+int32_t SpatialHashBroadphase::CalcCellCoord(float value) const noexcept {
+    return static_cast<int32_t>(std::clamp(std::floor(value / _cell_size), -max_cell_coord, max_cell_coord));
+}
+
+uint64_t SpatialHashBroadphase::MakeCellKey(int32_t x, int32_t y) noexcept {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint64_t>(static_cast<uint32_t>(y));
+}
+
+QuadtreeBroadphase::QuadtreeBroadphase(const AABB2& world_bounds, std::size_t max_node_items, std::size_t max_depth) noexcept
+    : _world_bounds{world_bounds}
+    , _max_node_items{(std::max)(max_node_items, std::size_t{1u})}
+    , _max_depth{max_depth}
+{
+    /* DO NOTHING */
+}
+
+void QuadtreeBroadphase::Build(const std::vector<AABB2>& bounds) noexcept {
+    _bounds = &bounds;
+    _nodes.clear();
+    _nodes.push_back(Node{_world_bounds});
+    for(std::size_t i = 0u; i < bounds.size(); ++i) {
+        Insert(static_cast<uint32_t>(i));
+    }
+}
+
+void QuadtreeBroadphase::FindPairs(std::vector<BroadphasePair>& pairs) const noexcept {
+    pairs.clear();
+    if(!_bounds || _nodes.empty()) {
+        return;
+    }
+    auto ancestors = std::vector<uint32_t>{};
+    FindPairs(0u, ancestors, pairs);
+}
+
+void QuadtreeBroadphase::Query(const AABB2& area, std::vector<uint32_t>& items) const noexcept {
+    items.clear();
+    if(!_bounds || _nodes.empty()) {
+        return;
+    }
+    const auto& bounds = *_bounds;
+    auto pending = std::vector<uint32_t>{0u};
+    while(!pending.empty()) {
+        const auto& node = _nodes[pending.back()];
+        pending.pop_back();
+        for(const auto item : node.items) {
+            if(DoBoundsOverlap(bounds[item], area)) {
+                items.push_back(item);
+            }
+        }
+        if(!node.first_child) {
+            continue;
+        }
+        for(auto child = node.first_child; child < node.first_child + 4u; ++child) {
+            if(DoBoundsOverlap(_nodes[child].bounds, area)) {
+                pending.push_back(child);
+            }
+        }
+    }
+}
+
+std::size_t QuadtreeBroadphase::GetCellCount() const noexcept {
+    return _nodes.size();
+}
+
+void QuadtreeBroadphase::AddDebugShapes(DebugShapeBatch& batch) const noexcept {
+    for(const auto& node : _nodes) {
+        batch.AddCell(node.bounds, node.items.empty() ? Rgba::Grey : Rgba::Yellow);
+    }
+}
+
+void QuadtreeBroadphase::Insert(uint32_t item) noexcept {
+    const auto& bounds = (*_bounds)[item];
+    auto node_index = 0u;
+    while(_nodes[node_index].first_child) {
+        const auto child = FindChildContaining(_nodes[node_index], bounds);
+        if(!child) {
+            break;
+        }
+        node_index = child;
+    }
+    _nodes[node_index].items.push_back(item);
+    if(!_nodes[node_index].first_child && _nodes[node_index].items.size() > _max_node_items && _nodes[node_index].depth < _max_depth) {
+        Split(node_index);
+    }
+}
+
+void QuadtreeBroadphase::Split(uint32_t node_index) noexcept {
+    const auto node_bounds = _nodes[node_index].bounds;
+    const auto depth = _nodes[node_index].depth + 1u;
+    const auto center = node_bounds.CalcCenter();
+    const auto first_child = static_cast<uint32_t>(_nodes.size());
+    _nodes.push_back(Node{AABB2{node_bounds.mins, center}, {}, 0u, depth});
+    _nodes.push_back(Node{AABB2{Vector2{center.x, node_bounds.mins.y}, Vector2{node_bounds.maxs.x, center.y}}, {}, 0u, depth});
+    _nodes.push_back(Node{AABB2{Vector2{node_bounds.mins.x, center.y}, Vector2{center.x, node_bounds.maxs.y}}, {}, 0u, depth});
+    _nodes.push_back(Node{AABB2{center, node_bounds.maxs}, {}, 0u, depth});
+    _nodes[node_index].first_child = first_child;
+    auto items = std::move(_nodes[node_index].items);
+    _nodes[node_index].items.clear();
+    for(const auto item : items) {
+        const auto child = FindChildContaining(_nodes[node_index], (*_bounds)[item]);
+        _nodes[child ? child : node_index].items.push_back(item);
+    }
+    for(auto child = first_child; child < first_child + 4u; ++child) {
+        if(_nodes[child].items.size() > _max_node_items && depth < _max_depth) {
+            Split(child);
+        }
+    }
+}
+
+uint32_t QuadtreeBroadphase::FindChildContaining(const Node& node, const AABB2& bounds) const noexcept {
+    for(auto child = node.first_child; child < node.first_child + 4u; ++child) {
+        if(DoesBoundsContain(_nodes[child].bounds, bounds)) {
+            return child;
+        }
+    }
+    return 0u;
+}
+
+void QuadtreeBroadphase::FindPairs(uint32_t node_index, std::vector<uint32_t>& ancestors, std::vector<BroadphasePair>& pairs) const noexcept {
+    const auto& bounds = *_bounds;
+    const auto& node = _nodes[node_index];
+    for(std::size_t i = 0u; i < node.items.size(); ++i) {
+        const auto a = node.items[i];
+        for(auto j = i + 1u; j < node.items.size(); ++j) {
+            if(DoBoundsOverlap(bounds[a], bounds[node.items[j]])) {
+                pairs.push_back(MakePair(a, node.items[j]));
+            }
+        }
+        for(const auto ancestor : ancestors) {
+            if(DoBoundsOverlap(bounds[a], bounds[ancestor])) {
+                pairs.push_back(MakePair(a, ancestor));
+            }
+        }
+    }
+    if(!node.first_child) {
+        return;
+    }
+    const auto ancestor_count = ancestors.size();
+    ancestors.insert(std::end(ancestors), std::begin(node.items), std::end(node.items));
+    for(auto child = node.first_child; child < node.first_child + 4u; ++child) {
+        FindPairs(child, ancestors, pairs);
+    }
+    ancestors.resize(ancestor_count);
+}
+
+std::unique_ptr<IBroadphase> CreateBroadphase(const BroadphaseDesc& desc, const AABB2& world_bounds) noexcept {
+    switch(desc.type) {
+    case BroadphaseType::Quadtree: return std::make_unique<QuadtreeBroadphase>(world_bounds, desc.max_node_items, desc.max_depth);
+    case BroadphaseType::SpatialHash: return std::make_unique<SpatialHashBroadphase>(desc.cell_size);
+    default: ERROR_AND_DIE("BroadphaseType values have changed. Refactor CreateBroadphase.");
+    }
+}
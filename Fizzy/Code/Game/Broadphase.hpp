@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class DebugShapeBatch;
+
+enum class BroadphaseType : uint8_t {
+    Quadtree
+    , SpatialHash
+    , Max
+};
+
+struct BroadphaseDesc {
+    BroadphaseType type{BroadphaseType::Quadtree};
+    //Spatial hash cell size in world units. 0 picks one from the bodies' sizes.
+    float cell_size = 0.0f;
+    //Quadtree limits: a node splits once it holds more than max_node_items, up to max_depth.
+    std::size_t max_node_items = 8u;
+    std::size_t max_depth = 8u;
+};
+
+struct BroadphasePair {
+    uint32_t a{};
+    uint32_t b{};
+};
+
+[[nodiscard]] const char* GetBroadphaseName(BroadphaseType type) noexcept;
+
+//Finds every pair of overlapping bounds. Both implementations test the
+//candidate pairs against the bounds, so for the same input they report the
+//same pairs, possibly in a different order.
+class IBroadphase {
+public:
+    virtual ~IBroadphase() = default;
+
+    virtual void Build(const std::vector<AABB2>& bounds) noexcept = 0;
+    //Replaces the contents of pairs. Each pair is reported once with a < b.
+    virtual void FindPairs(std::vector<BroadphasePair>& pairs) const noexcept = 0;
+    //Replaces the contents of items with every item whose bounds overlap area, each once.
+    //Safe to call from several threads at once.
+    virtual void Query(const AABB2& area, std::vector<uint32_t>& items) const noexcept = 0;
+    //Occupied cells or quadtree nodes.
+    [[nodiscard]] virtual std::size_t GetCellCount() const noexcept = 0;
+    virtual void AddDebugShapes(DebugShapeBatch& batch) const noexcept = 0;
+
+protected:
+private:
+};
+
+//Uniform grid stored sparsely: each body is listed under every cell its
+//bounds touch, the list is sorted by cell, and bodies sharing a cell are
+//tested against each other. A pair is only reported by the cell holding the
+//lower corner of its overlap, so pairs sharing several cells are not repeated.
+class SpatialHashBroadphase : public IBroadphase {
+public:
+    //A cell_size of 0 uses CalcCellSize on every Build.
+    explicit SpatialHashBroadphase(float cell_size) noexcept;
+    SpatialHashBroadphase(const SpatialHashBroadphase& other) = default;
+    SpatialHashBroadphase(SpatialHashBroadphase&& other) = default;
+    SpatialHashBroadphase& operator=(const SpatialHashBroadphase& other) = default;
+    SpatialHashBroadphase& operator=(SpatialHashBroadphase&& other) = default;
+    virtual ~SpatialHashBroadphase() = default;
+
+    //Twice the average body extent, so a typical body touches at most four cells.
+    [[nodiscard]] static float CalcCellSize(const std::vector<AABB2>& bounds) noexcept;
+
+    void Build(const std::vector<AABB2>& bounds) noexcept override;
+    void FindPairs(std::vector<BroadphasePair>& pairs) const noexcept override;
+    void Query(const AABB2& area, std::vector<uint32_t>& items) const noexcept override;
+    [[nodiscard]] std::size_t GetCellCount() const noexcept override;
+    [[nodiscard]] float GetCellSize() const noexcept;
+    void AddDebugShapes(DebugShapeBatch& batch) const noexcept override;
+
+protected:
+private:
+    [[nodiscard]] int32_t CalcCellCoord(float value) const noexcept;
+    [[nodiscard]] static uint64_t MakeCellKey(int32_t x, int32_t y) noexcept;
+
+    const std::vector<AABB2>* _bounds{};
+    //(cell key, body index), sorted by key.
+    std::vector<std::pair<uint64_t, uint32_t>> _entries{};
+    //Bodies spanning too many cells to list, in index order.
+    std::vector<uint32_t> _large_items{};
+    std::size_t _cell_count{};
+    float _requested_cell_size{};
+    float _cell_size = 1.0f;
+};
+
+//Reference quadtree over the world bounds. Bodies live in the deepest node
+//that fully contains them and are tested against the rest of their node and
+//every node below it.
+class QuadtreeBroadphase : public IBroadphase {
+public:
+    QuadtreeBroadphase(const AABB2& world_bounds, std::size_t max_node_items, std::size_t max_depth) noexcept;
+    QuadtreeBroadphase(const QuadtreeBroadphase& other) = default;
+    QuadtreeBroadphase(QuadtreeBroadphase&& other) = default;
+    QuadtreeBroadphase& operator=(const QuadtreeBroadphase& other) = default;
+    QuadtreeBroadphase& operator=(QuadtreeBroadphase&& other) = default;
+    virtual ~QuadtreeBroadphase() = default;
+
+    void Build(const std::vector<AABB2>& bounds) noexcept override;
+    void FindPairs(std::vector<BroadphasePair>& pairs) const noexcept override;
+    void Query(const AABB2& area, std::vector<uint32_t>& items) const noexcept override;
+    [[nodiscard]] std::size_t GetCellCount() const noexcept override;
+    void AddDebugShapes(DebugShapeBatch& batch) const noexcept override;
+
+protected:
+private:
+    struct Node {
+        AABB2 bounds{};
+        std::vector<uint32_t> items{};
+        //Index of the first of four consecutive children, or 0 for a leaf.
+        uint32_t first_child{};
+        uint32_t depth{};
+    };
+
+    void Insert(uint32_t item) noexcept;
+    void Split(uint32_t node_index) noexcept;
+    [[nodiscard]] uint32_t FindChildContaining(const Node& node, const AABB2& bounds) const noexcept;
+    void FindPairs(uint32_t node_index, std::vector<uint32_t>& ancestors, std::vector<BroadphasePair>& pairs) const noexcept;
+
+    const std::vector<AABB2>* _bounds{};
+    std::vector<Node> _nodes{};
+    AABB2 _world_bounds{};
+    std::size_t _max_node_items{};
+    std::size_t _max_depth{};
+};
+
+[[nodiscard]] std::unique_ptr<IBroadphase> CreateBroadphase(const BroadphaseDesc& desc, const AABB2& world_bounds) noexcept;
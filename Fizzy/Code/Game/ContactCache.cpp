@@ -0,0 +1,492 @@
+#include "Game/ContactCache.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/UI/UISystem.hpp"
+
+#include "Game/JobSystem.hpp"
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+//Pairs per job system chunk.
+constexpr std::size_t pair_chunk_size = 256u;
+constexpr std::size_t shape_chunk_size = 1024u;
+//A face of the second polygon must beat the first's by this much to become the reference, so the choice does not flip back and forth.
+constexpr float reference_face_tolerance = 0.005f;
+
+float Dot(const Vector2& a, const Vector2& b) noexcept {
+    return a.x * b.x + a.y * b.y;
+}
+
+Vector2 Normalize(const Vector2& v) noexcept {
+    const auto length = std::sqrt(Dot(v, v));
+    return length > 0.0f ? v * (1.0f / length) : Vector2::X_AXIS;
+}
+
+uint64_t MakePairKey(uint32_t a, uint32_t b) noexcept {
+    return (static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b);
+}
+
+uint32_t MakeFeature(std::size_t reference_edge, std::size_t incident_edge, uint32_t tag, bool flip) noexcept {
+    return static_cast<uint32_t>(reference_edge & 0xFFu)
+         | (static_cast<uint32_t>(incident_edge & 0xFFu) << 8)
+         | (tag << 16)
+         | (static_cast<uint32_t>(flip) << 24);
+}
+
+bool IsCircle(const WorldShape& shape) noexcept {
+    return shape.point_count < 3u;
+}
+
+//How far b is outside face edge of a, counting both radii.
+float CalcFaceSeparation(const WorldShape& a, std::size_t edge, const WorldShape& b) noexcept {
+    const auto& normal = a.normals[edge];
+    auto deepest = (std::numeric_limits<float>::max)();
+    for(std::size_t k = 0u; k < b.point_count; ++k) {
+        deepest = (std::min)(deepest, Dot(normal, b.points[k] - a.points[edge]));
+    }
+    return deepest - a.radius - b.radius;
+}
+
+struct FaceSeparation {
+    float separation = std::numeric_limits<float>::lowest();
+    std::size_t edge{};
+};
+
+//The face of a that b is furthest outside of.
+FaceSeparation FindMaxSeparation(const WorldShape& a, const WorldShape& b) noexcept {
+    auto best = FaceSeparation{};
+    for(std::size_t i = 0u; i < a.point_count; ++i) {
+        if(const auto separation = CalcFaceSeparation(a, i, b); separation > best.separation) {
+            best = FaceSeparation{separation, i};
+        }
+    }
+    return best;
+}
+
+SeparatingAxis MakeAxis(SeparatingAxisOwner owner, std::size_t edge) noexcept {
+    return SeparatingAxis{owner, static_cast<uint8_t>(edge)};
+}
+
+struct ClipVertex {
+    Vector2 position{};
+    uint32_t tag{};
+};
+
+//Keeps the part of the segment with Dot(normal, p) <= offset. Returns the vertices left, 0 or 2.
+std::size_t ClipSegment(const ClipVertex (&in)[2], ClipVertex (&out)[2], const Vector2& normal, float offset, uint32_t clip_tag) noexcept {
+    std::size_t count = 0u;
+    const auto distance0 = Dot(normal, in[0].position) - offset;
+    const auto distance1 = Dot(normal, in[1].position) - offset;
+    if(distance0 <= 0.0f) {
+        out[count++] = in[0];
+    }
+    if(distance1 <= 0.0f) {
+        out[count++] = in[1];
+    }
+    if(distance0 * distance1 < 0.0f) {
+        const auto t = distance0 / (distance0 - distance1);
+        out[count++] = ClipVertex{in[0].position + (in[1].position - in[0].position) * t, clip_tag};
+    }
+    return count;
+}
+
+bool CollidePolygons(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& manifold, SeparatingAxis& axis) noexcept {
+    const auto separation_a = FindMaxSeparation(a, b);
+    if(separation_a.separation > margin) {
+        axis = MakeAxis(SeparatingAxisOwner::A, separation_a.edge);
+        return false;
+    }
+    const auto separation_b = FindMaxSeparation(b, a);
+    if(separation_b.separation > margin) {
+        axis = MakeAxis(SeparatingAxisOwner::B, separation_b.edge);
+        return false;
+    }
+    const auto flip = separation_b.separation > separation_a.separation + reference_face_tolerance;
+    const auto& reference = flip ? b : a;
+    const auto& incident = flip ? a : b;
+    const auto reference_edge = flip ? separation_b.edge : separation_a.edge;
+    const auto& normal = reference.normals[reference_edge];
+    axis = MakeAxis(flip ? SeparatingAxisOwner::B : SeparatingAxisOwner::A, reference_edge);
+
+    //The incident face is the one facing the reference face the most.
+    auto incident_edge = std::size_t{0u};
+    auto min_dot = (std::numeric_limits<float>::max)();
+    for(std::size_t i = 0u; i < incident.point_count; ++i) {
+        if(const auto d = Dot(normal, incident.normals[i]); d < min_dot) {
+            min_dot = d;
+            incident_edge = i;
+        }
+    }
+    const ClipVertex incident_face[2] = {
+        ClipVertex{incident.points[incident_edge], 0u}
+        , ClipVertex{incident.points[(incident_edge + 1u) % incident.point_count], 1u}
+    };
+
+    //Clip the incident face to the sides of the reference face.
+    const auto& v1 = reference.points[reference_edge];
+    const auto& v2 = reference.points[(reference_edge + 1u) % reference.point_count];
+    const auto tangent = Vector2{-normal.y, normal.x};
+    ClipVertex clipped1[2]{};
+    ClipVertex clipped2[2]{};
+    if(ClipSegment(incident_face, clipped1, tangent * -1.0f, -Dot(tangent, v1), 2u) < 2u) {
+        return false;
+    }
+    if(ClipSegment(clipped1, clipped2, tangent, Dot(tangent, v2), 3u) < 2u) {
+        return false;
+    }
+
+    manifold.normal = flip ? normal * -1.0f : normal;
+    manifold.point_count = 0u;
+    for(const auto& vertex : clipped2) {
+        const auto separation = Dot(normal, vertex.position - v1);
+        if(separation > margin) {
+            continue;
+        }
+        auto& point = manifold.points[manifold.point_count++];
+        point.position = vertex.position;
+        point.separation = separation;
+        point.feature = MakeFeature(reference_edge, incident_edge, vertex.tag, flip);
+    }
+    return manifold.point_count > 0u;
+}
+
+//Normal points from the polygon towards the circle.
+bool CollidePolygonCircle(const WorldShape& polygon, const WorldShape& circle, float margin, ContactManifold& manifold, std::size_t& face_edge) noexcept {
+    const auto& center = circle.points[0];
+    const auto radius = circle.radius;
+    auto face = FaceSeparation{};
+    for(std::size_t i = 0u; i < polygon.point_count; ++i) {
+        if(const auto s = Dot(polygon.normals[i], center - polygon.points[i]); s > face.separation) {
+            face = FaceSeparation{s, i};
+        }
+    }
+    face_edge = face.edge;
+    if(face.separation > radius + margin) {
+        return false;
+    }
+    auto& point = manifold.points[0];
+    point.feature = static_cast<uint32_t>(face.edge);
+    if(face.separation <= 0.0f) {
+        //Center inside: push out through the nearest face.
+        manifold.normal = polygon.normals[face.edge];
+        point.separation = face.separation - radius;
+        point.position = center - manifold.normal * radius;
+        manifold.point_count = 1u;
+        return true;
+    }
+    auto closest = polygon.points[0];
+    auto closest_distance_sq = (std::numeric_limits<float>::max)();
+    for(std::size_t i = 0u; i < polygon.point_count; ++i) {
+        const auto& start = polygon.points[i];
+        const auto edge = polygon.points[(i + 1u) % polygon.point_count] - start;
+        const auto t = std::clamp(Dot(center - start, edge) / (std::max)(Dot(edge, edge), std::numeric_limits<float>::min()), 0.0f, 1.0f);
+        const auto on_edge = start + edge * t;
+        const auto offset = center - on_edge;
+        if(const auto distance_sq = Dot(offset, offset); distance_sq < closest_distance_sq) {
+            closest_distance_sq = distance_sq;
+            closest = on_edge;
+        }
+    }
+    const auto distance = std::sqrt(closest_distance_sq);
+    if(distance - radius > margin) {
+        return false;
+    }
+    manifold.normal = distance > 0.0f ? (center - closest) * (1.0f / distance) : polygon.normals[face.edge];
+    point.separation = distance - radius;
+    point.position = closest;
+    manifold.point_count = 1u;
+    return true;
+}
+
+} // namespace
+
+WorldShape WorldShape::FromShape(const ConvexShape& shape, const Vector2& position) noexcept {
+    auto world = WorldShape{};
+    world.point_count = shape.point_count;
+    world.radius = shape.radius;
+    for(std::size_t i = 0u; i < shape.point_count; ++i) {
+        world.points[i] = shape.points[i] + position;
+    }
+    if(IsCircle(world)) {
+        return world;
+    }
+    //ConvexShape corners wind counterclockwise, so the outward normal is the edge turned clockwise.
+    for(std::size_t i = 0u; i < shape.point_count; ++i) {
+        const auto e = shape.points[(i + 1u) % shape.point_count] - shape.points[i];
+        world.normals[i] = Normalize(Vector2{e.y, -e.x});
+    }
+    return world;
+}
+
+bool CalcContactManifold(const ConvexShape& a, const Vector2& position_a, const ConvexShape& b, const Vector2& position_b, float margin, ContactManifold& manifold) noexcept {
+    auto axis = SeparatingAxis{};
+    return CalcContactManifold(WorldShape::FromShape(a, position_a), WorldShape::FromShape(b, position_b), margin, manifold, axis);
+}
+
+bool CalcContactManifold(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& manifold, SeparatingAxis& axis) noexcept {
+    manifold.point_count = 0u;
+    const auto a_is_circle = IsCircle(a);
+    const auto b_is_circle = IsCircle(b);
+    if(a_is_circle && b_is_circle) {
+        axis = SeparatingAxis{};
+        const auto offset = b.points[0] - a.points[0];
+        const auto distance = std::sqrt(Dot(offset, offset));
+        const auto separation = distance - a.radius - b.radius;
+        if(separation > margin) {
+            return false;
+        }
+        manifold.normal = Normalize(offset);
+        manifold.points[0] = ContactPoint{a.points[0] + manifold.normal * a.radius, separation};
+        manifold.point_count = 1u;
+        return true;
+    }
+    if(b_is_circle) {
+        auto face_edge = std::size_t{0u};
+        const auto touching = CollidePolygonCircle(a, b, margin, manifold, face_edge);
+        axis = MakeAxis(SeparatingAxisOwner::A, face_edge);
+        return touching;
+    }
+    if(a_is_circle) {
+        auto face_edge = std::size_t{0u};
+        const auto touching = CollidePolygonCircle(b, a, margin, manifold, face_edge);
+        axis = MakeAxis(SeparatingAxisOwner::B, face_edge);
+        if(!touching) {
+            return false;
+        }
+        manifold.normal = manifold.normal * -1.0f;
+        return true;
+    }
+    return CollidePolygons(a, b, margin, manifold, axis);
+}
+
+bool IsSeparatedByAxis(const WorldShape& a, const WorldShape& b, const SeparatingAxis& axis, float margin) noexcept {
+    switch(axis.owner) {
+    case SeparatingAxisOwner::None: return false;
+    case SeparatingAxisOwner::A: return !IsCircle(a) && axis.edge < a.point_count && CalcFaceSeparation(a, axis.edge, b) > margin;
+    case SeparatingAxisOwner::B: return !IsCircle(b) && axis.edge < b.point_count && CalcFaceSeparation(b, axis.edge, a) > margin;
+    default: ERROR_AND_DIE("SeparatingAxisOwner values have changed. Refactor IsSeparatedByAxis.");
+    }
+}
+
+void ContactCache::SetDescription(const ContactCacheDesc& desc) noexcept {
+    _desc = desc;
+}
+
+const ContactCacheDesc& ContactCache::GetDescription() const noexcept {
+    return _desc;
+}
+
+void ContactCache::Update(Scene& scene) noexcept {
+    const auto start = std::chrono::steady_clock::now();
+    const auto body_count = scene.GetBodyCount();
+    _pairs = scene.UpdateBroadphase().GetPairs();
+    //Two static bodies never need contacts.
+    _pairs.erase(std::remove_if(std::begin(_pairs), std::end(_pairs), [&scene](const BroadphasePair& pair) {
+        return scene.GetBody(pair.a).GetInverseMass() <= 0.0f && scene.GetBody(pair.b).GetInverseMass() <= 0.0f;
+    }), std::end(_pairs));
+    std::sort(std::begin(_pairs), std::end(_pairs), [](const BroadphasePair& lhs, const BroadphasePair& rhs) {
+        return MakePairKey(lhs.a, lhs.b) < MakePairKey(rhs.a, rhs.b);
+    });
+
+    //Merge this step's pairs with last step's; both are sorted by pair.
+    const auto pair_count = _pairs.size();
+    _next_manifolds.resize(pair_count);
+    _next_motions.resize(pair_count);
+    _updates.assign(pair_count, PairUpdate::Added);
+    auto cached = std::size_t{0u};
+    auto kept_count = std::size_t{0u};
+    for(std::size_t i = 0u; i < pair_count; ++i) {
+        const auto key = MakePairKey(_pairs[i].a, _pairs[i].b);
+        while(cached < _manifolds.size() && MakePairKey(_manifolds[cached].body_a, _manifolds[cached].body_b) < key) {
+            ++cached;
+        }
+        const auto found = _desc.persistent && cached < _manifolds.size() && MakePairKey(_manifolds[cached].body_a, _manifolds[cached].body_b) == key
+                           && _manifolds[cached].body_b < body_count;
+        if(found) {
+            _next_manifolds[i] = _manifolds[cached];
+            _next_motions[i] = _motions[cached];
+            _updates[i] = PairUpdate::Recomputed;
+            ++kept_count;
+        } else {
+            _next_manifolds[i] = ContactManifold{_pairs[i].a, _pairs[i].b};
+        }
+    }
+    g_theJobSystem.ParallelFor(pair_count, pair_chunk_size, [this, &scene](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            _updates[i] = UpdatePair(scene, _next_manifolds[i], _next_motions[i], _updates[i] != PairUpdate::Added);
+        }
+    });
+    //Build the world shapes of only the bodies the narrowphase will look at.
+    _stats.shape_count = 0u;
+    if(_desc.world_shapes) {
+        _needs_shape.assign(body_count, 0u);
+        for(std::size_t i = 0u; i < pair_count; ++i) {
+            if(NeedsNarrowphase(_updates[i])) {
+                _needs_shape[_next_manifolds[i].body_a] = 1u;
+                _needs_shape[_next_manifolds[i].body_b] = 1u;
+            }
+        }
+        if(_shapes.size() < body_count) {
+            _shapes.resize(body_count);
+        }
+        g_theJobSystem.ParallelFor(body_count, shape_chunk_size, [this, &scene](std::size_t first, std::size_t last) {
+            for(auto i = first; i < last; ++i) {
+                if(_needs_shape[i]) {
+                    const auto& body = scene.GetBody(i);
+                    _shapes[i] = WorldShape::FromShape(ConvexShape::FromRecord(scene.GetBodyRecord(i), body.GetOrientationDegrees()), body.GetPosition());
+                }
+            }
+        });
+        _stats.shape_count = static_cast<std::size_t>(std::count(std::begin(_needs_shape), std::end(_needs_shape), uint8_t{1u}));
+    }
+    g_theJobSystem.ParallelFor(pair_count, pair_chunk_size, [this, &scene](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            if(NeedsNarrowphase(_updates[i])) {
+                _updates[i] = CollidePair(scene, _next_manifolds[i], _next_motions[i], _updates[i]);
+            }
+        }
+    });
+    _stats.removed_pair_count = _desc.persistent ? _manifolds.size() - kept_count : 0u;
+    _manifolds.swap(_next_manifolds);
+    _motions.swap(_next_motions);
+
+    _stats.pair_count = pair_count;
+    _stats.touching_pair_count = 0u;
+    _stats.point_count = 0u;
+    _stats.added_pair_count = 0u;
+    _stats.asleep_pair_count = 0u;
+    _stats.refreshed_pair_count = 0u;
+    _stats.separated_pair_count = 0u;
+    _stats.recomputed_pair_count = 0u;
+    for(std::size_t i = 0u; i < pair_count; ++i) {
+        _stats.touching_pair_count += _manifolds[i].point_count ? 1u : 0u;
+        _stats.point_count += _manifolds[i].point_count;
+        switch(_updates[i]) {
+        case PairUpdate::Added: ++_stats.added_pair_count; break;
+        case PairUpdate::Asleep: ++_stats.asleep_pair_count; break;
+        case PairUpdate::Refreshed: ++_stats.refreshed_pair_count; break;
+        case PairUpdate::Separated: ++_stats.separated_pair_count; break;
+        case PairUpdate::Recomputed: ++_stats.recomputed_pair_count; break;
+        default: ERROR_AND_DIE("PairUpdate values have changed. Refactor ContactCache::Update.");
+        }
+    }
+    _stats.update_ms = std::chrono::duration<float, std::milli>{std::chrono::steady_clock::now() - start}.count();
+}
+
+void ContactCache::Reset() noexcept {
+    _manifolds.clear();
+    _motions.clear();
+    _stats = ContactCacheStats{};
+}
+
+const std::vector<ContactManifold>& ContactCache::GetManifolds() const noexcept {
+    return _manifolds;
+}
+
+std::vector<ContactManifold>& ContactCache::GetManifolds() noexcept {
+    return _manifolds;
+}
+
+const ContactCacheStats& ContactCache::GetStats() const noexcept {
+    return _stats;
+}
+
+void ContactCache::ShowDebugUI() noexcept {
+    ImGui::Checkbox("Persistent contacts", &_desc.persistent);
+    ImGui::SliderFloat("Refresh distance", &_desc.refresh_distance, 0.0f, 5.0f);
+    ImGui::SliderFloat("Refresh degrees", &_desc.refresh_degrees, 0.0f, 10.0f);
+    ImGui::SliderFloat("Contact margin", &_desc.margin, 0.0f, 5.0f);
+    ImGui::Checkbox("World shapes per step", &_desc.world_shapes);
+    ImGui::Checkbox("Cache separating axes", &_desc.cache_axes);
+    ImGui::Text("Pairs: %zu, touching: %zu, points: %zu", _stats.pair_count, _stats.touching_pair_count, _stats.point_count);
+    ImGui::Text("Added: %zu removed: %zu", _stats.added_pair_count, _stats.removed_pair_count);
+    ImGui::Text("Asleep: %zu refreshed: %zu separated: %zu recomputed: %zu", _stats.asleep_pair_count, _stats.refreshed_pair_count, _stats.separated_pair_count, _stats.recomputed_pair_count);
+    ImGui::Text("World shapes built: %zu", _stats.shape_count);
+    ImGui::Text("Contact update: %.3f ms", _stats.update_ms);
+}
+
+ContactCache::PairUpdate ContactCache::UpdatePair(const Scene& scene, ContactManifold& manifold, PairMotion& motion, bool is_cached) const noexcept {
+    const auto& body_a = scene.GetBody(manifold.body_a);
+    const auto& body_b = scene.GetBody(manifold.body_b);
+    const auto& position_a = body_a.GetPosition();
+    const auto& position_b = body_b.GetPosition();
+    const auto degrees_a = body_a.GetOrientationDegrees();
+    const auto degrees_b = body_b.GetOrientationDegrees();
+    if(is_cached) {
+        if(!body_a.IsAwake() && !body_b.IsAwake()) {
+            return PairUpdate::Asleep;
+        }
+        const auto moved_a = position_a - motion.computed_position_a;
+        const auto moved_b = position_b - motion.computed_position_b;
+        const auto refresh_distance_sq = _desc.refresh_distance * _desc.refresh_distance;
+        if(Dot(moved_a, moved_a) <= refresh_distance_sq && Dot(moved_b, moved_b) <= refresh_distance_sq
+           && std::abs(degrees_a - motion.computed_degrees_a) <= _desc.refresh_degrees
+           && std::abs(degrees_b - motion.computed_degrees_b) <= _desc.refresh_degrees) {
+            //Slide the points with the bodies and open or close the gaps by their relative motion.
+            const auto step_a = position_a - motion.position_a;
+            const auto step_b = position_b - motion.position_b;
+            const auto shift = Dot(step_b - step_a, manifold.normal);
+            for(std::size_t i = 0u; i < manifold.point_count; ++i) {
+                manifold.points[i].position += (step_a + step_b) * 0.5f;
+                manifold.points[i].separation += shift;
+            }
+            motion.position_a = position_a;
+            motion.position_b = position_b;
+            return PairUpdate::Refreshed;
+        }
+    }
+    return is_cached ? PairUpdate::Recomputed : PairUpdate::Added;
+}
+
+ContactCache::PairUpdate ContactCache::CollidePair(const Scene& scene, ContactManifold& manifold, PairMotion& motion, PairUpdate update) const noexcept {
+    const auto& body_a = scene.GetBody(manifold.body_a);
+    const auto& body_b = scene.GetBody(manifold.body_b);
+    const auto& position_a = body_a.GetPosition();
+    const auto& position_b = body_b.GetPosition();
+    const auto degrees_a = body_a.GetOrientationDegrees();
+    const auto degrees_b = body_b.GetOrientationDegrees();
+    auto scratch_a = WorldShape{};
+    auto scratch_b = WorldShape{};
+    if(!_desc.world_shapes) {
+        scratch_a = WorldShape::FromShape(ConvexShape::FromRecord(scene.GetBodyRecord(manifold.body_a), degrees_a), position_a);
+        scratch_b = WorldShape::FromShape(ConvexShape::FromRecord(scene.GetBodyRecord(manifold.body_b), degrees_b), position_b);
+    }
+    const auto& shape_a = _desc.world_shapes ? _shapes[manifold.body_a] : scratch_a;
+    const auto& shape_b = _desc.world_shapes ? _shapes[manifold.body_b] : scratch_b;
+    auto axis = update == PairUpdate::Recomputed ? motion.axis : SeparatingAxis{};
+    if(_desc.cache_axes && IsSeparatedByAxis(shape_a, shape_b, axis, _desc.margin)) {
+        manifold.point_count = 0u;
+        motion = PairMotion{position_a, position_b, position_a, position_b, degrees_a, degrees_b, axis};
+        return PairUpdate::Separated;
+    }
+    const auto previous = manifold;
+    if(!CalcContactManifold(shape_a, shape_b, _desc.margin, manifold, axis)) {
+        manifold.point_count = 0u;
+    }
+    //Carry the accumulated impulses of the points that are still there.
+    for(std::size_t i = 0u; i < manifold.point_count; ++i) {
+        auto& point = manifold.points[i];
+        point.normal_impulse = 0.0f;
+        point.tangent_impulse = 0.0f;
+        for(std::size_t k = 0u; k < previous.point_count; ++k) {
+            if(previous.points[k].feature == point.feature) {
+                point.normal_impulse = previous.points[k].normal_impulse;
+                point.tangent_impulse = previous.points[k].tangent_impulse;
+                break;
+            }
+        }
+    }
+    motion = PairMotion{position_a, position_b, position_a, position_b, degrees_a, degrees_b, axis};
+    return update;
+}
+
+bool ContactCache::NeedsNarrowphase(PairUpdate update) noexcept {
+    return update == PairUpdate::Added || update == PairUpdate::Recomputed;
+}
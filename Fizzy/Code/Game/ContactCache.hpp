@@ -0,0 +1,189 @@
+#pragma once
+
+#include "Engine/Math/Vector2.hpp"
+
+#include "Game/Broadphase.hpp"
+#include "Game/ContinuousCollision.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+struct ContactPoint {
+    Vector2 position{};
+    //Gap along the manifold normal; negative while the bodies overlap.
+    float separation{};
+    //Which edges and vertices produced the point, so it can be matched with
+    //the same point in a later step.
+    uint32_t feature{};
+    //Accumulated by ContactSolver and carried to the matching point of the
+    //next step to warm start it.
+    float normal_impulse{};
+    float tangent_impulse{};
+};
+
+struct ContactManifold {
+    static inline constexpr std::size_t max_points = 2u;
+
+    uint32_t body_a{};
+    uint32_t body_b{};
+    //Unit normal from a towards b.
+    Vector2 normal{};
+    std::array<ContactPoint, max_points> points{};
+    std::size_t point_count{};
+};
+
+//A ConvexShape placed at its body's position, with the outward normal of
+//each edge, so the narrowphase does not rebuild them for every pair.
+struct WorldShape {
+    std::array<Vector2, ConvexShape::max_points> points{};
+    std::array<Vector2, ConvexShape::max_points> normals{};
+    std::size_t point_count{};
+    float radius{};
+
+    [[nodiscard]] static WorldShape FromShape(const ConvexShape& shape, const Vector2& position) noexcept;
+};
+
+enum class SeparatingAxisOwner : uint8_t {
+    None
+    , A
+    , B
+};
+
+//The face that separated a pair the last time it was tested, or the
+//reference face if it touched. Testing it first lets a pair that is still
+//apart skip searching every other face.
+struct SeparatingAxis {
+    SeparatingAxisOwner owner{SeparatingAxisOwner::None};
+    uint8_t edge{};
+};
+
+//Contact points between two shapes closer than margin along their normal.
+//Polygons are clipped against the reference face of least penetration, so a
+//box resting on another gets both corners. Returns false if they are further
+//apart than margin.
+[[nodiscard]] bool CalcContactManifold(const ConvexShape& a, const Vector2& position_a, const ConvexShape& b, const Vector2& position_b, float margin, ContactManifold& manifold) noexcept;
+//As above, and sets axis to the face that separated or was the reference.
+[[nodiscard]] bool CalcContactManifold(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& manifold, SeparatingAxis& axis) noexcept;
+//True if the face named by axis puts more than margin between the shapes.
+//False for SeparatingAxisOwner::None or a face the shape does not have.
+[[nodiscard]] bool IsSeparatedByAxis(const WorldShape& a, const WorldShape& b, const SeparatingAxis& axis, float margin) noexcept;
+
+struct ContactCacheDesc {
+    //Keep manifolds between steps. Off recomputes every pair every step.
+    bool persistent = true;
+    //A cached manifold is shifted along its normal instead of recomputed
+    //while both bodies stay this close to where it was computed.
+    float refresh_distance = 0.5f;
+    float refresh_degrees = 1.0f;
+    //Points up to this far apart are kept, so resting contacts do not flicker.
+    float margin = 0.5f;
+    //Build each body's WorldShape once per step instead of once per pair.
+    bool world_shapes = true;
+    //Test a cached pair's last separating face before running the narrowphase.
+    bool cache_axes = true;
+};
+
+struct ContactCacheStats {
+    std::size_t pair_count{};
+    std::size_t touching_pair_count{};
+    std::size_t point_count{};
+    //Pairs that were not in the cache last step, and cached pairs no longer overlapping.
+    std::size_t added_pair_count{};
+    std::size_t removed_pair_count{};
+    //Cached pairs left alone because both bodies sleep, refreshed without
+    //running the narrowphase, still apart along their cached separating face,
+    //and recomputed.
+    std::size_t asleep_pair_count{};
+    std::size_t refreshed_pair_count{};
+    std::size_t separated_pair_count{};
+    std::size_t recomputed_pair_count{};
+    //Bodies whose WorldShape was built this step.
+    std::size_t shape_count{};
+    float update_ms{};
+};
+
+//Contact manifolds for every overlapping pair of a scene's bodies, kept
+//from step to step in a vector sorted by pair. Each Update takes this
+//step's pairs from the scene's shared broadphase and merges them with last
+//step's: new pairs get a manifold, pairs that stopped overlapping are
+//dropped, and a cached pair whose bodies have barely moved since its
+//manifold was computed only has its points shifted by their relative
+//motion. Pairs whose bodies are both asleep are left as they are.
+//Recomputed manifolds keep the accumulated impulses of the points whose
+//feature ids match, and refreshed ones keep all of theirs, so ContactSolver
+//can warm start from them. The pairs that do need the narrowphase share one
+//WorldShape per body, and a cached pair still apart along the face that last
+//separated it skips the full test. This runs beside the engine's collision,
+//which still finds and resolves contacts itself.
+class ContactCache {
+public:
+    ContactCache() = default;
+    ContactCache(const ContactCache& other) = default;
+    ContactCache(ContactCache&& other) = default;
+    ContactCache& operator=(const ContactCache& other) = default;
+    ContactCache& operator=(ContactCache&& other) = default;
+    ~ContactCache() = default;
+
+    void SetDescription(const ContactCacheDesc& desc) noexcept;
+    [[nodiscard]] const ContactCacheDesc& GetDescription() const noexcept;
+
+    //Call after every physics step.
+    void Update(Scene& scene) noexcept;
+    //Drops every cached pair, e.g. after bodies were teleported by a restart.
+    void Reset() noexcept;
+
+    //Sorted by (body_a, body_b) with body_a < body_b. Includes pairs whose
+    //bounds overlap but whose shapes do not touch; those have no points.
+    [[nodiscard]] const std::vector<ContactManifold>& GetManifolds() const noexcept;
+    //For ContactSolver to store the impulses it accumulates.
+    [[nodiscard]] std::vector<ContactManifold>& GetManifolds() noexcept;
+    [[nodiscard]] const ContactCacheStats& GetStats() const noexcept;
+
+    //Settings and counts for a state's debug window.
+    void ShowDebugUI() noexcept;
+
+protected:
+private:
+    //Where the bodies were when a manifold was last computed and last
+    //shifted, and the face that last separated them.
+    struct PairMotion {
+        Vector2 position_a{};
+        Vector2 position_b{};
+        Vector2 computed_position_a{};
+        Vector2 computed_position_b{};
+        float computed_degrees_a{};
+        float computed_degrees_b{};
+        SeparatingAxis axis{};
+    };
+
+    enum class PairUpdate : uint8_t {
+        Added
+        , Asleep
+        , Refreshed
+        , Separated
+        , Recomputed
+    };
+
+    //Leaves sleeping pairs and refreshes barely moved ones; returns Added or
+    //Recomputed for pairs that need CollidePair.
+    [[nodiscard]] PairUpdate UpdatePair(const Scene& scene, ContactManifold& manifold, PairMotion& motion, bool is_cached) const noexcept;
+    [[nodiscard]] PairUpdate CollidePair(const Scene& scene, ContactManifold& manifold, PairMotion& motion, PairUpdate update) const noexcept;
+    [[nodiscard]] static bool NeedsNarrowphase(PairUpdate update) noexcept;
+
+    ContactCacheDesc _desc{};
+    ContactCacheStats _stats{};
+    std::vector<BroadphasePair> _pairs{};
+    //Parallel arrays, one entry per pair.
+    std::vector<ContactManifold> _manifolds{};
+    std::vector<PairMotion> _motions{};
+    std::vector<ContactManifold> _next_manifolds{};
+    std::vector<PairMotion> _next_motions{};
+    std::vector<PairUpdate> _updates{};
+    //One per body, built only for bodies in pairs that need the narrowphase.
+    std::vector<WorldShape> _shapes{};
+    std::vector<uint8_t> _needs_shape{};
+};
@@ -0,0 +1,185 @@
+#include "Game/ContactSolver.hpp"
+
+#include "Engine/UI/UISystem.hpp"
+
+#include "Game/ContactCache.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+constexpr std::size_t body_chunk_size = 4096u;
+
+float Dot(const Vector2& a, const Vector2& b) noexcept {
+    return a.x * b.x + a.y * b.y;
+}
+
+Vector2 CalcTangent(const Vector2& normal) noexcept {
+    return Vector2{-normal.y, normal.x};
+}
+
+} // namespace
+
+void ContactSolver::BeginFrame() noexcept {
+    _stats.step_count = 0u;
+    _stats.frame_iterations = 0u;
+    _stats.frame_residual_change = 0.0f;
+    _stats.solve_ms = 0.0f;
+}
+
+void ContactSolver::Solve(Scene& scene, std::vector<ContactManifold>& manifolds, TimeUtils::FPSeconds timestep) noexcept {
+    if(timestep.count() <= 0.0f) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto body_count = scene.GetBodyCount();
+    _velocities.resize(body_count);
+    _start_velocities.resize(body_count);
+    _inverse_masses.resize(body_count);
+    g_theJobSystem.ParallelFor(body_count, body_chunk_size, [this, &scene](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            const auto& body = scene.GetBody(i);
+            _velocities[i] = body.GetVelocity();
+            _start_velocities[i] = _velocities[i];
+            //Sleeping bodies hold still, like static ones.
+            _inverse_masses[i] = body.IsAwake() ? body.GetInverseMass() : 0.0f;
+        }
+    });
+    _stats.manifold_count = 0u;
+    _stats.point_count = 0u;
+    _stats.warm_started_point_count = 0u;
+    for(auto& manifold : manifolds) {
+        if(!manifold.point_count) {
+            continue;
+        }
+        ++_stats.manifold_count;
+        _stats.point_count += manifold.point_count;
+        if(_desc.warm_start) {
+            WarmStartManifold(manifold);
+        } else {
+            for(std::size_t i = 0u; i < manifold.point_count; ++i) {
+                manifold.points[i].normal_impulse = 0.0f;
+                manifold.points[i].tangent_impulse = 0.0f;
+            }
+        }
+    }
+    const auto inverse_dt = 1.0f / timestep.count();
+    auto iterations = std::size_t{0u};
+    auto change = 0.0f;
+    while(iterations < _desc.max_iterations && _stats.point_count) {
+        change = 0.0f;
+        for(auto& manifold : manifolds) {
+            if(manifold.point_count) {
+                change = (std::max)(change, SolveManifold(manifold, inverse_dt));
+            }
+        }
+        if(!iterations) {
+            _stats.initial_change = change;
+        }
+        ++iterations;
+        if(change <= _desc.tolerance) {
+            break;
+        }
+    }
+    if(!iterations) {
+        _stats.initial_change = 0.0f;
+    }
+    _stats.iterations_used = iterations;
+    _stats.residual_change = change;
+    for(std::size_t i = 0u; i < body_count; ++i) {
+        if(_velocities[i].x == _start_velocities[i].x && _velocities[i].y == _start_velocities[i].y) {
+            continue;
+        }
+        scene.GetBody(i).SetVelocity(_velocities[i]);
+    }
+    ++_stats.step_count;
+    _stats.frame_iterations += iterations;
+    _stats.frame_residual_change = (std::max)(_stats.frame_residual_change, change);
+    _stats.solve_ms += std::chrono::duration<float, std::milli>{std::chrono::steady_clock::now() - start}.count();
+}
+
+void ContactSolver::SetDescription(const ContactSolverDesc& desc) noexcept {
+    _desc = desc;
+}
+
+const ContactSolverDesc& ContactSolver::GetDescription() const noexcept {
+    return _desc;
+}
+
+const ContactSolverStats& ContactSolver::GetStats() const noexcept {
+    return _stats;
+}
+
+void ContactSolver::ShowDebugUI() noexcept {
+    int iterations = static_cast<int>(_desc.max_iterations);
+    if(ImGui::SliderInt("Contact iterations", &iterations, 1, 64)) {
+        _desc.max_iterations = static_cast<std::size_t>(iterations);
+    }
+    ImGui::SliderFloat("Impulse tolerance", &_desc.tolerance, 0.0f, 1.0f, "%.3f");
+    ImGui::Checkbox("Warm start contacts", &_desc.warm_start);
+    ImGui::SliderFloat("Friction", &_desc.friction, 0.0f, 1.0f, "%.2f");
+    ImGui::SliderFloat("Bias factor", &_desc.bias_factor, 0.0f, 1.0f, "%.2f");
+    ImGui::SliderFloat("Slop (px)", &_desc.slop, 0.0f, 5.0f, "%.2f");
+    ImGui::Text("Manifolds: %zu, points: %zu, warm started: %zu", _stats.manifold_count, _stats.point_count, _stats.warm_started_point_count);
+    ImGui::Text("Last step: %zu iterations, impulse change %.4f -> %.4f", _stats.iterations_used, _stats.initial_change, _stats.residual_change);
+    ImGui::Text("This frame: %zu steps, %zu iterations, worst residual %.4f", _stats.step_count, _stats.frame_iterations, _stats.frame_residual_change);
+    ImGui::Text("Solve: %.3f ms", _stats.solve_ms);
+}
+
+void ContactSolver::WarmStartManifold(ContactManifold& manifold) noexcept {
+    const auto a = manifold.body_a;
+    const auto b = manifold.body_b;
+    const auto tangent = CalcTangent(manifold.normal);
+    for(std::size_t i = 0u; i < manifold.point_count; ++i) {
+        const auto& point = manifold.points[i];
+        if(point.normal_impulse == 0.0f && point.tangent_impulse == 0.0f) {
+            continue;
+        }
+        ++_stats.warm_started_point_count;
+        const auto impulse = manifold.normal * point.normal_impulse + tangent * point.tangent_impulse;
+        _velocities[a] -= impulse * _inverse_masses[a];
+        _velocities[b] += impulse * _inverse_masses[b];
+    }
+}
+
+float ContactSolver::SolveManifold(ContactManifold& manifold, float inverse_dt) noexcept {
+    const auto a = manifold.body_a;
+    const auto b = manifold.body_b;
+    const auto inverse_mass_a = _inverse_masses[a];
+    const auto inverse_mass_b = _inverse_masses[b];
+    const auto inverse_mass_sum = inverse_mass_a + inverse_mass_b;
+    if(inverse_mass_sum <= 0.0f) {
+        return 0.0f;
+    }
+    const auto& normal = manifold.normal;
+    const auto tangent = CalcTangent(normal);
+    auto max_change = 0.0f;
+    for(std::size_t i = 0u; i < manifold.point_count; ++i) {
+        auto& point = manifold.points[i];
+        //A gap may close this step but no further; an overlap beyond the slop is pushed out.
+        const auto target = point.separation > 0.0f
+                            ? -point.separation * inverse_dt
+                            : _desc.bias_factor * inverse_dt * (std::max)(-point.separation - _desc.slop, 0.0f);
+        const auto normal_velocity = Dot(_velocities[b] - _velocities[a], normal);
+        const auto previous_normal = point.normal_impulse;
+        //Contacts only push, so the total can fall back to zero but not below.
+        point.normal_impulse = (std::max)(previous_normal + (target - normal_velocity) / inverse_mass_sum, 0.0f);
+        const auto normal_delta = point.normal_impulse - previous_normal;
+        _velocities[a] -= normal * (normal_delta * inverse_mass_a);
+        _velocities[b] += normal * (normal_delta * inverse_mass_b);
+        max_change = (std::max)(max_change, std::abs(normal_delta));
+
+        const auto tangent_velocity = Dot(_velocities[b] - _velocities[a], tangent);
+        const auto max_friction = _desc.friction * point.normal_impulse;
+        const auto previous_tangent = point.tangent_impulse;
+        point.tangent_impulse = std::clamp(previous_tangent - tangent_velocity / inverse_mass_sum, -max_friction, max_friction);
+        const auto tangent_delta = point.tangent_impulse - previous_tangent;
+        _velocities[a] -= tangent * (tangent_delta * inverse_mass_a);
+        _velocities[b] += tangent * (tangent_delta * inverse_mass_b);
+    }
+    return max_change;
+}
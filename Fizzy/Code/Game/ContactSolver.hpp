@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Math/Vector2.hpp"
+
+#include <cstddef>
+#include <vector>
+
+class Scene;
+struct ContactManifold;
+
+struct ContactSolverDesc {
+    //Upper bound on iterations per step.
+    std::size_t max_iterations = 8u;
+    //Stop iterating once no point's normal impulse changed by more than this.
+    float tolerance = 0.01f;
+    //Start each step from the impulses the matching points accumulated in the previous step.
+    bool warm_start = true;
+    //Tangent impulse allowed per unit of normal impulse.
+    float friction = 0.3f;
+    //Fraction of the overlap beyond slop removed per second of step, as separating velocity.
+    float bias_factor = 0.2f;
+    //Overlap, in px, left alone so resting contacts keep their points.
+    float slop = 0.5f;
+};
+
+struct ContactSolverStats {
+    std::size_t manifold_count{};
+    std::size_t point_count{};
+    //Points that started the last step from a carried impulse.
+    std::size_t warm_started_point_count{};
+    //Last step.
+    std::size_t iterations_used{};
+    //Largest change of a normal impulse in the first and last iteration of the last step.
+    float initial_change{};
+    float residual_change{};
+    //Since BeginFrame.
+    std::size_t step_count{};
+    std::size_t frame_iterations{};
+    float frame_residual_change{};
+    float solve_ms{};
+};
+
+//Sequential impulse solver for the manifolds of a ContactCache. Each step it
+//pushes touching bodies apart along the manifold normal and applies friction
+//along the tangent, accumulating the impulse of every point and clamping it
+//so contacts only push and friction stays within the friction cone. With
+//warm starting a point first reapplies the impulses the cache carried over
+//from its matching feature, so a resting stack starts close to solved.
+//
+//Velocities are solved on a copy and written back once per step, like
+//ParallelJointSolver's positions; sleeping bodies hold still. The engine's
+//RigidBody does not expose its inertia, so only linear velocity is solved.
+//This runs after the engine's own collision, which still resolves every
+//contact, so turning it on changes how the scene behaves.
+class ContactSolver {
+public:
+    ContactSolver() = default;
+    ContactSolver(const ContactSolver& other) = default;
+    ContactSolver(ContactSolver&& other) = default;
+    ContactSolver& operator=(const ContactSolver& other) = default;
+    ContactSolver& operator=(ContactSolver&& other) = default;
+    ~ContactSolver() = default;
+
+    void BeginFrame() noexcept;
+    //Call after the cache's Update. Writes the accumulated impulses back into manifolds.
+    void Solve(Scene& scene, std::vector<ContactManifold>& manifolds, TimeUtils::FPSeconds timestep) noexcept;
+
+    void SetDescription(const ContactSolverDesc& desc) noexcept;
+    [[nodiscard]] const ContactSolverDesc& GetDescription() const noexcept;
+    [[nodiscard]] const ContactSolverStats& GetStats() const noexcept;
+
+    //Settings and convergence for a state's debug window.
+    void ShowDebugUI() noexcept;
+
+protected:
+private:
+    void WarmStartManifold(ContactManifold& manifold) noexcept;
+    //Returns the largest change of a normal impulse.
+    [[nodiscard]] float SolveManifold(ContactManifold& manifold, float inverse_dt) noexcept;
+
+    //Per body.
+    std::vector<Vector2> _velocities{};
+    std::vector<Vector2> _start_velocities{};
+    std::vector<float> _inverse_masses{};
+    ContactSolverDesc _desc{};
+    ContactSolverStats _stats{};
+};
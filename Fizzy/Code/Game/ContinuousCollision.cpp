@@ -0,0 +1,304 @@
+#include "Game/ContinuousCollision.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr float degrees_to_radians = 3.14159265358979f / 180.0f;
+//Gap at which conservative advancement counts the shapes as touching.
+constexpr float contact_tolerance = 0.05f;
+constexpr std::size_t max_advancement_iterations = 32u;
+
+float Dot(const Vector2& a, const Vector2& b) noexcept {
+    return a.x * b.x + a.y * b.y;
+}
+
+Vector2 Rotate(const Vector2& v, float cos_theta, float sin_theta) noexcept {
+    return Vector2{v.x * cos_theta - v.y * sin_theta, v.x * sin_theta + v.y * cos_theta};
+}
+
+Vector2 ClosestPointOnSegment(const Vector2& point, const Vector2& start, const Vector2& end) noexcept {
+    const auto segment = end - start;
+    const auto length_sq = Dot(segment, segment);
+    if(length_sq <= 0.0f) {
+        return start;
+    }
+    const auto t = std::clamp(Dot(point - start, segment) / length_sq, 0.0f, 1.0f);
+    return start + segment * t;
+}
+
+//Separating axis test over the edge normals of every shape with an area.
+//Two points or a point and a segment are never reported as overlapping;
+//the distance test covers them.
+bool DoPointSetsOverlap(const Vector2* a, std::size_t a_count, const Vector2* b, std::size_t b_count) noexcept {
+    if(a_count < 3u && b_count < 3u) {
+        return false;
+    }
+    const auto is_separated_on_edges = [&](const Vector2* edges, std::size_t edge_count) {
+        if(edge_count < 3u) {
+            return false;
+        }
+        for(std::size_t i = 0u; i < edge_count; ++i) {
+            const auto edge = edges[(i + 1u) % edge_count] - edges[i];
+            const auto axis = Vector2{-edge.y, edge.x};
+            auto a_min = (std::numeric_limits<float>::max)();
+            auto a_max = std::numeric_limits<float>::lowest();
+            for(std::size_t k = 0u; k < a_count; ++k) {
+                const auto p = Dot(a[k], axis);
+                a_min = (std::min)(a_min, p);
+                a_max = (std::max)(a_max, p);
+            }
+            auto b_min = (std::numeric_limits<float>::max)();
+            auto b_max = std::numeric_limits<float>::lowest();
+            for(std::size_t k = 0u; k < b_count; ++k) {
+                const auto p = Dot(b[k], axis);
+                b_min = (std::min)(b_min, p);
+                b_max = (std::max)(b_max, p);
+            }
+            if(a_max < b_min || b_max < a_min) {
+                return true;
+            }
+        }
+        return false;
+    };
+    return !is_separated_on_edges(a, a_count) && !is_separated_on_edges(b, b_count);
+}
+
+//Closest pair of boundary points, one from each set, over every point of
+//one set against every edge of the other.
+void FindClosestPoints(const Vector2* a, std::size_t a_count, const Vector2* b, std::size_t b_count, Vector2& closest_a, Vector2& closest_b) noexcept {
+    auto best_distance_sq = (std::numeric_limits<float>::max)();
+    const auto test_points_against_edges = [&](const Vector2* points, std::size_t point_count, const Vector2* edges, std::size_t edge_count, bool points_are_a) {
+        for(std::size_t i = 0u; i < point_count; ++i) {
+            const auto edge_total = edge_count < 3u ? edge_count - 1u : edge_count;
+            for(std::size_t k = 0u; k < (std::max)(edge_total, std::size_t{1u}); ++k) {
+                const auto on_edge = edge_count == 1u ? edges[0] : ClosestPointOnSegment(points[i], edges[k], edges[(k + 1u) % edge_count]);
+                const auto offset = on_edge - points[i];
+                const auto distance_sq = Dot(offset, offset);
+                if(distance_sq < best_distance_sq) {
+                    best_distance_sq = distance_sq;
+                    closest_a = points_are_a ? points[i] : on_edge;
+                    closest_b = points_are_a ? on_edge : points[i];
+                }
+            }
+        }
+    };
+    test_points_against_edges(a, a_count, b, b_count, true);
+    test_points_against_edges(b, b_count, a, a_count, false);
+}
+
+Vector2 CalcDirection(const Vector2& from, const Vector2& to) noexcept {
+    const auto offset = to - from;
+    const auto length = std::sqrt(Dot(offset, offset));
+    return length > 0.0f ? offset * (1.0f / length) : Vector2::X_AXIS;
+}
+
+AABB2 CalcSweptBounds(const AABB2& end_bounds, const Vector2& displacement) noexcept {
+    return AABB2{Vector2{(std::min)(end_bounds.mins.x, end_bounds.mins.x - displacement.x), (std::min)(end_bounds.mins.y, end_bounds.mins.y - displacement.y)}
+                 , Vector2{(std::max)(end_bounds.maxs.x, end_bounds.maxs.x - displacement.x), (std::max)(end_bounds.maxs.y, end_bounds.maxs.y - displacement.y)}};
+}
+
+bool DoBoundsOverlap(const AABB2& a, const AABB2& b) noexcept {
+    return a.mins.x <= b.maxs.x && b.mins.x <= a.maxs.x
+        && a.mins.y <= b.maxs.y && b.mins.y <= a.maxs.y;
+}
+
+} // namespace
+
+ConvexShape ConvexShape::FromRecord(const SceneBodyRecord& record, float orientation_degrees) noexcept {
+    auto shape = ConvexShape{};
+    const auto radians = orientation_degrees * degrees_to_radians;
+    const auto c = std::cos(radians);
+    const auto s = std::sin(radians);
+    const auto add_box = [&shape](const Vector2& half_extents, float cos_theta, float sin_theta) {
+        shape.points[0] = Rotate(Vector2{-half_extents.x, -half_extents.y}, cos_theta, sin_theta);
+        shape.points[1] = Rotate(Vector2{half_extents.x, -half_extents.y}, cos_theta, sin_theta);
+        shape.points[2] = Rotate(Vector2{half_extents.x, half_extents.y}, cos_theta, sin_theta);
+        shape.points[3] = Rotate(Vector2{-half_extents.x, half_extents.y}, cos_theta, sin_theta);
+        shape.point_count = 4u;
+    };
+    switch(record.collider_type) {
+    case SceneColliderType::Circle:
+        shape.point_count = 1u;
+        shape.radius = record.size.x;
+        break;
+    case SceneColliderType::AABB:
+        add_box(record.size, 1.0f, 0.0f);
+        break;
+    case SceneColliderType::OBB:
+        add_box(record.size, c, s);
+        break;
+    case SceneColliderType::Polygon:
+    {
+        //Same vertices DebugShapeBatch::AddPolygon draws.
+        const auto half_extents = record.size * 0.5f;
+        const auto sides = (std::min)(static_cast<std::size_t>(record.polygon_sides), max_points);
+        if(sides < 3u) {
+            shape.point_count = 1u;
+            shape.radius = (std::max)(half_extents.x, half_extents.y);
+            break;
+        }
+        const auto step = 360.0f / static_cast<float>(sides);
+        for(std::size_t i = 0u; i < sides; ++i) {
+            const auto vertex_radians = (orientation_degrees + step * static_cast<float>(i)) * degrees_to_radians;
+            shape.points[i] = Vector2{std::cos(vertex_radians) * half_extents.x, std::sin(vertex_radians) * half_extents.y};
+        }
+        shape.point_count = sides;
+        break;
+    }
+    default: ERROR_AND_DIE("SceneColliderType values have changed. Refactor ConvexShape::FromRecord.");
+    }
+    return shape;
+}
+
+ShapeSeparation CalcShapeSeparation(const ConvexShape& a, const Vector2& position_a, const ConvexShape& b, const Vector2& position_b) noexcept {
+    std::array<Vector2, ConvexShape::max_points> points_a{};
+    std::array<Vector2, ConvexShape::max_points> points_b{};
+    for(std::size_t i = 0u; i < a.point_count; ++i) {
+        points_a[i] = a.points[i] + position_a;
+    }
+    for(std::size_t i = 0u; i < b.point_count; ++i) {
+        points_b[i] = b.points[i] + position_b;
+    }
+    if(DoPointSetsOverlap(points_a.data(), a.point_count, points_b.data(), b.point_count)) {
+        return ShapeSeparation{0.0f, CalcDirection(position_a, position_b)};
+    }
+    auto closest_a = Vector2{};
+    auto closest_b = Vector2{};
+    FindClosestPoints(points_a.data(), a.point_count, points_b.data(), b.point_count, closest_a, closest_b);
+    const auto offset = closest_b - closest_a;
+    const auto gap = std::sqrt(Dot(offset, offset)) - a.radius - b.radius;
+    return ShapeSeparation{(std::max)(gap, 0.0f), CalcDirection(closest_a, closest_b)};
+}
+
+TimeOfImpact CalcTimeOfImpact(const ConvexShape& a, const Vector2& start_a, const Vector2& displacement, const ConvexShape& b, const Vector2& position_b) noexcept {
+    if(Dot(displacement, displacement) <= 0.0f) {
+        return TimeOfImpact{};
+    }
+    auto t = 0.0f;
+    for(std::size_t i = 0u; i < max_advancement_iterations; ++i) {
+        const auto separation = CalcShapeSeparation(a, start_a + displacement * t, b, position_b);
+        if(separation.distance <= contact_tolerance) {
+            return TimeOfImpact{true, t, separation.normal};
+        }
+        const auto closing_distance = Dot(displacement, separation.normal);
+        if(closing_distance <= 0.0f) {
+            return TimeOfImpact{};
+        }
+        t += separation.distance / closing_distance;
+        if(t > 1.0f) {
+            return TimeOfImpact{};
+        }
+    }
+    return TimeOfImpact{};
+}
+
+void ContinuousCollision::BeginFrame() noexcept {
+    _stats.query_count = 0u;
+    _stats.hit_count = 0u;
+}
+
+void ContinuousCollision::Update(Scene& scene) noexcept {
+    const auto count = scene.GetBodyCount();
+    const auto swept_count = (std::min)(count, _previous_positions.size());
+    _stats.ccd_body_count = 0u;
+    _shape_slots.assign(count, no_shape);
+    _shapes.clear();
+    //Another body's sweep can only reach the query if its end bounds are within its own displacement of it.
+    auto max_displacement = 0.0f;
+    for(std::size_t i = 0u; i < swept_count; ++i) {
+        const auto displacement = scene.GetBody(i).GetPosition() - _previous_positions[i];
+        max_displacement = (std::max)(max_displacement, (std::max)(std::abs(displacement.x), std::abs(displacement.y)));
+    }
+    const auto& broadphase = scene.UpdateBroadphase();
+    const auto& bounds = broadphase.GetBounds();
+    auto has_moved_bodies = false;
+    for(std::size_t i = 0u; i < swept_count; ++i) {
+        const auto& record = scene.GetBodyRecord(i);
+        if(!record.continuous_collision) {
+            continue;
+        }
+        ++_stats.ccd_body_count;
+        auto& body = scene.GetBody(i);
+        const auto& start = _previous_positions[i];
+        const auto end = body.GetPosition();
+        const auto displacement = end - start;
+        if(!body.IsAwake() || Dot(displacement, displacement) <= 0.0f) {
+            continue;
+        }
+        const auto swept_bounds = CalcSweptBounds(bounds[i], displacement);
+        const auto margin = Vector2{max_displacement, max_displacement};
+        broadphase.Query(AABB2{swept_bounds.mins - margin, swept_bounds.maxs + margin}, _candidates);
+        //A copy, since building other shapes can move the cached ones.
+        const auto shape = GetShape(scene, i);
+        auto first_hit = TimeOfImpact{};
+        auto first_other = count;
+        for(const auto candidate : _candidates) {
+            const auto j = static_cast<std::size_t>(candidate);
+            if(j == i) {
+                continue;
+            }
+            const auto other_start = j < swept_count ? _previous_positions[j] : scene.GetBody(j).GetPosition();
+            const auto other_displacement = scene.GetBody(j).GetPosition() - other_start;
+            if(!DoBoundsOverlap(swept_bounds, CalcSweptBounds(bounds[j], other_displacement))) {
+                continue;
+            }
+            ++_stats.query_count;
+            const auto hit = CalcTimeOfImpact(shape, start, displacement - other_displacement, GetShape(scene, j), other_start);
+            //Touching at the start of the step is a resting contact the discrete solver already has.
+            if(hit.hit && hit.t > 0.0f && (!first_hit.hit || hit.t < first_hit.t)) {
+                first_hit = hit;
+                first_other = j;
+            }
+        }
+        if(!first_hit.hit) {
+            continue;
+        }
+        const auto& other = scene.GetBody(first_other);
+        if(CalcShapeSeparation(shape, end, GetShape(scene, first_other), other.GetPosition()).distance <= 0.0f) {
+            continue;
+        }
+        //Keep the offset from the other body it had at first contact.
+        const auto other_start = first_other < swept_count ? _previous_positions[first_other] : other.GetPosition();
+        const auto other_displacement = other.GetPosition() - other_start;
+        const auto contact_offset = start - other_start + (displacement - other_displacement) * first_hit.t;
+        body.SetPosition(other.GetPosition() + contact_offset, true);
+        const auto closing_speed = Dot(body.GetVelocity() - other.GetVelocity(), first_hit.normal);
+        if(closing_speed > 0.0f) {
+            body.SetVelocity(body.GetVelocity() - first_hit.normal * (closing_speed * (1.0f + record.material.restitution)));
+        }
+        ++_stats.hit_count;
+        ++_stats.total_hit_count;
+        has_moved_bodies = true;
+    }
+    if(has_moved_bodies) {
+        scene.InvalidateBroadphase();
+    }
+    _previous_positions.resize(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        _previous_positions[i] = scene.GetBody(i).GetPosition();
+    }
+}
+
+void ContinuousCollision::Reset() noexcept {
+    _previous_positions.clear();
+    _stats = ContinuousCollisionStats{};
+}
+
+const ContinuousCollisionStats& ContinuousCollision::GetStats() const noexcept {
+    return _stats;
+}
+
+const ConvexShape& ContinuousCollision::GetShape(const Scene& scene, std::size_t index) noexcept {
+    if(_shape_slots[index] == no_shape) {
+        _shape_slots[index] = static_cast<uint32_t>(_shapes.size());
+        _shapes.push_back(ConvexShape::FromRecord(scene.GetBodyRecord(index), scene.GetBody(index).GetOrientationDegrees()));
+    }
+    return _shapes[_shape_slots[index]];
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector2.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+struct SceneBodyRecord;
+
+//A collider as a convex point set grown by a radius: a circle is its center
+//with the circle's radius, the other shapes are their corners with radius 0.
+//Points are relative to the body's position.
+struct ConvexShape {
+    static inline constexpr std::size_t max_points = 32u;
+
+    std::array<Vector2, max_points> points{};
+    std::size_t point_count{};
+    float radius{};
+
+    [[nodiscard]] static ConvexShape FromRecord(const SceneBodyRecord& record, float orientation_degrees) noexcept;
+};
+
+struct ShapeSeparation {
+    //Gap between the shapes, 0 if they overlap.
+    float distance{};
+    //Unit direction from the first shape towards the second.
+    Vector2 normal{};
+};
+
+[[nodiscard]] ShapeSeparation CalcShapeSeparation(const ConvexShape& a, const Vector2& position_a, const ConvexShape& b, const Vector2& position_b) noexcept;
+
+struct TimeOfImpact {
+    bool hit = false;
+    //Fraction of the sweep at first contact.
+    float t{};
+    //Contact normal from a towards b at t.
+    Vector2 normal{};
+};
+
+//First contact of a moving by displacement relative to b, found by
+//conservative advancement: each iteration advances by the current gap over
+//the closing speed, which can never step past the first contact.
+[[nodiscard]] TimeOfImpact CalcTimeOfImpact(const ConvexShape& a, const Vector2& start_a, const Vector2& displacement, const ConvexShape& b, const Vector2& position_b) noexcept;
+
+struct ContinuousCollisionStats {
+    std::size_t ccd_body_count{};
+    //Time of impact queries and tunnelling contacts caught since BeginFrame.
+    std::size_t query_count{};
+    std::size_t hit_count{};
+    std::size_t total_hit_count{};
+};
+
+//Catches bodies flagged with SceneBodyRecord::continuous_collision that
+//passed through another body during the last step. Each one is swept from
+//where it was after the previous step to where it is now, relative to every
+//body its swept bounds touch. Those are found through the scene's shared
+//broadphase, and each body's shape is built at most once per Update. If it met one on the way and no longer
+//overlaps it, it is moved back to the first contact and its velocity into
+//the other body is reflected with the material's restitution. Contacts the
+//step ended inside are left to the discrete solver.
+class ContinuousCollision {
+public:
+    ContinuousCollision() = default;
+    ContinuousCollision(const ContinuousCollision& other) = default;
+    ContinuousCollision(ContinuousCollision&& other) = default;
+    ContinuousCollision& operator=(const ContinuousCollision& other) = default;
+    ContinuousCollision& operator=(ContinuousCollision&& other) = default;
+    ~ContinuousCollision() = default;
+
+    void BeginFrame() noexcept;
+    //Call after every physics step.
+    void Update(Scene& scene) noexcept;
+    //Forgets the previous positions, e.g. after bodies were teleported by a restart.
+    void Reset() noexcept;
+
+    [[nodiscard]] const ContinuousCollisionStats& GetStats() const noexcept;
+
+protected:
+private:
+    static inline constexpr uint32_t no_shape = 0xFFFFFFFFu;
+
+    //The body's shape at its current orientation, built on first use this Update.
+    //A reference is only good until the next call.
+    [[nodiscard]] const ConvexShape& GetShape(const Scene& scene, std::size_t index) noexcept;
+
+    //Positions after the previous step; bodies added since have no sweep yet.
+    std::vector<Vector2> _previous_positions{};
+    std::vector<uint32_t> _candidates{};
+    //Index into _shapes per body, or no_shape.
+    std::vector<uint32_t> _shape_slots{};
+    std::vector<ConvexShape> _shapes{};
+    ContinuousCollisionStats _stats{};
+};
@@ -0,0 +1,223 @@
+#include "Game/DebugDraw.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Math/Vector3.hpp"
+
+#include "Engine/Renderer/Renderer.hpp"
+
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr std::size_t circle_segments = 16u;
+constexpr std::size_t max_polygon_sides = 32u;
+constexpr float degrees_to_radians = 3.14159265358979f / 180.0f;
+
+const std::array<Vector2, circle_segments>& GetUnitCircle() noexcept {
+    static const auto unit_circle = []() {
+        std::array<Vector2, circle_segments> points{};
+        for(std::size_t i = 0u; i < circle_segments; ++i) {
+            const auto radians = 360.0f * degrees_to_radians * static_cast<float>(i) / static_cast<float>(circle_segments);
+            points[i] = Vector2{std::cos(radians), std::sin(radians)};
+        }
+        return points;
+    }();
+    return unit_circle;
+}
+
+Vector2 Rotate(const Vector2& v, float cos_theta, float sin_theta) noexcept {
+    return Vector2{v.x * cos_theta - v.y * sin_theta, v.x * sin_theta + v.y * cos_theta};
+}
+
+} // namespace
+
+void RendererDebugDrawSink::SubmitLines([[maybe_unused]] DebugShapeType type, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo) noexcept {
+    g_theRenderer->DrawIndexed(PrimitiveType::Lines, vbo, ibo);
+}
+
+void RecordingDebugDrawSink::SubmitLines(DebugShapeType type, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo) noexcept {
+    ++draw_count;
+    vertex_count += vbo.size();
+    index_count += ibo.size();
+    ++draws_per_type[static_cast<std::size_t>(type)];
+}
+
+void RecordingDebugDrawSink::Reset() noexcept {
+    draw_count = 0u;
+    vertex_count = 0u;
+    index_count = 0u;
+    draws_per_type.fill(0u);
+}
+
+void DebugShapeBatch::Begin(const AABB2& view) noexcept {
+    for(auto& buffer : _buffers) {
+        buffer.vbo.clear();
+        buffer.ibo.clear();
+        buffer.shape_count = 0u;
+    }
+    _view = view;
+    _culled_count = 0u;
+}
+
+void DebugShapeBatch::AddCircle(const Vector2& center, float radius, const Rgba& color) noexcept {
+    if(!IsVisible(center, radius)) {
+        return;
+    }
+    std::array<Vector2, circle_segments> points{};
+    const auto& unit_circle = GetUnitCircle();
+    for(std::size_t i = 0u; i < circle_segments; ++i) {
+        points[i] = center + unit_circle[i] * radius;
+    }
+    AddLoop(DebugShapeType::Circle, points.data(), points.size(), color);
+}
+
+void DebugShapeBatch::AddAABB(const Vector2& center, const Vector2& half_extents, const Rgba& color) noexcept {
+    if(!IsVisible(center, half_extents.CalcLength())) {
+        return;
+    }
+    const std::array<Vector2, 4> points{
+        Vector2{center.x - half_extents.x, center.y - half_extents.y}
+        , Vector2{center.x + half_extents.x, center.y - half_extents.y}
+        , Vector2{center.x + half_extents.x, center.y + half_extents.y}
+        , Vector2{center.x - half_extents.x, center.y + half_extents.y}
+    };
+    AddLoop(DebugShapeType::AABB, points.data(), points.size(), color);
+}
+
+void DebugShapeBatch::AddOBB(const Vector2& center, const Vector2& half_extents, float orientation_degrees, const Rgba& color) noexcept {
+    if(!IsVisible(center, half_extents.CalcLength())) {
+        return;
+    }
+    const auto radians = orientation_degrees * degrees_to_radians;
+    const auto c = std::cos(radians);
+    const auto s = std::sin(radians);
+    const std::array<Vector2, 4> points{
+        center + Rotate(Vector2{-half_extents.x, -half_extents.y}, c, s)
+        , center + Rotate(Vector2{half_extents.x, -half_extents.y}, c, s)
+        , center + Rotate(Vector2{half_extents.x, half_extents.y}, c, s)
+        , center + Rotate(Vector2{-half_extents.x, half_extents.y}, c, s)
+    };
+    AddLoop(DebugShapeType::OBB, points.data(), points.size(), color);
+}
+
+void DebugShapeBatch::AddPolygon(const Vector2& center, const Vector2& half_extents, std::size_t sides, float orientation_degrees, const Rgba& color) noexcept {
+    if(sides < 3u || !IsVisible(center, (std::max)(half_extents.x, half_extents.y))) {
+        return;
+    }
+    sides = (std::min)(sides, max_polygon_sides);
+    std::array<Vector2, max_polygon_sides> points{};
+    const auto step = 360.0f / static_cast<float>(sides);
+    for(std::size_t i = 0u; i < sides; ++i) {
+        const auto radians = (orientation_degrees + step * static_cast<float>(i)) * degrees_to_radians;
+        points[i] = center + Vector2{std::cos(radians) * half_extents.x, std::sin(radians) * half_extents.y};
+    }
+    AddLoop(DebugShapeType::Polygon, points.data(), sides, color);
+}
+
+void DebugShapeBatch::AddCell(const AABB2& cell, const Rgba& color) noexcept {
+    const auto half_extents = (cell.maxs - cell.mins) * 0.5f;
+    const auto center = cell.mins + half_extents;
+    if(!IsVisible(center, half_extents.CalcLength())) {
+        return;
+    }
+    const std::array<Vector2, 4> points{
+        cell.mins
+        , Vector2{cell.maxs.x, cell.mins.y}
+        , cell.maxs
+        , Vector2{cell.mins.x, cell.maxs.y}
+    };
+    AddLoop(DebugShapeType::Cell, points.data(), points.size(), color);
+}
+
+void DebugShapeBatch::AddScene(const Scene& scene) noexcept {
+    const auto body_count = scene.GetBodyCount();
+    for(std::size_t i = 0u; i < body_count; ++i) {
+        const auto& record = scene.GetBodyRecord(i);
+        const auto& color = scene.GetBody(i).IsAwake() ? Rgba::Green : Rgba::Grey;
+        AddCollider(record.collider_type, scene.CalcRenderPosition(i), record.size, record.polygon_sides, scene.CalcRenderOrientationDegrees(i), color);
+    }
+}
+
+void DebugShapeBatch::AddSnapshot(const RenderSnapshot& snapshot) noexcept {
+    const auto body_count = snapshot.bodies.size();
+    for(std::size_t i = 0u; i < body_count; ++i) {
+        const auto& body = snapshot.bodies[i];
+        const auto& color = body.is_awake ? Rgba::Green : Rgba::Grey;
+        AddCollider(body.collider_type, snapshot.CalcRenderPosition(i), body.size, body.polygon_sides, snapshot.CalcRenderOrientationDegrees(i), color);
+    }
+}
+
+void DebugShapeBatch::AddSnapshotJoints(const RenderSnapshot& snapshot, const Rgba& color) noexcept {
+    for(const auto& joint : snapshot.joints) {
+        const auto a = snapshot.CalcRenderPosition(joint.body_a);
+        const auto b = snapshot.CalcRenderPosition(joint.body_b);
+        const auto half_segment = (b - a) * 0.5f;
+        if(!IsVisible(a + half_segment, half_segment.CalcLength())) {
+            continue;
+        }
+        auto& buffer = GetBuffer(DebugShapeType::Joint);
+        const auto first = static_cast<unsigned int>(buffer.vbo.size());
+        buffer.vbo.push_back(Vertex3D{Vector3{a, 0.0f}, color});
+        buffer.vbo.push_back(Vertex3D{Vector3{b, 0.0f}, color});
+        buffer.ibo.push_back(first);
+        buffer.ibo.push_back(first + 1u);
+        ++buffer.shape_count;
+    }
+}
+
+void DebugShapeBatch::Submit(IDebugDrawSink& sink) const noexcept {
+    for(std::size_t i = 0u; i < _buffers.size(); ++i) {
+        const auto& buffer = _buffers[i];
+        if(!buffer.ibo.empty()) {
+            sink.SubmitLines(static_cast<DebugShapeType>(i), buffer.vbo, buffer.ibo);
+        }
+    }
+}
+
+std::size_t DebugShapeBatch::GetShapeCount(DebugShapeType type) const noexcept {
+    return _buffers[static_cast<std::size_t>(type)].shape_count;
+}
+
+std::size_t DebugShapeBatch::GetCulledCount() const noexcept {
+    return _culled_count;
+}
+
+bool DebugShapeBatch::IsVisible(const Vector2& center, float bounding_radius) noexcept {
+    const auto is_visible = _view.mins.x <= center.x + bounding_radius
+                            && center.x - bounding_radius <= _view.maxs.x
+                            && _view.mins.y <= center.y + bounding_radius
+                            && center.y - bounding_radius <= _view.maxs.y;
+    if(!is_visible) {
+        ++_culled_count;
+    }
+    return is_visible;
+}
+
+void DebugShapeBatch::AddCollider(SceneColliderType type, const Vector2& position, const Vector2& size, std::size_t polygon_sides, float orientation_degrees, const Rgba& color) noexcept {
+    switch(type) {
+    case SceneColliderType::Circle: AddCircle(position, size.x, color); break;
+    case SceneColliderType::AABB: AddAABB(position, size, color); break;
+    case SceneColliderType::OBB: AddOBB(position, size, orientation_degrees, color); break;
+    case SceneColliderType::Polygon: AddPolygon(position, size * 0.5f, polygon_sides, orientation_degrees, color); break;
+    default: ERROR_AND_DIE("SceneColliderType values have changed. Refactor DebugShapeBatch::AddCollider.");
+    }
+}
+
+DebugShapeBatch::LineBuffer& DebugShapeBatch::GetBuffer(DebugShapeType type) noexcept {
+    return _buffers[static_cast<std::size_t>(type)];
+}
+
+void DebugShapeBatch::AddLoop(DebugShapeType type, const Vector2* points, std::size_t count, const Rgba& color) noexcept {
+    auto& buffer = GetBuffer(type);
+    const auto first = static_cast<unsigned int>(buffer.vbo.size());
+    for(std::size_t i = 0u; i < count; ++i) {
+        buffer.vbo.push_back(Vertex3D{Vector3{points[i], 0.0f}, color});
+        buffer.ibo.push_back(first + static_cast<unsigned int>(i));
+        buffer.ibo.push_back(first + static_cast<unsigned int>((i + 1u) % count));
+    }
+    ++buffer.shape_count;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector2.hpp"
+
+#include "Engine/Renderer/Rgba.hpp"
+#include "Engine/Renderer/Vertex3D.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+struct RenderSnapshot;
+enum class SceneColliderType : uint8_t;
+
+enum class DebugShapeType : uint8_t {
+    Circle
+    , AABB
+    , OBB
+    , Polygon
+    , Cell
+    , Joint
+    , Max
+};
+
+//Receives one line list per shape type from DebugShapeBatch::Submit.
+class IDebugDrawSink {
+public:
+    virtual ~IDebugDrawSink() = default;
+
+    virtual void SubmitLines(DebugShapeType type, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo) noexcept = 0;
+
+protected:
+private:
+};
+
+//Draws with g_theRenderer using whatever material and camera are current.
+class RendererDebugDrawSink : public IDebugDrawSink {
+public:
+    void SubmitLines(DebugShapeType type, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo) noexcept override;
+
+protected:
+private:
+};
+
+//Counts what would have been drawn. Needs no renderer, so the headless
+//driver can check how many draws a scene costs.
+class RecordingDebugDrawSink : public IDebugDrawSink {
+public:
+    void SubmitLines(DebugShapeType type, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo) noexcept override;
+    void Reset() noexcept;
+
+    std::size_t draw_count{};
+    std::size_t vertex_count{};
+    std::size_t index_count{};
+    std::array<std::size_t, static_cast<std::size_t>(DebugShapeType::Max)> draws_per_type{};
+};
+
+//Collects debug outlines into one line list per shape type so a frame costs
+//at most one draw per type however many shapes there are. Shapes entirely
+//outside the view are skipped. Buffers keep their capacity between frames.
+class DebugShapeBatch {
+public:
+    DebugShapeBatch() = default;
+    DebugShapeBatch(const DebugShapeBatch& other) = default;
+    DebugShapeBatch(DebugShapeBatch&& other) = default;
+    DebugShapeBatch& operator=(const DebugShapeBatch& other) = default;
+    DebugShapeBatch& operator=(DebugShapeBatch&& other) = default;
+    ~DebugShapeBatch() = default;
+
+    void Begin(const AABB2& view) noexcept;
+
+    void AddCircle(const Vector2& center, float radius, const Rgba& color) noexcept;
+    void AddAABB(const Vector2& center, const Vector2& half_extents, const Rgba& color) noexcept;
+    void AddOBB(const Vector2& center, const Vector2& half_extents, float orientation_degrees, const Rgba& color) noexcept;
+    void AddPolygon(const Vector2& center, const Vector2& half_extents, std::size_t sides, float orientation_degrees, const Rgba& color) noexcept;
+    void AddCell(const AABB2& cell, const Rgba& color) noexcept;
+    //Every body's collider at its render position. Sleeping bodies are grey.
+    void AddScene(const Scene& scene) noexcept;
+    //The same from a render snapshot, for drawing while the scene is being stepped.
+    void AddSnapshot(const RenderSnapshot& snapshot) noexcept;
+    //A line between the render positions of each snapshot joint's bodies.
+    void AddSnapshotJoints(const RenderSnapshot& snapshot, const Rgba& color) noexcept;
+
+    void Submit(IDebugDrawSink& sink) const noexcept;
+
+    [[nodiscard]] std::size_t GetShapeCount(DebugShapeType type) const noexcept;
+    [[nodiscard]] std::size_t GetCulledCount() const noexcept;
+
+protected:
+private:
+    struct LineBuffer {
+        std::vector<Vertex3D> vbo{};
+        std::vector<unsigned int> ibo{};
+        std::size_t shape_count{};
+    };
+
+    [[nodiscard]] bool IsVisible(const Vector2& center, float bounding_radius) noexcept;
+    [[nodiscard]] LineBuffer& GetBuffer(DebugShapeType type) noexcept;
+    //Size as SceneBodyRecord stores it.
+    void AddCollider(SceneColliderType type, const Vector2& position, const Vector2& size, std::size_t polygon_sides, float orientation_degrees, const Rgba& color) noexcept;
+    //Appends a closed outline through the given points.
+    void AddLoop(DebugShapeType type, const Vector2* points, std::size_t count, const Rgba& color) noexcept;
+
+    std::array<LineBuffer, static_cast<std::size_t>(DebugShapeType::Max)> _buffers{};
+    AABB2 _view{};
+    std::size_t _culled_count{};
+};
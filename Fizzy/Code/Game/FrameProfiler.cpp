@@ -0,0 +1,202 @@
+#include "Game/FrameProfiler.hpp"
+
+#if !defined(FINAL_BUILD)
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/UI/UISystem.hpp"
+
+#include "Game/GameConfig.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+FrameProfiler g_theFrameProfiler{};
+
+namespace {
+
+//Where this thread's ProfileScopes add their samples, if not the current frame.
+thread_local FrameProfiler::FrameSamples* t_deferred_samples = nullptr;
+
+} // namespace
+
+const char* GetProfileStageName(ProfileStage stage) noexcept {
+    switch(stage) {
+    case ProfileStage::StateBeginFrame: return "State BeginFrame";
+    case ProfileStage::StateUpdate: return "State Update";
+    case ProfileStage::StateRender: return "State Render";
+    case ProfileStage::StateEndFrame: return "State EndFrame";
+    case ProfileStage::Physics: return "Physics";
+    case ProfileStage::Other: return "Other";
+    case ProfileStage::Frame: return "Frame";
+    case ProfileStage::JointSolve: return "Joint Solve";
+    case ProfileStage::Broadphase: return "Broadphase";
+    case ProfileStage::Contacts: return "Contacts";
+    case ProfileStage::ContinuousCollision: return "Continuous Collision";
+    default: ERROR_AND_DIE("ProfileStage values have changed. Refactor GetProfileStageName.");
+    }
+}
+
+void FrameProfiler::BeginFrame() noexcept {
+    const auto now = Clock::now();
+    if(_is_recording) {
+        auto& frame = _current[static_cast<std::size_t>(ProfileStage::Frame)];
+        frame = std::chrono::duration<float, std::milli>{now - _frame_start}.count();
+        float measured = 0.0f;
+        for(std::size_t i = 0u; i < static_cast<std::size_t>(ProfileStage::Other); ++i) {
+            measured += _current[i];
+        }
+        _current[static_cast<std::size_t>(ProfileStage::Other)] = (std::max)(0.0f, frame - measured);
+        _frames[_next_frame] = _current;
+        _next_frame = (_next_frame + 1u) % history_size;
+        _frame_count = (std::min)(_frame_count + 1u, history_size);
+    }
+    _current.fill(0.0f);
+    _frame_start = now;
+    _is_recording = true;
+}
+
+void FrameProfiler::AddSample(ProfileStage stage, float milliseconds) noexcept {
+    _current[static_cast<std::size_t>(stage)] += milliseconds;
+}
+
+void FrameProfiler::AddSamples(const FrameSamples& samples) noexcept {
+    for(std::size_t i = 0u; i < stage_count; ++i) {
+        _current[i] += samples[i];
+    }
+}
+
+void FrameProfiler::Reset() noexcept {
+    _current.fill(0.0f);
+    _next_frame = 0u;
+    _frame_count = 0u;
+    _is_recording = false;
+}
+
+std::size_t FrameProfiler::GetFrameCount() const noexcept {
+    return _frame_count;
+}
+
+const FrameProfiler::FrameSamples& FrameProfiler::GetFrame(std::size_t age) const noexcept {
+    return _frames[(_next_frame + history_size - 1u - age) % history_size];
+}
+
+ProfileStageStats FrameProfiler::CalcStats(ProfileStage stage) const noexcept {
+    auto stats = ProfileStageStats{};
+    if(!_frame_count) {
+        return stats;
+    }
+    const auto index = static_cast<std::size_t>(stage);
+    std::array<float, history_size> samples{};
+    float sum = 0.0f;
+    stats.min_ms = GetFrame(0u)[index];
+    for(std::size_t i = 0u; i < _frame_count; ++i) {
+        const auto sample = GetFrame(i)[index];
+        samples[i] = sample;
+        sum += sample;
+        stats.min_ms = (std::min)(stats.min_ms, sample);
+    }
+    stats.avg_ms = sum / static_cast<float>(_frame_count);
+    stats.last_ms = GetFrame(0u)[index];
+    const auto p99_index = (_frame_count * 99u + 99u) / 100u - 1u;
+    const auto first = std::begin(samples);
+    std::nth_element(first, first + p99_index, first + _frame_count);
+    stats.p99_ms = samples[p99_index];
+    return stats;
+}
+
+bool FrameProfiler::ExportCsv(const std::filesystem::path& filepath) const noexcept {
+    std::error_code ec{};
+    if(filepath.has_parent_path()) {
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+    }
+    std::ofstream ofs{filepath, std::ios_base::trunc};
+    if(!ofs) {
+        return false;
+    }
+    ofs << "frame";
+    for(std::size_t i = 0u; i < stage_count; ++i) {
+        ofs << ',' << GetProfileStageName(static_cast<ProfileStage>(i));
+    }
+    ofs << '\n';
+    for(std::size_t age = _frame_count; age > 0u; --age) {
+        const auto& frame = GetFrame(age - 1u);
+        ofs << (_frame_count - age);
+        for(const auto sample : frame) {
+            ofs << ',' << sample;
+        }
+        ofs << '\n';
+    }
+    return static_cast<bool>(ofs);
+}
+
+void FrameProfiler::ShowWindow(bool* is_open) noexcept {
+    if(ImGui::Begin("Profiler", is_open, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::Text("Last %zu frames", _frame_count);
+        ImGui::Columns(5, "ProfilerStages");
+        ImGui::Text("Stage");
+        ImGui::NextColumn();
+        ImGui::Text("Min ms");
+        ImGui::NextColumn();
+        ImGui::Text("Avg ms");
+        ImGui::NextColumn();
+        ImGui::Text("P99 ms");
+        ImGui::NextColumn();
+        ImGui::Text("Last ms");
+        ImGui::NextColumn();
+        ImGui::Separator();
+        for(std::size_t i = 0u; i < stage_count; ++i) {
+            const auto stage = static_cast<ProfileStage>(i);
+            const auto stats = CalcStats(stage);
+            ImGui::TextUnformatted(GetProfileStageName(stage));
+            ImGui::NextColumn();
+            ImGui::Text("%.3f", stats.min_ms);
+            ImGui::NextColumn();
+            ImGui::Text("%.3f", stats.avg_ms);
+            ImGui::NextColumn();
+            ImGui::Text("%.3f", stats.p99_ms);
+            ImGui::NextColumn();
+            ImGui::Text("%.3f", stats.last_ms);
+            ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+        if(ImGui::Button("Export CSV")) {
+            [[maybe_unused]] const auto saved = ExportCsv(std::filesystem::path{g_profile_folderpath} / "frame_profile.csv");
+        }
+        ImGui::SameLine();
+        if(ImGui::Button("Reset")) {
+            Reset();
+        }
+    }
+    ImGui::End();
+}
+
+ProfileScope::ProfileScope(ProfileStage stage) noexcept
+    : _start{std::chrono::steady_clock::now()}
+    , _stage{stage}
+{
+    /* DO NOTHING */
+}
+
+ProfileScope::~ProfileScope() noexcept {
+    const auto milliseconds = std::chrono::duration<float, std::milli>{std::chrono::steady_clock::now() - _start}.count();
+    if(t_deferred_samples) {
+        (*t_deferred_samples)[static_cast<std::size_t>(_stage)] += milliseconds;
+    } else {
+        g_theFrameProfiler.AddSample(_stage, milliseconds);
+    }
+}
+
+ProfileDeferScope::ProfileDeferScope(FrameProfiler::FrameSamples& samples) noexcept
+    : _previous{std::exchange(t_deferred_samples, &samples)}
+{
+    /* DO NOTHING */
+}
+
+ProfileDeferScope::~ProfileDeferScope() noexcept {
+    t_deferred_samples = _previous;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+//Per-stage frame timings kept for the last few hundred frames.
+//Compiled out of FinalBuild: the PROFILE_* macros expand to nothing and
+//FrameProfiler is not defined.
+
+enum class ProfileStage : uint8_t {
+    StateBeginFrame
+    , StateUpdate
+    , StateRender
+    , StateEndFrame
+    , Physics
+    //Frame time not covered by any other stage, e.g. the engine's own physics step and present.
+    , Other
+    , Frame
+    //Passes the states run after a physics step, already counted in Physics.
+    //The broadphase is also counted in whichever pass first needed it.
+    , JointSolve
+    , Broadphase
+    , Contacts
+    , ContinuousCollision
+    , Max
+};
+
+#if !defined(FINAL_BUILD)
+
+[[nodiscard]] const char* GetProfileStageName(ProfileStage stage) noexcept;
+
+struct ProfileStageStats {
+    float min_ms{};
+    float avg_ms{};
+    float p99_ms{};
+    float last_ms{};
+};
+
+class FrameProfiler {
+public:
+    static inline constexpr std::size_t history_size = 300u;
+    static inline constexpr std::size_t stage_count = static_cast<std::size_t>(ProfileStage::Max);
+    using FrameSamples = std::array<float, stage_count>;
+
+    FrameProfiler() = default;
+    FrameProfiler(const FrameProfiler& other) = delete;
+    FrameProfiler(FrameProfiler&& other) = delete;
+    FrameProfiler& operator=(const FrameProfiler& other) = delete;
+    FrameProfiler& operator=(FrameProfiler&& other) = delete;
+    ~FrameProfiler() = default;
+
+    //Closes the previous frame and starts recording a new one.
+    void BeginFrame() noexcept;
+    void AddSample(ProfileStage stage, float milliseconds) noexcept;
+    //Adds samples collected by a ProfileDeferScope on another thread.
+    void AddSamples(const FrameSamples& samples) noexcept;
+    void Reset() noexcept;
+
+    [[nodiscard]] std::size_t GetFrameCount() const noexcept;
+    [[nodiscard]] ProfileStageStats CalcStats(ProfileStage stage) const noexcept;
+    //One row per recorded frame, oldest first.
+    [[nodiscard]] bool ExportCsv(const std::filesystem::path& filepath) const noexcept;
+
+    void ShowWindow(bool* is_open) noexcept;
+
+protected:
+private:
+    using Clock = std::chrono::steady_clock;
+
+    [[nodiscard]] const FrameSamples& GetFrame(std::size_t age) const noexcept;
+
+    std::array<FrameSamples, history_size> _frames{};
+    FrameSamples _current{};
+    Clock::time_point _frame_start{};
+    std::size_t _next_frame{};
+    std::size_t _frame_count{};
+    bool _is_recording = false;
+};
+
+extern FrameProfiler g_theFrameProfiler;
+
+//Adds the lifetime of the enclosing scope to the current frame's stage time.
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileStage stage) noexcept;
+    ProfileScope(const ProfileScope& other) = delete;
+    ProfileScope(ProfileScope&& other) = delete;
+    ProfileScope& operator=(const ProfileScope& other) = delete;
+    ProfileScope& operator=(ProfileScope&& other) = delete;
+    ~ProfileScope() noexcept;
+
+protected:
+private:
+    std::chrono::steady_clock::time_point _start{};
+    ProfileStage _stage{};
+};
+
+//Sends the samples of ProfileScopes on the creating thread to samples
+//instead of the current frame, for passes off the frame thread. The frame
+//thread adds them with FrameProfiler::AddSamples once that pass is done.
+class ProfileDeferScope {
+public:
+    explicit ProfileDeferScope(FrameProfiler::FrameSamples& samples) noexcept;
+    ProfileDeferScope(const ProfileDeferScope& other) = delete;
+    ProfileDeferScope(ProfileDeferScope&& other) = delete;
+    ProfileDeferScope& operator=(const ProfileDeferScope& other) = delete;
+    ProfileDeferScope& operator=(ProfileDeferScope&& other) = delete;
+    ~ProfileDeferScope() noexcept;
+
+protected:
+private:
+    FrameProfiler::FrameSamples* _previous{};
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_STAGE(stage) const ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__){stage}
+#define PROFILE_BEGIN_FRAME() g_theFrameProfiler.BeginFrame()
+
+#else
+
+#define PROFILE_STAGE(stage)
+#define PROFILE_BEGIN_FRAME()
+
+#endif
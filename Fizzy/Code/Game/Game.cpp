@@ -22,14 +22,21 @@
 
 #include "Engine/UI/UISystem.hpp"
 
+#include "Game/FrameProfiler.hpp"
 #include "Game/GameConfig.hpp"
+#include "Game/InputRecorder.hpp"
+#include "Game/JobSystem.hpp"
 
 #include "Game/GameStateGravityDrag.hpp"
 
 #include <array>
+#include <cmath>
+#include <filesystem>
+#include <string>
 
 void Game::Initialize() noexcept {
     g_theRenderer->RegisterMaterialsFromFolder(std::string{ "Data/Materials" });
+    g_theJobSystem.Initialize(JobSystem::CalcDefaultWorkerCount());
     _state.ChangeState(GameStateGravityDrag::ID);
 }
 
@@ -43,11 +50,18 @@ void Game::Update(TimeUtils::FPSeconds deltaSeconds) noexcept {
         _state.RestartState();
     }
     ShowDemoSelectionWindow();
+#if !defined(FINAL_BUILD)
+    if(_show_profiler) {
+        g_theFrameProfiler.ShowWindow(&_show_profiler);
+    }
+#endif
+    //Last, since the UI above may still change the scene or the fixed-step settings.
+    _state.BeginSimulation();
 }
 
 void Game::ShowDemoSelectionWindow() noexcept {
     if(ImGui::Begin("Demo", &_show_debug_window, ImGuiWindowFlags_AlwaysAutoResize)) {
-        std::array items{"GravityDrag", "Constraints", "Sleep Management"};
+        std::array items{"GravityDrag", "Constraints", "Sleep Management", "Stress"};
         const char* current_item = items[_demo_index];
         if(ImGui::BeginCombo("Demo", current_item)) {
             for(auto it = std::cbegin(items); it != std::cend(items); ++it) {
@@ -69,6 +83,9 @@ void Game::ShowDemoSelectionWindow() noexcept {
                 case 2:
                     _state.ChangeState(GameStateSleepManagement::ID);
                     break;
+                case 3:
+                    _state.ChangeState(GameStateStress::ID);
+                    break;
                 default: ERROR_AND_DIE("Game State values have changed. Refactor Demo GUI code.");
                 }
             }
@@ -77,6 +94,43 @@ void Game::ShowDemoSelectionWindow() noexcept {
         if(ImGui::Button("Restart Demo")) {
             _state.RestartState();
         }
+        if(_state.IsLoading()) {
+            ImGui::ProgressBar(_state.GetLoadProgress(), ImVec2{-1.0f, 0.0f}, "Loading...");
+        }
+        auto fixed_timestep = _state.GetFixedTimestep();
+        bool fixed_timestep_changed = ImGui::Checkbox("Fixed timestep", &fixed_timestep.enabled);
+        if(fixed_timestep.enabled) {
+            int hz = static_cast<int>(std::round(1.0f / fixed_timestep.step.count()));
+            if(ImGui::SliderInt("Physics Hz", &hz, 10, 240)) {
+                fixed_timestep.step = TimeUtils::FPSeconds{1.0f / static_cast<float>(hz)};
+                fixed_timestep_changed = true;
+            }
+            fixed_timestep_changed |= ImGui::SliderInt("Max substeps", &fixed_timestep.max_substeps, 1, 16);
+            fixed_timestep_changed |= ImGui::Checkbox("Simulation thread", &fixed_timestep.threaded);
+            ImGui::Text("Substeps this frame: %d", _state.GetLastSubstepCount());
+        }
+        if(fixed_timestep_changed) {
+            _state.SetFixedTimestep(fixed_timestep);
+        }
+        if(!g_theInputRecorder.IsRecording()) {
+            if(ImGui::Button("Record")) {
+                _state.StartRecording();
+            }
+        } else {
+            ImGui::Text("Recording frame %zu", g_theInputRecorder.GetRecording().frames.size());
+            if(ImGui::Button("Stop and save")) {
+                _state.StopRecording();
+                const auto filepath = std::filesystem::path{g_recording_folderpath} / (std::string{"Recording"} + InputRecording::extension);
+                [[maybe_unused]] const auto saved = g_theInputRecorder.GetRecording().Save(filepath);
+            }
+        }
+        int workers = static_cast<int>(g_theJobSystem.GetWorkerCount());
+        if(ImGui::SliderInt("Job workers", &workers, 0, static_cast<int>(JobSystem::CalcDefaultWorkerCount()))) {
+            g_theJobSystem.Initialize(static_cast<std::size_t>(workers));
+        }
+#if !defined(FINAL_BUILD)
+        ImGui::Checkbox("Show Profiler", &_show_profiler);
+#endif
     }
     ImGui::End();
 }
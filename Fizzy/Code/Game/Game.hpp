@@ -38,6 +38,7 @@ private:
     bool _isGravityEnabled = true;
     bool _isDragEnabled = true;
     bool _show_debug_window = true;
+    bool _show_profiler = false;
     bool _show_world_partition = true;
     bool _show_collision = true;
 };
@@ -1 +1,15 @@
 #include "Game/GameCommon.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/Window.hpp"
+
+#include "Game/GameConfig.hpp"
+
+IntVector2 GetWorldDimensions() noexcept {
+    if(g_theRenderer) {
+        return g_theRenderer->GetOutput()->GetDimensions();
+    }
+    return IntVector2{static_cast<int>(currentGraphicsOptions.WindowWidth), static_cast<int>(currentGraphicsOptions.WindowHeight)};
+}
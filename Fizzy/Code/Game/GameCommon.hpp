@@ -1 +1,7 @@
 #pragma once
+
+#include "Engine/Math/IntVector2.hpp"
+
+//Dimensions of the render output, or of the configured window when
+//running without a renderer (e.g. the headless simulation driver).
+[[nodiscard]] IntVector2 GetWorldDimensions() noexcept;
@@ -29,3 +29,7 @@ windowed=1
 
 static std::string g_title_str{"Fizzy Demo"};
 static std::string g_material_folderpath{"Data/Materials/"};
+static std::string g_scene_folderpath{"Data/Scenes/"};
+static std::string g_scene_export_folderpath{"Data/Scenes/Exported/"};
+static std::string g_profile_folderpath{"Data/Profiles/"};
+static std::string g_recording_folderpath{"Data/Recordings/"};
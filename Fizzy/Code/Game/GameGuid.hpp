@@ -0,0 +1,23 @@
+#pragma once
+
+#ifdef _WIN32
+#include <guiddef.h>
+#else
+
+#include <cstdint>
+#include <cstring>
+
+//Layout-compatible stand-in for the Win32 GUID so the game states
+//can be built by the headless driver on non-Windows hosts.
+struct GUID {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+};
+
+inline bool IsEqualGUID(const GUID& a, const GUID& b) noexcept {
+    return std::memcmp(&a, &b, sizeof(GUID)) == 0;
+}
+
+#endif
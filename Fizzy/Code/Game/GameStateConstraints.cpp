@@ -7,31 +7,52 @@
 
 #include "Engine/Physics/PhysicsSystem.hpp"
 #include "Engine/Physics/PhysicsUtils.hpp"
-#include "Engine/Physics/SpringJoint.hpp"
-#include "Engine/Physics/RodJoint.hpp"
-#include "Engine/Physics/CableJoint.hpp"
 
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Window.hpp"
 
+#include "Game/FrameProfiler.hpp"
 #include "Game/Game.hpp"
-#include "Game/GameCommon.hpp"
 #include "Game/GameConfig.hpp"
+#include "Game/InputRecorder.hpp"
+#include "Game/SceneFile.hpp"
 
-#include <functional>
-#include <string>
+#include <cstdio>
 #include <vector>
 
+void GameStateConstraints::BeforeLoad() noexcept {
+    _loaded_exported_scene = _load_exported_scene;
+}
+
+void GameStateConstraints::OnLoad(const LoadContext& context, LoadProgress& progress) noexcept {
+    if(!SceneFile::Build(_scene, SceneFile::GetLoadFilepath("Constraints", _loaded_exported_scene), &progress) || !_scene.GetBodyCount()) {
+        _scene.Build(CreateDefaultScene(context.world_dimensions).GetView(), &progress);
+    }
+}
+
 void GameStateConstraints::OnEnter() noexcept {
-    float width = static_cast<float>(g_theRenderer->GetOutput()->GetDimensions().x);
-    float height = static_cast<float>(g_theRenderer->GetOutput()->GetDimensions().y);
+    _scene.SetJointSolver(_use_parallel_joints ? SceneJointSolver::Parallel : SceneJointSolver::Engine);
+    _scene.Register();
+    _joint_solver.Rebuild(_scene);
+    if(_selected_body >= _scene.GetBodyCount()) {
+        _selected_body = 0u;
+    }
+
+    g_thePhysicsSystem->Enable(true);
+    //Collision outlines are batched by the state; the engine only draws the partition and joints.
+    g_thePhysicsSystem->Debug_ShowCollision(false);
+
+}
+
+SceneDesc GameStateConstraints::CreateDefaultScene(const IntVector2& world_dims) const noexcept {
+    float width = static_cast<float>(world_dims.x);
+    float height = static_cast<float>(world_dims.y);
     float screenX = width * 0.50f;
     float screenY = height * 0.50f;
-    const auto world_dims = g_theRenderer->GetOutput()->GetDimensions();
     const auto mins = Vector2(-world_dims) * 0.5f;
     const auto maxs = Vector2(world_dims) * 0.5f;
-    auto physicsSystemDesc = PhysicsSystemDesc{};
-    physicsSystemDesc.world_bounds = AABB2{mins, maxs};
+    auto scene = SceneDesc{};
+    scene.physics.world_bounds = AABB2{mins, maxs};
     float x1 = screenX;
     float y1 = screenY;
     float x2 = x1 + 55.0f;
@@ -45,121 +66,44 @@ void GameStateConstraints::OnEnter() noexcept {
     float x6 = x5 + 25.0f;
     float y6 = y5 - 110.0f;
     float radius = 25.0f;
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x1, y1}
-                    , Velocity{}
-                    , Acceleration{}
-                    ,new ColliderCircle(Vector2(x1, y1), radius)
-                    , PhysicsMaterial{0.0f, 0.0f}
-                    , PhysicsDesc{}
-                    )));
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position(x2, y2)
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x2, y2), radius)
-        , PhysicsMaterial{0.0f, 0.0f}
-        , PhysicsDesc{0.0f}
-    )));
-    _bodies.back().EnableGravity(true);
-    _bodies.back().EnableDrag(false);
-
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x3, y3}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x3, y3), radius)
-        , PhysicsMaterial{0.0f, 0.0f, 0.0f}
-        , PhysicsDesc{0.0f}
-    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(false);
-
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x4, y4}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x4, y4), radius)
-        , PhysicsMaterial{0.0f, 0.0f, 5.0f}
-        , PhysicsDesc{0.0f}
-    )));
-    _bodies.back().EnableGravity(true);
-    _bodies.back().EnableDrag(false);
-
-
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x5, y5}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x5, y5), radius)
-        , PhysicsMaterial{0.0f, 0.0f, 0.0f}
-        , PhysicsDesc{0.0f}
-    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(false);
-
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x6, y6}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x6, y6), radius)
-        , PhysicsMaterial{0.0f, 0.0f, 10.0f}
-        , PhysicsDesc{0.0f}
-    )));
-    _bodies.back().EnableGravity(true);
-    _bodies.back().EnableDrag(false);
-
-    _activeBody = &_bodies[0];
+    const auto size = Vector2{radius, radius};
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x1, y1}, size, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{}));
 
-    {
-        SpringJointDef spring{};
-        spring.rigidBodyA = &_bodies[0];
-        spring.rigidBodyB = &_bodies[1];
-        spring.k = 1.0f;
-        spring.length = 55.0f;
-        _joints.push_back(g_thePhysicsSystem->CreateJoint(spring));
-    }
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x2, y2}, size, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{0.0f}));
+    scene.bodies.back().gravity_enabled = true;
+    scene.bodies.back().drag_enabled = false;
 
-    {
-        RodJointDef rod{};
-        rod.rigidBodyA = &_bodies[2];
-        rod.rigidBodyB = &_bodies[3];
-        rod.length = 55.0f;
-        _joints.push_back(g_thePhysicsSystem->CreateJoint(rod));
-    }
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x3, y3}, size, PhysicsMaterial{0.0f, 0.0f, 0.0f}, PhysicsDesc{0.0f}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = false;
 
-    {
-        CableJointDef cable{};
-        cable.rigidBodyA = &_bodies[4];
-        cable.rigidBodyB = &_bodies[5];
-        cable.length = 55.0f;
-        _joints.push_back(g_thePhysicsSystem->CreateJoint(cable));
-    }
-    _activeJoint = _joints[0];
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x4, y4}, size, PhysicsMaterial{0.0f, 0.0f, 5.0f}, PhysicsDesc{0.0f}));
+    scene.bodies.back().gravity_enabled = true;
+    scene.bodies.back().drag_enabled = false;
 
-    std::vector<RigidBody*> body_ptrs(_bodies.size());
-    for(std::size_t i = 0u; i < _bodies.size(); ++i) {
-        body_ptrs[i] = &_bodies[i];
-    }
-    g_thePhysicsSystem->SetWorldDescription(physicsSystemDesc);
-    g_thePhysicsSystem->AddObjects(body_ptrs);
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x5, y5}, size, PhysicsMaterial{0.0f, 0.0f, 0.0f}, PhysicsDesc{0.0f}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = false;
 
-    g_thePhysicsSystem->Enable(true);
-    g_thePhysicsSystem->Debug_ShowCollision(true);
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x6, y6}, size, PhysicsMaterial{0.0f, 0.0f, 10.0f}, PhysicsDesc{0.0f}));
+    scene.bodies.back().gravity_enabled = true;
+    scene.bodies.back().drag_enabled = false;
 
+    scene.joints.push_back(SceneJointRecord{SceneJointType::Spring, 0u, 1u, 55.0f, 1.0f});
+    scene.joints.push_back(SceneJointRecord{SceneJointType::Rod, 2u, 3u, 55.0f});
+    scene.joints.push_back(SceneJointRecord{SceneJointType::Cable, 4u, 5u, 55.0f});
+    return scene;
 }
 
 void GameStateConstraints::OnExit() noexcept {
-    g_thePhysicsSystem->RemoveAllObjectsImmediately();
+    _scene.Clear();
     g_thePhysicsSystem->Debug_ShowCollision(false);
     g_thePhysicsSystem->Enable(false);
-    _bodies.clear();
-    _joints.clear();
 }
 
 
 void GameStateConstraints::BeginFrame() noexcept {
-    /* DO NOTHING */
+    _joint_solver.BeginFrame();
 }
 
 void GameStateConstraints::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept {
@@ -168,8 +112,8 @@ void GameStateConstraints::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSec
         return;
     }
     g_thePhysicsSystem->Debug_ShowWorldPartition(_show_world_partition);
-    g_thePhysicsSystem->Debug_ShowCollision(_show_collision);
-    g_thePhysicsSystem->Debug_ShowJoints(_show_joints);
+    //Joints are drawn from the render snapshot with the bodies.
+    g_thePhysicsSystem->Debug_ShowJoints(false);
     g_theRenderer->UpdateGameTime(deltaSeconds);
     if(_show_debug_window) {
         ShowDebugWindow();
@@ -178,7 +122,8 @@ void GameStateConstraints::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSec
     Camera2D& base_camera = _ui_camera;
     base_camera.Update(deltaSeconds);
 
-    _debug_point_on_body = MathUtils::CalcClosestPoint(g_theInputSystem->GetMouseCoords(), *_activeBody->GetCollider());
+    const auto& selected_body = _scene.GetBody(_selected_body);
+    _debug_point_offset = MathUtils::CalcClosestPoint(g_theInputSystem->GetMouseCoords(), *selected_body.GetCollider()) - selected_body.GetPosition();
     HandleInput();
 }
 
@@ -206,14 +151,67 @@ void GameStateConstraints::Render() const noexcept {
     g_theRenderer->DrawAxes(static_cast<float>((std::max)(ui_view_extents.x, ui_view_extents.y)), false);
     g_theRenderer->SetMaterial(g_theRenderer->GetMaterial("__2D"));
 
-    if(!_debug_click_adds_bodies) {
-        g_theRenderer->DrawFilledCircle2D(_debug_point_on_body, 5.0f);
+    const auto& snapshot = _scene.GetRenderSnapshot();
+    if(_show_collision || _show_joints) {
+        _debug_shapes.Begin(AABB2{_ui_camera.position - ui_view_half_extents, _ui_camera.position + ui_view_half_extents});
+        if(_show_collision) {
+            _debug_shapes.AddSnapshot(snapshot);
+        }
+        if(_show_joints) {
+            _debug_shapes.AddSnapshotJoints(snapshot, Rgba::Yellow);
+        }
+        auto sink = RendererDebugDrawSink{};
+        _debug_shapes.Submit(sink);
     }
 
+    if(!_debug_click_adds_bodies && _selected_body < snapshot.bodies.size()) {
+        //Follow the interpolated body rather than its latest simulated position.
+        g_theRenderer->DrawFilledCircle2D(snapshot.CalcRenderPosition(_selected_body) + _debug_point_offset, 5.0f);
+    }
+
+}
+
+Scene* GameStateConstraints::GetScene() noexcept {
+    return &_scene;
+}
+
+const ParallelJointSolver* GameStateConstraints::GetJointSolver() const noexcept {
+    return &_joint_solver;
+}
+
+bool GameStateConstraints::CanRestartInPlace() const noexcept {
+    //Switching joint solvers needs the joints registered again, and switching scene files a reload.
+    return _scene.GetJointSolver() == (_use_parallel_joints ? SceneJointSolver::Parallel : SceneJointSolver::Engine)
+           && _loaded_exported_scene == _load_exported_scene;
+}
+
+void GameStateConstraints::AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept {
+    if(_scene.GetJointSolver() == SceneJointSolver::Parallel) {
+        PROFILE_STAGE(ProfileStage::JointSolve);
+        _joint_solver.SetDescription(_joint_solver_desc);
+        _joint_solver.Solve(_scene, timestep);
+    }
+}
+
+void GameStateConstraints::OnRestart() noexcept {
+    //The restore may have reattached joints or dropped bodies.
+    _joint_solver.Rebuild(_scene);
+    if(_selected_body >= _scene.GetBodyCount()) {
+        _selected_body = 0u;
+    }
 }
 
 void GameStateConstraints::EndFrame() noexcept {
-    /* DO NOTHING */
+    if(_new_body_positions.empty()) {
+        return;
+    }
+    std::vector<SceneBodyRecord> new_bodies{};
+    new_bodies.reserve(_new_body_positions.size());
+    for(const auto& pos : _new_body_positions) {
+        new_bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, pos, Vector2{25.0f, 25.0f}));
+    }
+    _scene.AddBodies(new_bodies.data(), new_bodies.size());
+    _new_body_positions.clear();
 }
 
 void GameStateConstraints::HandleInput() noexcept {
@@ -254,118 +252,134 @@ void GameStateConstraints::Debug_AddBodyOrApplyForceAtMouseCoords() noexcept {
 }
 
 void GameStateConstraints::Debug_AddBodyAtMouseCoords() noexcept {
-    const auto& p = g_theInputSystem->GetMouseCoords();
-    _new_body_positions.push_back(p);
+    SubmitEvent(g_theInputRecorder.Record(RecordedEventType::AddBody, g_theInputSystem->GetMouseCoords()));
 }
 
 void GameStateConstraints::Debug_ApplyImpulseAtMouseCoords() noexcept {
-    const auto& p = g_theInputSystem->GetMouseCoords();
-    const auto point_on_body = MathUtils::CalcClosestPoint(p, *_activeBody->GetCollider());
-    const auto direction = (point_on_body - p).GetNormalize();
-    _activeBody->ApplyImpulse(direction * 1000.0f);
+    SubmitEvent(g_theInputRecorder.Record(RecordedEventType::ApplyImpulse, g_theInputSystem->GetMouseCoords(), static_cast<uint32_t>(_selected_body)));
+}
+
+void GameStateConstraints::ApplyRecordedEvent(const RecordedEvent& event) noexcept {
+    switch(event.type) {
+    case RecordedEventType::ApplyImpulse:
+    {
+        if(event.index >= _scene.GetBodyCount()) {
+            break;
+        }
+        auto& body = _scene.GetBody(event.index);
+        const auto point_on_body = MathUtils::CalcClosestPoint(event.point, *body.GetCollider());
+        const auto direction = (point_on_body - event.point).GetNormalize();
+        body.ApplyImpulse(direction * 1000.0f);
+        break;
+    }
+    case RecordedEventType::AddBody:
+        _new_body_positions.push_back(event.point);
+        break;
+    case RecordedEventType::DetachJoint:
+    {
+        if(event.index >= _scene.GetJoints().size() || !_scene.IsJointIntact(event.index)) {
+            break;
+        }
+        _scene.DetachJoint(event.index, event.sub_index == 0u);
+        _joint_solver.Rebuild(_scene);
+        break;
+    }
+    default:
+        /* DO NOTHING */
+        break;
+    }
 }
 
 void GameStateConstraints::ShowDebugWindow() {
     if(ImGui::Begin("Debug Window", &_show_debug_window)) {
+        if(ImGui::Button("Export scene")) {
+            [[maybe_unused]] const auto saved = SceneFile::Save(SceneFile::GetExportFilepath("Constraints"), _scene.Export().GetView());
+        }
+        ImGui::Checkbox("Load exported scene", &_load_exported_scene);
         ImGui::Checkbox("Show Collision", &_show_collision);
         ImGui::Checkbox("Show Joints", &_show_joints);
         Debug_SelectedBodiesComboBoxUI();
         Debug_ShowBodiesUI();
         Debug_ShowJointsUI();
+        Debug_ShowJointSolverUI();
     }
     ImGui::End();
 }
 
 void GameStateConstraints::Debug_SelectedBodiesComboBoxUI() {
-    const auto b_size = _bodies.size();
-    const auto distance_between_b2b3 = MathUtils::CalcDistance(_bodies[2].GetPosition(), _bodies[3].GetPosition());
-    ImGui::Text("B2B3 Distance: %.02f", distance_between_b2b3);
-    const auto distance_between_b4b5 = MathUtils::CalcDistance(_bodies[4].GetPosition(), _bodies[5].GetPosition());
-    ImGui::Text("B4B5 Distance: %.02f", distance_between_b4b5);
-    std::vector<std::string> items{};
-    items.resize(b_size);
-    for(std::size_t i = 0u; i < b_size; ++i) {
-        items[i] = std::string{"Body "} + std::to_string(i);
-    }
-    std::string current_item = items[_selected_body];
-    if(ImGui::BeginCombo("Selected Body", current_item.c_str())) {
-        for(auto it = std::cbegin(items); it != std::cend(items); ++it) {
-            bool is_selected = current_item == *it;
-            if(ImGui::Selectable((*it).c_str(), is_selected)) {
-                current_item = *it;
-                _selected_body = std::distance(std::cbegin(items), it);
-            }
-            if(is_selected) {
-                ImGui::SetItemDefaultFocus();
-            }
-        }
-        ImGui::EndCombo();
+    const auto b_size = _scene.GetBodyCount();
+    //A loaded scene file may have fewer bodies than the default scene.
+    if(b_size > 5u) {
+        const auto distance_between_b2b3 = MathUtils::CalcDistance(_scene.GetBody(2).GetPosition(), _scene.GetBody(3).GetPosition());
+        ImGui::Text("B2B3 Distance: %.02f", distance_between_b2b3);
+        const auto distance_between_b4b5 = MathUtils::CalcDistance(_scene.GetBody(4).GetPosition(), _scene.GetBody(5).GetPosition());
+        ImGui::Text("B4B5 Distance: %.02f", distance_between_b4b5);
     }
-    _activeBody = &_bodies[_selected_body];
+    _inspector.ShowSelectionCombo(_scene, _selected_body);
 }
 
 void GameStateConstraints::Debug_ShowBodiesUI() {
-    const auto b_size = _bodies.size();
-    std::string header = std::string{"Bodies - "} + std::to_string(b_size);
-    if(ImGui::CollapsingHeader(header.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
-        for(std::size_t i = 0; i < b_size; ++i) {
-            const auto* body = &_bodies[i];
-            std::string bodies_tree_name{"Body "};
-            bodies_tree_name += std::to_string(i);
-            if(ImGui::TreeNode(reinterpret_cast<void*>(static_cast<std::uintptr_t>(std::hash<std::string>{}(bodies_tree_name))), bodies_tree_name.c_str())) {
-                Debug_ShowBodyParametersUI(body);
-                ImGui::TreePop();
-            }
-        }
-    }
+    _inspector.ShowBodyList(_scene, _selected_body, ImGuiTreeNodeFlags_DefaultOpen);
 }
 
 void GameStateConstraints::Debug_ShowJointsUI() {
-    const auto& joints = g_thePhysicsSystem->Debug_GetJoints();
-    const auto j_size = joints.size();
-    std::string joints_header = std::string{"Joints - "} + std::to_string(j_size);
-    if(ImGui::CollapsingHeader(joints_header.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
-        for(std::size_t i = 0; i < j_size; ++i) {
-            auto& joint = *joints[i].get();
-            std::string joints_tree_name{"Joint "};
-            joints_tree_name += std::to_string(i);
-            if(ImGui::TreeNode(reinterpret_cast<void*>(static_cast<std::uintptr_t>(std::hash<std::string>{}(joints_tree_name))), joints_tree_name.c_str())) {
-                const auto* const bodyA = joint.GetBodyA();
-                const auto* const bodyB = joint.GetBodyB();
-                const auto anchorA = joint.GetAnchorA();
-                const auto anchorB = joint.GetAnchorB();
-                for(std::size_t j = 0; j < 2; ++j) {
-                    std::string joints_body_header{"Body "};
-                    joints_body_header += static_cast<char>('A' + j);
-                    if(ImGui::TreeNode(reinterpret_cast<void*>(static_cast<std::uintptr_t>(std::hash<std::string>{}(joints_body_header))), joints_body_header.c_str())) {
-                        _activeJoint = &joint;
-                        if(ImGui::Button("Detach")) {
-                            joint.Detach(j == 0 ? bodyA : bodyB);
-                        }
-                        Debug_ShowBodyParametersUI(j == 0 ? bodyA : bodyB);
-                        ImGui::TreePop();
-                    }
+    const auto j_size = _scene.GetJoints().size();
+    char label[48]{};
+    std::snprintf(label, sizeof(label), "Joints - %zu###Joints", j_size);
+    if(!ImGui::CollapsingHeader(label, ImGuiTreeNodeFlags_DefaultOpen)) {
+        return;
+    }
+    const auto list_height = ImGui::GetTextLineHeightWithSpacing() * 6.0f;
+    if(ImGui::BeginChild("JointList", ImVec2{0.0f, list_height}, true)) {
+        ImGuiListClipper clipper{};
+        clipper.Begin(static_cast<int>(j_size));
+        while(clipper.Step()) {
+            for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                const auto index = static_cast<std::size_t>(i);
+                std::snprintf(label, sizeof(label), "Joint %zu", index);
+                if(ImGui::Selectable(label, index == _selected_joint)) {
+                    _selected_joint = index;
                 }
-                ImGui::TreePop();
             }
         }
+        clipper.End();
+    }
+    ImGui::EndChild();
+    if(_selected_joint >= j_size) {
+        return;
+    }
+    const auto& record = _scene.GetJointRecord(_selected_joint);
+    const auto is_intact = _scene.IsJointIntact(_selected_joint);
+    if(!is_intact) {
+        ImGui::Text("Detached");
+    }
+    for(std::size_t j = 0; j < 2; ++j) {
+        const auto body_index = j == 0 ? record.body_a : record.body_b;
+        ImGui::PushID(static_cast<int>(j));
+        if(ImGui::TreeNode(j == 0 ? "Body A" : "Body B")) {
+            if(is_intact && ImGui::Button("Detach")) {
+                SubmitEvent(g_theInputRecorder.Record(RecordedEventType::DetachJoint, Vector2::ZERO, static_cast<uint32_t>(_selected_joint), static_cast<uint32_t>(j)));
+            }
+            BodyInspector::ShowBodyParameters(_scene.GetBody(body_index));
+            ImGui::TreePop();
+        }
+        ImGui::PopID();
     }
 }
 
-void GameStateConstraints::Debug_ShowBodyParametersUI(const RigidBody* const body) {
-    const auto& acc = body->GetAcceleration();
-    const auto& vel = body->GetVelocity();
-    const auto& pos = body->GetPosition();
-    const auto aacc = body->GetAngularAccelerationDegrees();
-    const auto avel = body->GetAngularVelocityDegrees();
-    const auto apos = body->GetOrientationDegrees();
-    const auto mass = body->GetMass();
-    ImGui::Text("Awake: %s", (body->IsAwake() ? "true" : "false"));
-    ImGui::Text("M: %f", mass);
-    ImGui::Text("A: [%f, %f]", acc.x, acc.y);
-    ImGui::Text("V: [%f, %f]", vel.x, vel.y);
-    ImGui::Text("P: [%f, %f]", pos.x, pos.y);
-    ImGui::Text("oA: %f", aacc);
-    ImGui::Text("oV: %f", avel);
-    ImGui::Text("oP: %f", apos);
+void GameStateConstraints::Debug_ShowJointSolverUI() {
+    if(!ImGui::CollapsingHeader("Joint solver")) {
+        return;
+    }
+    ImGui::Checkbox("Parallel joint solver", &_use_parallel_joints);
+    if(_scene.GetJointSolver() == SceneJointSolver::Parallel) {
+        _joint_solver.SetDescription(_joint_solver_desc);
+        _joint_solver.ShowDebugUI();
+        _joint_solver_desc = _joint_solver.GetDescription();
+    } else {
+        ImGui::Text("The rod and cable are solved by the physics system.");
+    }
+    if(!CanRestartInPlace()) {
+        ImGui::Text("Restart Demo to switch joint solvers.");
+    }
 }
@@ -7,9 +7,12 @@
 
 #include "Engine/Renderer/Camera2D.hpp"
 
+#include "Game/BodyInspector.hpp"
+#include "Game/DebugDraw.hpp"
+#include "Game/GameGuid.hpp"
 #include "Game/IState.hpp"
-
-#include <guiddef.h>
+#include "Game/JointSolver.hpp"
+#include "Game/Scene.hpp"
 
 class GameStateConstraints : public IState {
 public:
@@ -24,6 +27,8 @@ public:
     GameStateConstraints& operator=(GameStateConstraints&& other) = default;
     virtual ~GameStateConstraints() = default;
 
+    void BeforeLoad() noexcept override;
+    void OnLoad(const LoadContext& context, LoadProgress& progress) noexcept override;
     void OnEnter() noexcept override;
     void OnExit() noexcept override;
 
@@ -32,10 +37,19 @@ public:
     void Render() const noexcept override;
     void EndFrame() noexcept override;
 
+    [[nodiscard]] Scene* GetScene() noexcept override;
+    [[nodiscard]] const ParallelJointSolver* GetJointSolver() const noexcept override;
+    [[nodiscard]] bool CanRestartInPlace() const noexcept override;
+    void ApplyRecordedEvent(const RecordedEvent& event) noexcept override;
+    void AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept override;
+    void OnRestart() noexcept override;
+
     void HandleInput() noexcept;
 
 protected:
 private:
+    [[nodiscard]] SceneDesc CreateDefaultScene(const IntVector2& world_dims) const noexcept;
+
     void HandleKeyboardInput() noexcept;
     void HandleMouseInput() noexcept;
 
@@ -49,15 +63,16 @@ private:
     void Debug_SelectedBodiesComboBoxUI();
     void Debug_ShowJointsUI();
     void Debug_ShowBodiesUI();
-    void Debug_ShowBodyParametersUI(const RigidBody* const body);
+    void Debug_ShowJointSolverUI();
 
-    std::vector<RigidBody> _bodies{};
-    std::vector<Joint*> _joints{};
+    Scene _scene{};
+    BodyInspector _inspector{};
+    ParallelJointSolver _joint_solver{};
     std::vector<Vector2> _new_body_positions{};
-    Vector2 _debug_point_on_body{};
+    //The point under the mouse relative to the selected body, so Render can place it on the body's snapshot.
+    Vector2 _debug_point_offset{};
     mutable Camera2D _ui_camera{};
-    RigidBody* _activeBody{};
-    Joint* _activeJoint{};
+    mutable DebugShapeBatch _debug_shapes{};
     bool _isGravityEnabled = true;
     bool _isDragEnabled = true;
     bool _debug_click_adds_bodies = false;
@@ -66,4 +81,12 @@ private:
     bool _show_collision = true;
     bool _show_joints = true;
     static inline std::size_t  _selected_body = 0u;
+    std::size_t _selected_joint = 0u;
+    //Solve the rod and cable with _joint_solver instead of the physics system. Takes effect on restart.
+    static inline bool _use_parallel_joints = false;
+    static inline JointSolverDesc _joint_solver_desc{};
+    //Load SceneFile::GetExportFilepath instead of the scene folder's file. Takes effect on restart.
+    static inline bool _load_exported_scene = false;
+    //_load_exported_scene as of BeforeLoad, since the UI may change it while OnLoad runs.
+    bool _loaded_exported_scene = false;
 };
@@ -17,22 +17,41 @@
 #include "Engine/UI/UISystem.hpp"
 
 #include "Game/Game.hpp"
-#include "Game/GameCommon.hpp"
 #include "Game/GameConfig.hpp"
+#include "Game/InputRecorder.hpp"
+#include "Game/SceneFile.hpp"
+
+void GameStateGravityDrag::BeforeLoad() noexcept {
+    _loaded_exported_scene = _load_exported_scene;
+}
+
+void GameStateGravityDrag::OnLoad(const LoadContext& context, LoadProgress& progress) noexcept {
+    if(!SceneFile::Build(_scene, SceneFile::GetLoadFilepath("GravityDrag", _loaded_exported_scene), &progress) || !_scene.GetBodyCount()) {
+        _scene.Build(CreateDefaultScene(context.world_dimensions).GetView(), &progress);
+    }
+}
 
 void GameStateGravityDrag::OnEnter() noexcept {
-    float width = static_cast<float>(g_theRenderer->GetOutput()->GetDimensions().x);
-    float height = static_cast<float>(g_theRenderer->GetOutput()->GetDimensions().y);
+    _scene.Register();
+    if(_selected_body >= _scene.GetBodyCount()) {
+        _selected_body = 0u;
+    }
+    g_thePhysicsSystem->Enable(true);
+    //Collision outlines are batched by the state; the engine only draws the partition and joints.
+    g_thePhysicsSystem->Debug_ShowCollision(false);
+}
+
+SceneDesc GameStateGravityDrag::CreateDefaultScene(const IntVector2& world_dims) const noexcept {
+    float width = static_cast<float>(world_dims.x);
+    float height = static_cast<float>(world_dims.y);
     const std::size_t maxBodies = 5;
-    _bodies.clear();
-    _bodies.reserve(maxBodies);
+    auto scene = SceneDesc{};
+    scene.bodies.reserve(maxBodies);
     float screenX = width * 0.50f;
     float screenY = height * 0.50f;
-    const auto world_dims = g_theRenderer->GetOutput()->GetDimensions();
     const auto mins = Vector2(-world_dims) * 0.5f;
     const auto maxs = Vector2(world_dims) * 0.5f;
-    auto physicsSystemDesc = PhysicsSystemDesc{};
-    physicsSystemDesc.world_bounds = AABB2{mins, maxs};
+    scene.physics.world_bounds = AABB2{mins, maxs};
     float radius = 25.0f;
     float x1 = screenX;
     float y1 = screenY;
@@ -44,75 +63,28 @@ void GameStateGravityDrag::OnEnter() noexcept {
     float y4 = y1;
     float x5 = x4 + 55.0f;
     float y5 = maxs.y + (radius * 4.0f);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x2, y2}
-                    , Velocity{}
-                    , Acceleration{}
-        , new ColliderCircle(Position{x2, y2}, radius)
-                    , PhysicsMaterial{0.0f, 0.0f}
-                    , PhysicsDesc{0.0f}
-                    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(false);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x1, y1}
-                    , Velocity{}
-                    , Acceleration{}
-                    , new ColliderCircle(Vector2(x1, y1), radius)
-                    ,PhysicsMaterial{0.0f, 0.0f}
-                    ,PhysicsDesc{}
-                    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(false);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x3, y3}
-                , Velocity{}
-                , Acceleration{}
-                , new ColliderCircle(Vector2(x3, y3), radius)
-                , PhysicsMaterial{0.0f, 0.0f}
-                , PhysicsDesc{}
-                )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(true);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x4, y4}
-                , Velocity{}
-                , Acceleration{}
-                ,new ColliderCircle(Vector2(x4, y4), radius)
-                , PhysicsMaterial{0.0f, 0.0f}
-                , PhysicsDesc{}
-                )));
-    _bodies.back().EnableGravity(true);
-    _bodies.back().EnableDrag(true);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x5, y5}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderAABB(Vector2(x5, y5), Vector2{5.0f * radius, 2.5f * radius})
-        , PhysicsMaterial{0.0f, 0.0f}
-        , PhysicsDesc{1.0f}
-    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(false);
-    std::vector<RigidBody*> body_ptrs(_bodies.size());
-    for(std::size_t i = 0u; i < _bodies.size(); ++i) {
-        body_ptrs[i] = &_bodies[i];
-    }
-    g_thePhysicsSystem->SetWorldDescription(physicsSystemDesc);
-    g_thePhysicsSystem->AddObjects(body_ptrs);
-    _activeBody = &_bodies[2];
-    if(_selected_body >= _bodies.size()) {
-        _selected_body = 0u;
-    }
-    g_thePhysicsSystem->Enable(true);
-    g_thePhysicsSystem->Debug_ShowCollision(true);
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x2, y2}, Vector2{radius, radius}, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{0.0f}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = false;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x1, y1}, Vector2{radius, radius}, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = false;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x3, y3}, Vector2{radius, radius}, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = true;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x4, y4}, Vector2{radius, radius}, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{}));
+    scene.bodies.back().gravity_enabled = true;
+    scene.bodies.back().drag_enabled = true;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::AABB, Position{x5, y5}, Vector2{5.0f * radius, 2.5f * radius}, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{1.0f}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = false;
+    return scene;
 }
 
 void GameStateGravityDrag::OnExit() noexcept {
-    g_thePhysicsSystem->RemoveAllObjectsImmediately();
+    _scene.Clear();
     g_thePhysicsSystem->Debug_ShowCollision(false);
     g_thePhysicsSystem->Enable(false);
-    _bodies.clear();
 }
 
 
@@ -126,7 +98,6 @@ void GameStateGravityDrag::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSec
         return;
     }
     g_thePhysicsSystem->Debug_ShowWorldPartition(_show_world_partition);
-    g_thePhysicsSystem->Debug_ShowCollision(_show_collision);
     g_theRenderer->UpdateGameTime(deltaSeconds);
     if(_show_debug_window) {
         ShowDebugWindow();
@@ -135,7 +106,8 @@ void GameStateGravityDrag::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSec
     Camera2D& base_camera = _ui_camera;
     base_camera.Update(deltaSeconds);
 
-    _debug_point_on_body = MathUtils::CalcClosestPoint(g_theInputSystem->GetMouseCoords(), *_activeBody->GetCollider());
+    const auto& selected_body = _scene.GetBody(_selected_body);
+    _debug_point_offset = MathUtils::CalcClosestPoint(g_theInputSystem->GetMouseCoords(), *selected_body.GetCollider()) - selected_body.GetPosition();
     HandleInput();
 
 }
@@ -153,34 +125,41 @@ void GameStateGravityDrag::Render() const noexcept {
     g_theRenderer->SetMaterial(g_theRenderer->GetMaterial("__2D"));
     g_theRenderer->DrawAxes(static_cast<float>((std::max)(ui_view_extents.x, ui_view_extents.y)), false);
 
-    if(!_debug_click_adds_bodies) {
-        g_theRenderer->DrawFilledCircle2D(_debug_point_on_body, 5.0f);
+    const auto& snapshot = _scene.GetRenderSnapshot();
+    if(_show_collision) {
+        _debug_shapes.Begin(AABB2{_ui_camera.position - ui_view_half_extents, _ui_camera.position + ui_view_half_extents});
+        _debug_shapes.AddSnapshot(snapshot);
+        auto sink = RendererDebugDrawSink{};
+        _debug_shapes.Submit(sink);
     }
+
+    if(!_debug_click_adds_bodies && _selected_body < snapshot.bodies.size()) {
+        //Follow the interpolated body rather than its latest simulated position.
+        g_theRenderer->DrawFilledCircle2D(snapshot.CalcRenderPosition(_selected_body) + _debug_point_offset, 5.0f);
+    }
+}
+
+Scene* GameStateGravityDrag::GetScene() noexcept {
+    return &_scene;
+}
+
+bool GameStateGravityDrag::CanRestartInPlace() const noexcept {
+    //Switching scene files needs a reload.
+    return _loaded_exported_scene == _load_exported_scene;
 }
 
 void GameStateGravityDrag::EndFrame() noexcept {
     if(_new_body_positions.empty()) {
         return;
     }
+    std::vector<SceneBodyRecord> new_bodies{};
+    new_bodies.reserve(_new_body_positions.size());
     for(const auto& pos : _new_body_positions) {
-        _bodies.push_back(RigidBody(RigidBodyDesc(
-            pos
-            , Vector2::ZERO
-            , Vector2::ZERO
-            , new ColliderOBB(pos, Vector2{25.0f,25.0f})
-            , PhysicsMaterial{}
-            , PhysicsDesc{}
-        )));
+        new_bodies.push_back(MakeBodyRecord(SceneColliderType::OBB, pos, Vector2{25.0f, 25.0f}));
     }
-    const auto new_size = _bodies.size();
-    auto new_body_ptrs = std::vector<RigidBody*>(new_size);
-    for(auto i = std::size_t{0u}; i < new_size; ++i) {
-        new_body_ptrs[i] = &_bodies[i];
-    }
-    _activeBody = &_bodies[2];
-    g_thePhysicsSystem->RemoveAllObjectsImmediately();
-    g_thePhysicsSystem->AddObjects(new_body_ptrs);
+    _scene.AddBodies(new_bodies.data(), new_bodies.size());
     _new_body_positions.clear();
+    _is_query_current = false;
 }
 
 void GameStateGravityDrag::HandleInput() noexcept {
@@ -214,26 +193,77 @@ void GameStateGravityDrag::Debug_AddBodyOrApplyForceAtMouseCoords() noexcept {
             Debug_AddBodyAtMouseCoords();
         }
     } else {
-        if(g_theInputSystem->IsKeyDown(KeyCode::LButton)) {
+        if(g_theInputSystem->WasKeyJustPressed(KeyCode::LButton)) {
+            _press_selected_body = Debug_SelectBodyAtMouseCoords();
+        }
+        if(g_theInputSystem->IsKeyDown(KeyCode::LButton) && !_press_selected_body) {
             Debug_ApplyImpulseAtMouseCoords();
         }
     }
 }
 
 void GameStateGravityDrag::Debug_AddBodyAtMouseCoords() noexcept {
-    const auto& p = g_theInputSystem->GetMouseCoords();
-    _new_body_positions.push_back(p);
+    SubmitEvent(g_theInputRecorder.Record(RecordedEventType::AddBody, g_theInputSystem->GetMouseCoords()));
 }
 
 void GameStateGravityDrag::Debug_ApplyImpulseAtMouseCoords() noexcept {
-    const auto& p = g_theInputSystem->GetMouseCoords();
-    const auto point_on_body = MathUtils::CalcClosestPoint(p, *_activeBody->GetCollider());
-    const auto direction = (point_on_body - p).GetNormalize();
-    _activeBody->ApplyImpulse(direction * 150.0f);
+    SubmitEvent(g_theInputRecorder.Record(RecordedEventType::ApplyImpulse, g_theInputSystem->GetMouseCoords(), static_cast<uint32_t>(_selected_body)));
+}
+
+bool GameStateGravityDrag::Debug_SelectBodyAtMouseCoords() noexcept {
+    //Selection only changes which body later impulses push, so it is not recorded.
+    if(!_is_query_current) {
+        _query.Rebuild(_scene);
+        _is_query_current = true;
+    }
+    const auto hit = _query.PickPoint(g_theInputSystem->GetMouseCoords());
+    if(!hit.hit) {
+        return false;
+    }
+    _selected_body = hit.body;
+    return true;
+}
+
+void GameStateGravityDrag::AfterPhysicsStep([[maybe_unused]] TimeUtils::FPSeconds timestep) noexcept {
+    _is_query_current = false;
+}
+
+void GameStateGravityDrag::OnRestart() noexcept {
+    _is_query_current = false;
+    //The restore drops bodies added by clicks.
+    if(_selected_body >= _scene.GetBodyCount()) {
+        _selected_body = 0u;
+    }
+}
+
+void GameStateGravityDrag::ApplyRecordedEvent(const RecordedEvent& event) noexcept {
+    switch(event.type) {
+    case RecordedEventType::ApplyImpulse:
+    {
+        if(event.index >= _scene.GetBodyCount()) {
+            break;
+        }
+        auto& body = _scene.GetBody(event.index);
+        const auto point_on_body = MathUtils::CalcClosestPoint(event.point, *body.GetCollider());
+        const auto direction = (point_on_body - event.point).GetNormalize();
+        body.ApplyImpulse(direction * 150.0f);
+        break;
+    }
+    case RecordedEventType::AddBody:
+        _new_body_positions.push_back(event.point);
+        break;
+    default:
+        /* DO NOTHING */
+        break;
+    }
 }
 
 void GameStateGravityDrag::ShowDebugWindow() {
     if(ImGui::Begin("Debug Window", &_show_debug_window)) {
+        if(ImGui::Button("Export scene")) {
+            [[maybe_unused]] const auto saved = SceneFile::Save(SceneFile::GetExportFilepath("GravityDrag"), _scene.Export().GetView());
+        }
+        ImGui::Checkbox("Load exported scene", &_load_exported_scene);
         ImGui::Checkbox("Click adds bodies", &_debug_click_adds_bodies);
         ImGui::Checkbox("Show Quadtree", &_show_world_partition);
         ImGui::Checkbox("Show Collision", &_show_collision);
@@ -244,57 +274,9 @@ void GameStateGravityDrag::ShowDebugWindow() {
 }
 
 void GameStateGravityDrag::Debug_SelectedBodiesComboBoxUI() {
-    const auto b_size = _bodies.size();
-    std::vector<std::string> items{};
-    items.resize(b_size);
-    for(std::size_t i = 0u; i < b_size; ++i) {
-        items[i] = std::string{"Body "} + std::to_string(i);
-    }
-    std::string current_item = items[_selected_body];
-    if(ImGui::BeginCombo("Selected Body", current_item.c_str())) {
-        for(auto it = std::cbegin(items); it != std::cend(items); ++it) {
-            bool is_selected = current_item == *it;
-            if(ImGui::Selectable((*it).c_str(), is_selected)) {
-                current_item = *it;
-                _selected_body = std::distance(std::cbegin(items), it);
-            }
-            if(is_selected) {
-                ImGui::SetItemDefaultFocus();
-            }
-        }
-        ImGui::EndCombo();
-    }
-    _activeBody = &_bodies[_selected_body];
+    _inspector.ShowSelectionCombo(_scene, _selected_body);
 }
 
 void GameStateGravityDrag::Debug_ShowBodiesUI() {
-    const auto b_size = _bodies.size();
-    std::string header = std::string{"Bodies - "} + std::to_string(b_size);
-    if(ImGui::CollapsingHeader(header.c_str())) {
-        for(std::size_t i = 0; i < b_size; ++i) {
-            const auto* body = &_bodies[i];
-            if(ImGui::TreeNode(reinterpret_cast<void*>(static_cast<std::intptr_t>(i)), "Body %d", i)) {
-                Debug_ShowBodyParametersUI(body);
-                ImGui::TreePop();
-            }
-        }
-    }
-}
-
-void GameStateGravityDrag::Debug_ShowBodyParametersUI(const RigidBody* const body) {
-    const auto& acc = body->GetAcceleration();
-    const auto& vel = body->GetVelocity();
-    const auto& pos = body->GetPosition();
-    const auto aacc = body->GetAngularAccelerationDegrees();
-    const auto avel = body->GetAngularVelocityDegrees();
-    const auto apos = body->GetOrientationDegrees();
-    const auto mass = body->GetMass();
-    ImGui::Text("Awake: %s", (body->IsAwake() ? "true" : "false"));
-    ImGui::Text("M: %f", mass);
-    ImGui::Text("A: [%f, %f]", acc.x, acc.y);
-    ImGui::Text("V: [%f, %f]", vel.x, vel.y);
-    ImGui::Text("P: [%f, %f]", pos.x, pos.y);
-    ImGui::Text("oA: %f", aacc);
-    ImGui::Text("oV: %f", avel);
-    ImGui::Text("oP: %f", apos);
+    _inspector.ShowBodyList(_scene, _selected_body);
 }
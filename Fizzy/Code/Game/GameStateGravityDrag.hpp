@@ -8,9 +8,12 @@
 #include "Engine/Renderer/Camera2D.hpp"
 #include "Engine/Renderer/Mesh.hpp"
 
+#include "Game/BodyInspector.hpp"
+#include "Game/DebugDraw.hpp"
+#include "Game/GameGuid.hpp"
 #include "Game/IState.hpp"
-
-#include <guiddef.h>
+#include "Game/Scene.hpp"
+#include "Game/SceneQuery.hpp"
 
 class GameStateGravityDrag : public IState {
 public:
@@ -19,12 +22,15 @@ public:
     static inline constexpr GUID ID = {0x4a8529ab, 0xcce, 0x44a4, { 0xb0, 0x39, 0x6a, 0xde, 0xb8, 0xd2, 0x70, 0xe0 }};
 
     GameStateGravityDrag() = default;
-    GameStateGravityDrag(const GameStateGravityDrag& other) = default;
-    GameStateGravityDrag(GameStateGravityDrag&& other) = default;
-    GameStateGravityDrag& operator=(const GameStateGravityDrag& other) = default;
-    GameStateGravityDrag& operator=(GameStateGravityDrag&& other) = default;
+    //The scene and its query are not copyable.
+    GameStateGravityDrag(const GameStateGravityDrag& other) = delete;
+    GameStateGravityDrag(GameStateGravityDrag&& other) = delete;
+    GameStateGravityDrag& operator=(const GameStateGravityDrag& other) = delete;
+    GameStateGravityDrag& operator=(GameStateGravityDrag&& other) = delete;
     virtual ~GameStateGravityDrag() = default;
 
+    void BeforeLoad() noexcept override;
+    void OnLoad(const LoadContext& context, LoadProgress& progress) noexcept override;
     void OnEnter() noexcept override;
     void OnExit() noexcept override;
 
@@ -33,10 +39,19 @@ public:
     void Render() const noexcept override;
     void EndFrame() noexcept override;
 
+    [[nodiscard]] Scene* GetScene() noexcept override;
+    [[nodiscard]] bool CanRestartInPlace() const noexcept override;
+    void ApplyRecordedEvent(const RecordedEvent& event) noexcept override;
+    //Marks the pick query stale; the next click rebuilds it.
+    void AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept override;
+    void OnRestart() noexcept override;
+
     void HandleInput() noexcept;
 
 protected:
 private:
+    [[nodiscard]] SceneDesc CreateDefaultScene(const IntVector2& world_dims) const noexcept;
+
     void HandleKeyboardInput() noexcept;
     void HandleMouseInput() noexcept;
 
@@ -46,20 +61,31 @@ private:
     void Debug_AddBodyOrApplyForceAtMouseCoords() noexcept;
     void Debug_AddBodyAtMouseCoords() noexcept;
     void Debug_ApplyImpulseAtMouseCoords() noexcept;
+    [[nodiscard]] bool Debug_SelectBodyAtMouseCoords() noexcept;
     
     void Debug_ShowBodiesUI();
-    void Debug_ShowBodyParametersUI(const RigidBody* const body);
     void Debug_SelectedBodiesComboBoxUI();
 
-    std::vector<RigidBody> _bodies{};
+    Scene _scene{};
+    BodyInspector _inspector{};
+    SceneQuery _query{};
+    //False once a step or new bodies moved things since _query was rebuilt.
+    bool _is_query_current = false;
     std::vector<Vector2> _new_body_positions{};
-    Vector2 _debug_point_on_body{};
+    //The point under the mouse relative to the selected body, so Render can place it on the body's snapshot.
+    Vector2 _debug_point_offset{};
     static inline std::size_t _selected_body{0u};
+    //Load SceneFile::GetExportFilepath instead of the scene folder's file. Takes effect on restart.
+    static inline bool _load_exported_scene = false;
+    //_load_exported_scene as of BeforeLoad, since the UI may change it while OnLoad runs.
+    bool _loaded_exported_scene = false;
     mutable Camera2D _ui_camera{};
-    RigidBody* _activeBody{};
+    mutable DebugShapeBatch _debug_shapes{};
     bool _isGravityEnabled = true;
     bool _isDragEnabled = true;
     bool _debug_click_adds_bodies = false;
+    //The current mouse press selected a body, so it does not push it.
+    bool _press_selected_body = false;
     bool _show_debug_window = true;
     bool _show_world_partition = true;
     bool _show_collision = true;
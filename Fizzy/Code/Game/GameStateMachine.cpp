@@ -1,9 +1,39 @@
 #include "Game/GameStateMachine.hpp"
 
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
+#include "Engine/Physics/PhysicsSystem.hpp"
+
+#include "Game/FrameProfiler.hpp"
+#include "Game/GameCommon.hpp"
 #include "Game/GameStateGravityDrag.hpp"
 #include "Game/GameStateRestartCurrentState.hpp"
+#include "Game/InputRecorder.hpp"
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+void PublishRenderSnapshot(IState& state) noexcept {
+    if(auto* scene = state.GetScene(); scene) {
+        auto& snapshot = scene->BeginRenderSnapshot();
+        state.AddRenderOverlay(snapshot.overlay);
+        scene->PublishRenderSnapshot();
+    }
+}
+
+void AcquireRenderSnapshot(IState& state) noexcept {
+    if(auto* scene = state.GetScene(); scene) {
+        scene->AcquireRenderSnapshot();
+    }
+}
+
+} // namespace
 
 bool GameStateMachine::HasStateChanged() const noexcept {
     return !IsEqualGUID(_currentStateId, _nextStateId);
@@ -21,15 +51,23 @@ void GameStateMachine::ChangeState(const GUID& newStateId) noexcept {
 }
 
 void GameStateMachine::RestartState() noexcept {
-    ChangeState(GameStateRestartCurrentState::ID);
+    _restart_requested = true;
 }
 
-void GameStateMachine::OnEnterState(const GUID& enteringStateId) noexcept {
-    if(_state = CreateStateFromId(enteringStateId); _state != nullptr) {
-        _state->OnEnter();
-    } else {
-        ERROR_AND_DIE("GameStateMachine::OnEnterState: CreateStateFromId returned an invalid object.");
+bool GameStateMachine::RestartInPlace() noexcept {
+    //A pending change or load wins over restoring the state it replaces.
+    if(!_state || _loading_state || HasStateChanged() || !_state->CanRestartInPlace()) {
+        return false;
+    }
+    auto* scene = _state->GetScene();
+    if(!scene || !scene->RestoreSnapshot()) {
+        return false;
     }
+    _state->OnRestart();
+    PublishRenderSnapshot(*_state);
+    _accumulator = TimeUtils::FPSeconds{};
+    g_theInputRecorder.Stop();
+    return true;
 }
 
 std::unique_ptr<IState> GameStateMachine::CreateStateFromId(const GUID& id) noexcept {
@@ -42,6 +80,8 @@ std::unique_ptr<IState> GameStateMachine::CreateStateFromId(const GUID& id) noex
         return std::make_unique<GameStateConstraints>();
     } else if(IsEqualGUID(id, GameStateSleepManagement::ID)) {
         return std::make_unique<GameStateSleepManagement>();
+    } else if(IsEqualGUID(id, GameStateStress::ID)) {
+        return std::make_unique<GameStateStress>();
     }
     return {};
 }
@@ -54,23 +94,317 @@ void GameStateMachine::OnExitState() noexcept {
 }
 
 void GameStateMachine::BeginFrame() noexcept {
-    if(HasStateChanged()) {
-        OnExitState();
-        OnEnterState(_nextStateId);
-        _currentStateId = _nextStateId;
+    PROFILE_BEGIN_FRAME();
+    PROFILE_STAGE(ProfileStage::StateBeginFrame);
+    if(_restart_requested) {
+        _restart_requested = false;
+        if(!RestartInPlace()) {
+            ChangeState(GameStateRestartCurrentState::ID);
+        }
+    }
+    if(!_loading_state && HasStateChanged()) {
+        BeginLoadingState();
+    }
+    if(_loading_state && IsLoadFinished()) {
+        FinishLoadingState();
+    }
+    if(_state) {
+        _state->BeginFrame();
     }
-    _state->BeginFrame();
+}
+
+void GameStateMachine::BeginLoadingState() noexcept {
+    if(_loading_state = CreateStateFromId(_nextStateId); _loading_state == nullptr) {
+        ERROR_AND_DIE("GameStateMachine::BeginLoadingState: CreateStateFromId returned an invalid object.");
+    }
+    //Read after CreateStateFromId, which turns a restart into the current state's id.
+    _loading_state_id = _nextStateId;
+    _load_progress.fraction.store(0.0f, std::memory_order_relaxed);
+    //Everything the load reads from the renderer or the UI is copied here, on the frame thread.
+    const auto context = LoadContext{GetWorldDimensions()};
+    _loading_state->BeforeLoad();
+    if(!_state || !_async_loading) {
+        _loading_state->OnLoad(context, _load_progress);
+        return;
+    }
+    _load_future = std::async(std::launch::async, [state = _loading_state.get(), context, progress = &_load_progress]() {
+        state->OnLoad(context, *progress);
+    });
+}
+
+bool GameStateMachine::IsLoadFinished() const noexcept {
+    return !_load_future.valid() || _load_future.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+void GameStateMachine::FinishLoadingState() noexcept {
+    if(_load_future.valid()) {
+        _load_future.get();
+    }
+    //A state change requested during the load makes it stale; the next frame starts the newer one.
+    if(!IsEqualGUID(_loading_state_id, _nextStateId)) {
+        _loading_state.reset(nullptr);
+        return;
+    }
+    OnExitState();
+    _state = std::move(_loading_state);
+    _state->OnEnter();
+    if(_fixed_timestep.enabled) {
+        //States enable physics on enter; in fixed-step mode only StepFixed may step it.
+        g_thePhysicsSystem->Enable(false);
+    }
+    if(auto* scene = _state->GetScene(); scene) {
+        scene->CaptureSnapshot();
+    }
+    //So a threaded first frame has something to draw before its steps finish.
+    PublishRenderSnapshot(*_state);
+    _currentStateId = _loading_state_id;
+    _accumulator = TimeUtils::FPSeconds{};
+    g_theInputRecorder.Stop();
+    if(_recording_requested) {
+        _recording_requested = false;
+        g_theInputRecorder.Begin(_currentStateId, _fixed_timestep.step);
+    }
+}
+
+void GameStateMachine::StartRecording() noexcept {
+    if(!_fixed_timestep.enabled) {
+        auto desc = _fixed_timestep;
+        desc.enabled = true;
+        SetFixedTimestep(desc);
+    }
+    _recording_requested = true;
+    ChangeState(GameStateRestartCurrentState::ID);
+}
+
+void GameStateMachine::StopRecording() noexcept {
+    _recording_requested = false;
+    g_theInputRecorder.Stop();
+}
+
+void GameStateMachine::ApplyRecordedEvent(const RecordedEvent& event) noexcept {
+    if(_state) {
+        _state->ApplyRecordedEvent(event);
+    }
+}
+
+void GameStateMachine::SetAsyncLoading(bool async) noexcept {
+    _async_loading = async;
+}
+
+bool GameStateMachine::IsLoading() const noexcept {
+    return _loading_state != nullptr;
+}
+
+float GameStateMachine::GetLoadProgress() const noexcept {
+    return _load_progress.fraction.load(std::memory_order_relaxed);
 }
 
 void GameStateMachine::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept {
-    _state->Update(deltaSeconds);
+    const auto is_threaded = IsSimulationThreaded();
+    {
+        PROFILE_STAGE(ProfileStage::StateUpdate);
+        if(!_state) {
+            return;
+        }
+        _state->SetEventQueue(is_threaded ? &_queued_events : nullptr);
+        _state->Update(deltaSeconds);
+    }
+    if(is_threaded) {
+        _pending_seconds = deltaSeconds;
+        _is_simulation_pending = true;
+    } else if(_fixed_timestep.enabled) {
+        StepFixed(deltaSeconds);
+    } else {
+        AfterPhysicsStep(deltaSeconds);
+    }
+}
+
+void GameStateMachine::BeginSimulation() noexcept {
+    if(!_state) {
+        return;
+    }
+    //Decided in Update, so a setting changed after it neither skips nor repeats this frame's steps.
+    const auto is_pending = std::exchange(_is_simulation_pending, false);
+    if(!is_pending || !IsSimulationThreaded()) {
+        //With fixed steps turned off after Update, the engine steps the events' effects.
+        ApplyQueuedEvents();
+        if(is_pending && _fixed_timestep.enabled) {
+            StepFixed(_pending_seconds);
+        }
+        //Render draws the scene as this frame's update left it.
+        PublishRenderSnapshot(*_state);
+        AcquireRenderSnapshot(*_state);
+        return;
+    }
+    //Render draws the previous batch while this one runs.
+    AcquireRenderSnapshot(*_state);
+    ApplyQueuedEvents();
+    const auto substeps = AdvanceAccumulator(_pending_seconds);
+    if(!_simulation_thread) {
+        _simulation_thread = std::make_unique<SimulationThread>();
+    }
+    _simulation_job = [this, substeps]() {
+#if !defined(FINAL_BUILD)
+        const ProfileDeferScope defer_samples{_simulation_samples};
+#endif
+        RunFixedSteps(substeps);
+        PublishRenderSnapshot(*_state);
+    };
+}
+
+bool GameStateMachine::IsSimulationThreaded() const noexcept {
+    return _fixed_timestep.enabled && _fixed_timestep.threaded;
+}
+
+void GameStateMachine::ApplyQueuedEvents() noexcept {
+    for(const auto& event : _queued_events) {
+        _state->ApplyRecordedEvent(event);
+    }
+    _queued_events.clear();
+}
+
+bool GameStateMachine::StartSimulation() const noexcept {
+    if(!_simulation_job) {
+        return false;
+    }
+    _simulation_thread->Start(std::exchange(_simulation_job, SimulationThread::Job{}));
+    return true;
+}
+
+void GameStateMachine::WaitForSimulation() const noexcept {
+    [[maybe_unused]] const auto milliseconds = _simulation_thread->Wait();
+#if !defined(FINAL_BUILD)
+    //The profiler belongs to the frame thread, so the steps are timed on their own and added here.
+    g_theFrameProfiler.AddSample(ProfileStage::Physics, milliseconds);
+    g_theFrameProfiler.AddSamples(_simulation_samples);
+    _simulation_samples.fill(0.0f);
+#endif
+}
+
+void GameStateMachine::AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept {
+    if(_state) {
+        if(auto* scene = _state->GetScene(); scene) {
+            scene->InvalidateBroadphase();
+        }
+        _state->AfterPhysicsStep(timestep);
+    }
+}
+
+void GameStateMachine::StepFixed(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    PROFILE_STAGE(ProfileStage::Physics);
+    RunFixedSteps(AdvanceAccumulator(deltaSeconds));
+}
+
+int GameStateMachine::AdvanceAccumulator(TimeUtils::FPSeconds deltaSeconds) noexcept {
+    const auto step = _fixed_timestep.step;
+    _accumulator += deltaSeconds;
+    _last_substep_count = 0;
+    while(_accumulator >= step && _last_substep_count < _fixed_timestep.max_substeps) {
+        _accumulator -= step;
+        ++_last_substep_count;
+    }
+    if(_accumulator >= step) {
+        _accumulator = TimeUtils::FPSeconds{std::fmod(_accumulator.count(), step.count())};
+    }
+    return _last_substep_count;
+}
+
+void GameStateMachine::RunFixedSteps(int substeps) noexcept {
+    auto* scene = _state->GetScene();
+    const auto step = _fixed_timestep.step;
+    g_thePhysicsSystem->Enable(true);
+    for(int i = 0; i < substeps; ++i) {
+        if(scene) {
+            scene->StorePreviousTransforms();
+        }
+        g_thePhysicsSystem->BeginFrame();
+        g_thePhysicsSystem->Update(step);
+        g_thePhysicsSystem->EndFrame();
+        AfterPhysicsStep(step);
+    }
+    g_thePhysicsSystem->Enable(false);
+    if(scene) {
+        scene->SetInterpolationAlpha(_accumulator / step);
+    }
+}
+
+void GameStateMachine::SetFixedTimestep(const FixedTimestepDesc& desc) noexcept {
+    const auto was_enabled = _fixed_timestep.enabled;
+    const auto previous_step = _fixed_timestep.step;
+    _fixed_timestep = desc;
+    _fixed_timestep.max_substeps = (std::max)(_fixed_timestep.max_substeps, 1);
+    if(_fixed_timestep.step <= TimeUtils::FPSeconds{}) {
+        _fixed_timestep.step = FixedTimestepDesc{}.step;
+    }
+    //A recording replays at a single rate.
+    if(_fixed_timestep.step != previous_step) {
+        StopRecording();
+    }
+    if(was_enabled && !_fixed_timestep.enabled) {
+        StopRecording();
+        //Hand stepping back to the engine.
+        _accumulator = TimeUtils::FPSeconds{};
+        _last_substep_count = 0;
+        g_thePhysicsSystem->Enable(true);
+        if(auto* scene = _state ? _state->GetScene() : nullptr; scene) {
+            scene->SetInterpolationAlpha(1.0f);
+        }
+    }
+}
+
+const FixedTimestepDesc& GameStateMachine::GetFixedTimestep() const noexcept {
+    return _fixed_timestep;
+}
+
+int GameStateMachine::GetLastSubstepCount() const noexcept {
+    return _last_substep_count;
+}
+
+Scene* GameStateMachine::GetCurrentScene() noexcept {
+    return _state ? _state->GetScene() : nullptr;
+}
+
+const ParallelJointSolver* GameStateMachine::GetCurrentJointSolver() const noexcept {
+    return _state ? _state->GetJointSolver() : nullptr;
+}
+
+const ContactCache* GameStateMachine::GetCurrentContactCache() const noexcept {
+    return _state ? _state->GetContactCache() : nullptr;
+}
+
+const ContactSolver* GameStateMachine::GetCurrentContactSolver() const noexcept {
+    return _state ? _state->GetContactSolver() : nullptr;
 }
 
 void GameStateMachine::Render() const noexcept {
-    _state->Render();
+    //The steps run only while the state draws the previous snapshot and are
+    //joined before Render returns, so nothing else in the frame, the engine's
+    //own calls into the physics system included, can meet them.
+    const auto is_simulating = StartSimulation();
+    {
+        PROFILE_STAGE(ProfileStage::StateRender);
+        if(_state) {
+            _state->Render();
+        }
+    }
+    if(is_simulating) {
+        WaitForSimulation();
+    }
 }
 
 void GameStateMachine::EndFrame() noexcept {
-    _state->EndFrame();
+    PROFILE_STAGE(ProfileStage::StateEndFrame);
+    //A frame that was not rendered still takes its steps.
+    if(_simulation_job) {
+        PROFILE_STAGE(ProfileStage::Physics);
+        std::exchange(_simulation_job, SimulationThread::Job{})();
+    }
+    if(_state) {
+        _state->EndFrame();
+    }
+    if(g_theInputRecorder.IsRecording()) {
+        const auto* scene = GetCurrentScene();
+        g_theInputRecorder.EndFrame(_last_substep_count, scene ? scene->CalcStateHash() : 0u);
+    }
 }
 
@@ -2,15 +2,32 @@
 
 #include "Engine/Core/TimeUtils.hpp"
 
+#include "Game/FrameProfiler.hpp"
+#include "Game/GameGuid.hpp"
 #include "Game/IState.hpp"
 #include "Game/GameStateGravityDrag.hpp"
 #include "Game/GameStateConstraints.hpp"
 #include "Game/GameStateSleepManagement.hpp"
+#include "Game/GameStateStress.hpp"
+#include "Game/InputRecorder.hpp"
+#include "Game/SimulationThread.hpp"
 
 #include <cstdint>
+#include <future>
 #include <memory>
+#include <vector>
 
-#include <guiddef.h>
+struct FixedTimestepDesc {
+    bool enabled = false;
+    TimeUtils::FPSeconds step = TimeUtils::FPSeconds{1.0f / 60.0f};
+    //Most steps taken in one frame. Time beyond that is dropped so a slow
+    //frame cannot queue ever more steps behind it.
+    int max_substeps = 5;
+    //Runs each frame's steps, engine step and game-side passes included, on
+    //a simulation thread while the state renders. Render draws the previous
+    //frame's snapshot, a frame behind.
+    bool threaded = false;
+};
 
 class GameStateMachine {
 public:
@@ -23,6 +40,9 @@ public:
     ~GameStateMachine() = default;
 
     void ChangeState(const GUID& newStateId) noexcept;
+    //Restores the current state's scene from the snapshot taken after it was
+    //entered, at the start of the next frame. States without a scene, or whose
+    //snapshot no longer fits, are rebuilt instead.
     void RestartState() noexcept;
 
     void BeginFrame() noexcept;
@@ -30,15 +50,96 @@ public:
     void Render() const noexcept;
     void EndFrame() noexcept;
 
+    //In fixed-step mode the state machine steps the physics system itself after
+    //the state's Update and leaves it disabled between frames, so the engine
+    //does not also step it at the variable frame rate.
+    void SetFixedTimestep(const FixedTimestepDesc& desc) noexcept;
+    [[nodiscard]] const FixedTimestepDesc& GetFixedTimestep() const noexcept;
+    [[nodiscard]] int GetLastSubstepCount() const noexcept;
+    //Publishes the scene's render snapshot for Render. In threaded mode it
+    //instead queues the frame's fixed steps, engine step and game-side passes
+    //included, for Render to run on the simulation thread while the state
+    //draws the previous snapshot; Render joins them before it returns. Call it
+    //once everything in the frame's update that may touch the scene, the
+    //physics system, the job system or these settings is done. State Render
+    //must use none of them.
+    void BeginSimulation() noexcept;
+    //Lets the current state react to a physics step. Fixed-step mode and
+    //variable-step Update call it; drivers that step the physics system
+    //themselves must call it after each step.
+    void AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept;
+
+    //The current state's scene, or nullptr if it has none.
+    [[nodiscard]] Scene* GetCurrentScene() noexcept;
+    //The current state's parallel joint solver, or nullptr if it has none.
+    [[nodiscard]] const ParallelJointSolver* GetCurrentJointSolver() const noexcept;
+    //The current state's contact cache while it runs, or nullptr.
+    [[nodiscard]] const ContactCache* GetCurrentContactCache() const noexcept;
+    //The current state's contact solver while it is solving, or nullptr.
+    [[nodiscard]] const ContactSolver* GetCurrentContactSolver() const noexcept;
+
+    //A new state's OnLoad runs on a loading thread while the current state
+    //keeps running. It is swapped in at the start of the first frame after
+    //the load finishes. With no current state, or with async loading off,
+    //the load runs on the frame thread instead.
+    void SetAsyncLoading(bool async) noexcept;
+
+    //Rebuilds the current state and records it from its first frame into
+    //g_theInputRecorder. Turns on fixed-step mode, since a replay must take the
+    //same steps. Changing or restarting the state, or leaving fixed-step mode,
+    //stops the recording.
+    void StartRecording() noexcept;
+    void StopRecording() noexcept;
+    //Forwards a recorded event to the current state, for replays.
+    void ApplyRecordedEvent(const RecordedEvent& event) noexcept;
+    [[nodiscard]] bool IsLoading() const noexcept;
+    [[nodiscard]] float GetLoadProgress() const noexcept;
+
 protected:
 private:
     bool HasStateChanged() const noexcept;
     void OnExitState() noexcept;
-    void OnEnterState(const GUID& enteringStateId) noexcept;
+    void BeginLoadingState() noexcept;
+    [[nodiscard]] bool IsLoadFinished() const noexcept;
+    void FinishLoadingState() noexcept;
+    [[nodiscard]] bool RestartInPlace() noexcept;
 
     std::unique_ptr<IState> CreateStateFromId(const GUID& id) noexcept;
 
+    void StepFixed(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    //Takes the frame's time out of the accumulator and returns how many steps it covers.
+    [[nodiscard]] int AdvanceAccumulator(TimeUtils::FPSeconds deltaSeconds) noexcept;
+    void RunFixedSteps(int substeps) noexcept;
+    void ApplyQueuedEvents() noexcept;
+    [[nodiscard]] bool IsSimulationThreaded() const noexcept;
+    //Runs the queued steps on the simulation thread, or returns false if none are queued.
+    [[nodiscard]] bool StartSimulation() const noexcept;
+    void WaitForSimulation() const noexcept;
+
     GUID _currentStateId{};
     GUID _nextStateId{};
     std::unique_ptr<IState> _state{};
+    std::unique_ptr<IState> _loading_state{};
+    GUID _loading_state_id{};
+    LoadProgress _load_progress{};
+    std::future<void> _load_future{};
+    bool _async_loading = true;
+    bool _restart_requested = false;
+    bool _recording_requested = false;
+    FixedTimestepDesc _fixed_timestep{};
+    TimeUtils::FPSeconds _accumulator{};
+    int _last_substep_count{};
+    //Live input queued by the state during Update for the simulation thread.
+    std::vector<RecordedEvent> _queued_events{};
+    TimeUtils::FPSeconds _pending_seconds{};
+    bool _is_simulation_pending = false;
+    //The frame's steps, queued by BeginSimulation. Render runs them, so it
+    //is the only part of the frame the simulation thread overlaps.
+    mutable SimulationThread::Job _simulation_job{};
+#if !defined(FINAL_BUILD)
+    //Stage timings of the steps on the simulation thread, added once they are joined.
+    mutable FrameProfiler::FrameSamples _simulation_samples{};
+#endif
+    //Last, so it stops before the state it steps is destroyed.
+    std::unique_ptr<SimulationThread> _simulation_thread{};
 };
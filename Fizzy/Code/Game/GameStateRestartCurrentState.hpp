@@ -1,9 +1,8 @@
 #pragma once
 
+#include "Game/GameGuid.hpp"
 #include "Game/IState.hpp"
 
-#include <guiddef.h>
-
 class GameStateRestartCurrentState : public IState {
 public:
 
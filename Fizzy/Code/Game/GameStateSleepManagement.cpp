@@ -7,22 +7,44 @@
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/UI/UISystem.hpp"
 
+#include "Game/FrameProfiler.hpp"
 #include "Game/Game.hpp"
+#include "Game/GameCommon.hpp"
 #include "Game/GameConfig.hpp"
+#include "Game/InputRecorder.hpp"
+#include "Game/SceneFile.hpp"
+
+void GameStateSleepManagement::BeforeLoad() noexcept {
+    _loaded_exported_scene = _load_exported_scene;
+}
+
+void GameStateSleepManagement::OnLoad(const LoadContext& context, LoadProgress& progress) noexcept {
+    if(!SceneFile::Build(_scene, SceneFile::GetLoadFilepath("SleepManagement", _loaded_exported_scene), &progress) || !_scene.GetBodyCount()) {
+        _scene.Build(CreateDefaultScene(context.world_dimensions).GetView(), &progress);
+    }
+}
 
 void GameStateSleepManagement::OnEnter() noexcept {
-    float width = static_cast<float>(g_theRenderer->GetOutput()->GetDimensions().x);
-    float height = static_cast<float>(g_theRenderer->GetOutput()->GetDimensions().y);
+    _scene.Register();
+    _islands.Reset();
+    _ccd.Reset();
+
+    g_thePhysicsSystem->Enable(true);
+    //Collision outlines are batched by the state; the engine only draws the partition and joints.
+    g_thePhysicsSystem->Debug_ShowCollision(false);
+}
+
+SceneDesc GameStateSleepManagement::CreateDefaultScene(const IntVector2& world_dims) const noexcept {
+    float width = static_cast<float>(world_dims.x);
+    float height = static_cast<float>(world_dims.y);
     const std::size_t maxBodies = 5;
-    _bodies.clear();
-    _bodies.reserve(maxBodies);
+    auto scene = SceneDesc{};
+    scene.bodies.reserve(maxBodies);
     float screenX = width * 0.50f;
     float screenY = height * 0.50f;
-    const auto world_dims = g_theRenderer->GetOutput()->GetDimensions();
     const auto mins = Vector2(-world_dims) * 0.5f;
     const auto maxs = Vector2(world_dims) * 0.5f;
-    auto physicsSystemDesc = PhysicsSystemDesc{};
-    physicsSystemDesc.world_bounds = AABB2{mins, maxs};
+    scene.physics.world_bounds = AABB2{mins, maxs};
     float x1 = screenX;
     float y1 = screenY;
     float x2 = x1 - 55.0f;
@@ -34,76 +56,33 @@ void GameStateSleepManagement::OnEnter() noexcept {
     float x5 = x4 + 55.0f;
     float y5 = y1;
     float radius = 25.0f;
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x2, y2}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Position{x2, y2}, radius)
-        , PhysicsMaterial{0.0f, 0.0f}
-        , PhysicsDesc{0.0f}
-    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(false);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x1, y1}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x1, y1), radius)
-        , PhysicsMaterial{0.0f, 0.0f, 0.0f}
-        , PhysicsDesc{}
-    )));
-    _bodies.back().EnableGravity(true);
-    _bodies.back().EnableDrag(false);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x3, y3}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x3, y3), radius)
-        , PhysicsMaterial{0.0f, 0.0f}
-        , PhysicsDesc{}
-    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(true);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x4, y4}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderCircle(Vector2(x4, y4), radius)
-        , PhysicsMaterial{0.0f, 0.0f}
-        , PhysicsDesc{}
-    )));
-    _bodies.back().EnableGravity(true);
-    _bodies.back().EnableDrag(true);
-    _bodies.push_back(RigidBody(RigidBodyDesc(
-        Position{x5, y5}
-        , Velocity{}
-        , Acceleration{}
-        , new ColliderPolygon(3, Vector2(x5, y5), Vector2{radius, radius} *2.0f, 0.0f)
-        , PhysicsMaterial{0.0f, 0.0f}
-        , PhysicsDesc{}
-    )));
-    _bodies.back().EnableGravity(false);
-    _bodies.back().EnableDrag(false);
-    std::vector<RigidBody*> body_ptrs(_bodies.size());
-    for(std::size_t i = 0u; i < _bodies.size(); ++i) {
-        body_ptrs[i] = &_bodies[i];
-    }
-    g_thePhysicsSystem->SetWorldDescription(physicsSystemDesc);
-    g_thePhysicsSystem->AddObjects(body_ptrs);
-
-    g_thePhysicsSystem->Enable(true);
-    g_thePhysicsSystem->Debug_ShowCollision(true);
+    const auto size = Vector2{radius, radius};
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x2, y2}, size, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{0.0f}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = false;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x1, y1}, size, PhysicsMaterial{0.0f, 0.0f, 0.0f}, PhysicsDesc{}));
+    scene.bodies.back().gravity_enabled = true;
+    scene.bodies.back().drag_enabled = false;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x3, y3}, size, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = true;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Position{x4, y4}, size, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{}));
+    scene.bodies.back().gravity_enabled = true;
+    scene.bodies.back().drag_enabled = true;
+    scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Polygon, Position{x5, y5}, size * 2.0f, PhysicsMaterial{0.0f, 0.0f}, PhysicsDesc{}));
+    scene.bodies.back().gravity_enabled = false;
+    scene.bodies.back().drag_enabled = false;
+    return scene;
 }
 
 void GameStateSleepManagement::OnExit() noexcept {
-    g_thePhysicsSystem->RemoveAllObjectsImmediately();
+    _scene.Clear();
     g_thePhysicsSystem->Debug_ShowCollision(false);
     g_thePhysicsSystem->Enable(false);
-    _bodies.clear();
 }
 
 void GameStateSleepManagement::BeginFrame() noexcept {
-    /* DO NOTHING */
+    _ccd.BeginFrame();
 }
 
 void GameStateSleepManagement::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept {
@@ -112,7 +91,6 @@ void GameStateSleepManagement::Update([[maybe_unused]] TimeUtils::FPSeconds delt
         return;
     }
     g_thePhysicsSystem->Debug_ShowWorldPartition(_show_world_partition);
-    g_thePhysicsSystem->Debug_ShowCollision(_show_collision);
     g_theRenderer->UpdateGameTime(deltaSeconds);
     if(_show_debug_window) {
         ShowDebugWindow();
@@ -144,6 +122,22 @@ void GameStateSleepManagement::Render() const noexcept {
     _ui_camera.SetupView(ui_leftBottom, ui_rightTop, ui_nearFar, MathUtils::M_16_BY_9_RATIO);
     g_theRenderer->SetCamera(_ui_camera);
 
+    g_theRenderer->SetMaterial(g_theRenderer->GetMaterial("__2D"));
+    if(_show_collision) {
+        _debug_shapes.Begin(AABB2{_ui_camera.position - ui_view_half_extents, _ui_camera.position + ui_view_half_extents});
+        _debug_shapes.AddSnapshot(_scene.GetRenderSnapshot());
+        auto sink = RendererDebugDrawSink{};
+        _debug_shapes.Submit(sink);
+    }
+}
+
+Scene* GameStateSleepManagement::GetScene() noexcept {
+    return &_scene;
+}
+
+bool GameStateSleepManagement::CanRestartInPlace() const noexcept {
+    //Switching scene files needs a reload.
+    return _loaded_exported_scene == _load_exported_scene;
 }
 
 void GameStateSleepManagement::EndFrame() noexcept {
@@ -152,18 +146,71 @@ void GameStateSleepManagement::EndFrame() noexcept {
 
 void GameStateSleepManagement::ShowDebugWindow() {
     if(ImGui::Begin("Debug Window", &_show_debug_window)) {
-        if(ImGui::Button("Fire projectile")) {
-            FireProjectile();
+        if(ImGui::Button("Export scene")) {
+            [[maybe_unused]] const auto saved = SceneFile::Save(SceneFile::GetExportFilepath("SleepManagement"), _scene.Export().GetView());
+        }
+        ImGui::Checkbox("Load exported scene", &_load_exported_scene);
+        if(ImGui::CollapsingHeader("Projectiles", ImGuiTreeNodeFlags_DefaultOpen)) {
+            ImGui::SliderFloat("Speed", &_projectile_speed, 100.0f, 20000.0f);
+            ImGui::Checkbox("Continuous collision", &_projectile_ccd);
+            if(ImGui::Button("Fire projectile")) {
+                SubmitEvent(g_theInputRecorder.Record(RecordedEventType::FireProjectile, Vector2{_projectile_speed, 0.0f}, 0u, _projectile_ccd ? 1u : 0u));
+            }
+            const auto& stats = _ccd.GetStats();
+            ImGui::Text("CCD bodies: %zu", stats.ccd_body_count);
+            ImGui::Text("CCD queries this frame: %zu", stats.query_count);
+            ImGui::Text("Tunnelling caught: %zu this frame, %zu total", stats.hit_count, stats.total_hit_count);
+        }
+        if(ImGui::CollapsingHeader("Sleeping", ImGuiTreeNodeFlags_DefaultOpen)) {
+#if !defined(FINAL_BUILD)
+            const auto physics_ms = g_theFrameProfiler.CalcStats(ProfileStage::Physics).avg_ms + g_theFrameProfiler.CalcStats(ProfileStage::Other).avg_ms;
+#else
+            const auto physics_ms = 0.0f;
+#endif
+            _islands.ShowDebugUI(physics_ms);
         }
     }
     ImGui::End();
 }
 
+void GameStateSleepManagement::ApplyRecordedEvent(const RecordedEvent& event) noexcept {
+    switch(event.type) {
+    case RecordedEventType::FireProjectile:
+        FireProjectile(event.point, event.sub_index != 0u);
+        break;
+    default:
+        /* DO NOTHING */
+        break;
+    }
+}
+
+void GameStateSleepManagement::AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept {
+    //Tunnelled projectiles are put back first so the islands see the contact.
+    {
+        PROFILE_STAGE(ProfileStage::ContinuousCollision);
+        _ccd.Update(_scene);
+    }
+    _islands.Update(_scene, timestep);
+}
+
+void GameStateSleepManagement::OnRestart() noexcept {
+    _islands.Reset();
+    _ccd.Reset();
+}
+
 void GameStateSleepManagement::ToggleShowDebugWindow() noexcept {
     _show_debug_window = !_show_debug_window;
 }
 
-void GameStateSleepManagement::FireProjectile() noexcept {
-    
+void GameStateSleepManagement::FireProjectile(const Vector2& velocity, bool continuous_collision) noexcept {
+    //From the left edge of the screen along the row of circles.
+    const auto world_dims = GetWorldDimensions();
+    const auto start = Position{static_cast<float>(world_dims.x) * 0.05f, static_cast<float>(world_dims.y) * 0.50f};
+    auto record = MakeBodyRecord(SceneColliderType::Circle, start, Vector2{5.0f, 5.0f}, PhysicsMaterial{0.0f, 0.5f});
+    record.velocity = velocity;
+    record.gravity_enabled = false;
+    record.drag_enabled = false;
+    record.continuous_collision = continuous_collision;
+    _scene.AddBody(record);
 }
 
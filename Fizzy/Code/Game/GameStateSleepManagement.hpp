@@ -5,9 +5,12 @@
 #include "Engine/Physics/PhysicsSystem.hpp"
 #include "Engine/Physics/RigidBody.hpp"
 
+#include "Game/ContinuousCollision.hpp"
+#include "Game/DebugDraw.hpp"
+#include "Game/GameGuid.hpp"
 #include "Game/IState.hpp"
-
-#include <guiddef.h>
+#include "Game/IslandManager.hpp"
+#include "Game/Scene.hpp"
 
 class GameStateSleepManagement : public IState {
 public:
@@ -22,26 +25,45 @@ public:
     GameStateSleepManagement& operator=(GameStateSleepManagement&& other) = default;
     virtual ~GameStateSleepManagement() = default;
 
+    void BeforeLoad() noexcept override;
+    void OnLoad(const LoadContext& context, LoadProgress& progress) noexcept override;
     void OnEnter() noexcept override;
     void OnExit() noexcept override;
     void BeginFrame() noexcept override;
     void Update([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept override;
     void Render() const noexcept override;
     void EndFrame() noexcept override;
+
+    [[nodiscard]] Scene* GetScene() noexcept override;
+    [[nodiscard]] bool CanRestartInPlace() const noexcept override;
+    void ApplyRecordedEvent(const RecordedEvent& event) noexcept override;
+    void AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept override;
+    void OnRestart() noexcept override;
 protected:
 private:
+    [[nodiscard]] SceneDesc CreateDefaultScene(const IntVector2& world_dims) const noexcept;
+
     void ShowDebugWindow();
     void ToggleShowDebugWindow() noexcept;
 
-    void FireProjectile() noexcept;
+    void FireProjectile(const Vector2& velocity, bool continuous_collision) noexcept;
 
-    std::vector<RigidBody> _bodies{};
+    Scene _scene{};
+    IslandManager _islands{};
+    ContinuousCollision _ccd{};
     mutable Camera2D _ui_camera{};
+    mutable DebugShapeBatch _debug_shapes{};
+    float _projectile_speed = 6000.0f;
+    bool _projectile_ccd = true;
     bool _isGravityEnabled = true;
     bool _isDragEnabled = true;
     bool _debug_click_adds_bodies = false;
     bool _show_debug_window = true;
     bool _show_world_partition = true;
     bool _show_collision = true;
+    //Load SceneFile::GetExportFilepath instead of the scene folder's file. Takes effect on restart.
+    static inline bool _load_exported_scene = false;
+    //_load_exported_scene as of BeforeLoad, since the UI may change it while OnLoad runs.
+    bool _loaded_exported_scene = false;
 
 };
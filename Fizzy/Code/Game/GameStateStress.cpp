@@ -0,0 +1,523 @@
+#include "Game/GameStateStress.hpp"
+
+#include "Engine/Core/App.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Input/InputSystem.hpp"
+
+#include "Engine/Physics/PhysicsSystem.hpp"
+#include "Engine/Physics/PhysicsTypes.hpp"
+
+#include "Engine/Renderer/Renderer.hpp"
+
+#include "Engine/UI/UISystem.hpp"
+
+#include "Game/FrameProfiler.hpp"
+#include "Game/Game.hpp"
+#include "Game/GameConfig.hpp"
+#include "Game/SceneFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+using StressClock = std::chrono::steady_clock;
+
+float CalcMillisecondsSince(const StressClock::time_point& start) noexcept {
+    return std::chrono::duration<float, std::milli>{StressClock::now() - start}.count();
+}
+
+//Exponential moving average so the readouts are stable enough to read while still tracking changes.
+void Accumulate(float& average_ms, float sample_ms) noexcept {
+    average_ms += (sample_ms - average_ms) * 0.05f;
+}
+
+bool IsSameScene(const StressSceneDesc& a, const StressSceneDesc& b) noexcept {
+    return a.body_count == b.body_count
+           && a.distribution == b.distribution
+           && a.circle_weight == b.circle_weight
+           && a.aabb_weight == b.aabb_weight
+           && a.obb_weight == b.obb_weight
+           && a.polygon_weight == b.polygon_weight
+           && a.body_radius == b.body_radius
+           && a.seed == b.seed
+           && a.spawn_per_frame == b.spawn_per_frame
+           && a.rope_links == b.rope_links
+           && a.parallel_joints == b.parallel_joints
+           && a.load_scene_file == b.load_scene_file;
+}
+
+} // namespace
+
+void GameStateStress::SetSceneDescription(const StressSceneDesc& desc) noexcept {
+    _desc = desc;
+}
+
+const StressSceneDesc& GameStateStress::GetSceneDescription() noexcept {
+    return _desc;
+}
+
+void GameStateStress::BeforeLoad() noexcept {
+    //The UI edits _desc on the frame thread while OnLoad runs.
+    _loaded_desc = _desc;
+    _loaded_exported_scene = _load_exported_scene;
+}
+
+void GameStateStress::OnLoad(const LoadContext& context, LoadProgress& progress) noexcept {
+    const auto spawn_start = StressClock::now();
+    if(_loaded_desc.load_scene_file && SceneFile::Build(_scene, SceneFile::GetLoadFilepath("Stress", _loaded_exported_scene), &progress)) {
+        _target_body_count = _scene.GetBodyCount();
+    } else {
+        SetupWorld(context.world_dimensions);
+        if(!_loaded_desc.spawn_per_frame) {
+            SpawnBodies(_target_body_count, &progress);
+        }
+    }
+    _timings = PhaseTimings{};
+    _timings.spawn_ms = CalcMillisecondsSince(spawn_start);
+}
+
+void GameStateStress::OnEnter() noexcept {
+    _scene.SetJointSolver(_loaded_desc.parallel_joints ? SceneJointSolver::Parallel : SceneJointSolver::Engine);
+    _scene.Register();
+    _joint_solver.Rebuild(_scene);
+    _islands.Reset();
+    _rng_on_enter = _rng;
+    //Collision outlines are batched by the state; the engine only draws the partition.
+    g_thePhysicsSystem->Debug_ShowCollision(false);
+    g_thePhysicsSystem->Enable(true);
+}
+
+void GameStateStress::OnExit() noexcept {
+    _scene.Clear();
+    //The quadtree is sized to this scene's world bounds.
+    _broadphases = {};
+    g_thePhysicsSystem->Debug_ShowCollision(false);
+    g_thePhysicsSystem->Enable(false);
+    _clump_centers.clear();
+}
+
+AABB2 GameStateStress::CalcWorldBounds(const IntVector2& world_dims) const noexcept {
+    //Size the world so body density stays roughly constant regardless of count.
+    const auto spacing = _loaded_desc.body_radius * 4.0f;
+    const auto side = std::sqrt(static_cast<float>((std::max)(_loaded_desc.body_count, std::size_t{1u}))) * spacing;
+    const auto half_extents = Vector2{(std::max)(side, static_cast<float>(world_dims.x)), (std::max)(side, static_cast<float>(world_dims.y))} * 0.5f;
+    return AABB2{-half_extents, half_extents};
+}
+
+void GameStateStress::SetupWorld(const IntVector2& world_dims) noexcept {
+    _rng.seed(_loaded_desc.seed);
+    const auto bounds = CalcWorldBounds(world_dims);
+    auto scene = SceneDesc{};
+    scene.physics.world_bounds = bounds;
+
+    _clump_centers.clear();
+    if(_loaded_desc.distribution == StressDistribution::Clumped) {
+        const auto clump_count = (std::max)(_loaded_desc.body_count / 1000u, std::size_t{1u});
+        std::uniform_real_distribution<float> x_dist{bounds.mins.x, bounds.maxs.x};
+        std::uniform_real_distribution<float> y_dist{bounds.mins.y, bounds.maxs.y};
+        _clump_centers.reserve(clump_count);
+        for(std::size_t i = 0u; i < clump_count; ++i) {
+            _clump_centers.push_back(Vector2{x_dist(_rng), y_dist(_rng)});
+        }
+    }
+
+    //Bodies are spawned into the empty scene; once it is registered each spawn only registers the new bodies.
+    _target_body_count = _loaded_desc.body_count;
+    //Ropes need their joints, which only Build creates, so they are built whole.
+    if(_loaded_desc.distribution == StressDistribution::Ropes) {
+        AddRopes(scene);
+        _target_body_count = scene.bodies.size();
+    }
+    _scene.Build(scene.GetView());
+}
+
+void GameStateStress::AddRopes(SceneDesc& scene) const noexcept {
+    const auto& bounds = scene.physics.world_bounds;
+    const auto radius = _loaded_desc.body_radius;
+    const auto spacing = radius * 2.5f;
+    const auto links = (std::max)(_loaded_desc.rope_links, std::size_t{2u});
+    const auto rope_count = (std::max)((_loaded_desc.body_count + links - 1u) / links, std::size_t{1u});
+    const auto rope_width = spacing * static_cast<float>(links);
+    const auto world_width = bounds.maxs.x - bounds.mins.x;
+    const auto columns = (std::max)(static_cast<std::size_t>(world_width / rope_width), std::size_t{1u});
+    const auto rows = (rope_count + columns - 1u) / columns;
+    const auto row_spacing = (bounds.maxs.y - bounds.mins.y) / static_cast<float>(rows + 1u);
+    scene.bodies.reserve(rope_count * links);
+    scene.joints.reserve(rope_count * (links - 1u));
+    for(std::size_t rope = 0u; rope < rope_count; ++rope) {
+        const auto left = bounds.mins.x + rope_width * static_cast<float>(rope % columns);
+        const auto y = bounds.mins.y + row_spacing * static_cast<float>(rope / columns + 1u);
+        const auto joint_type = (rope % 2u) ? SceneJointType::Cable : SceneJointType::Rod;
+        for(std::size_t link = 0u; link < links; ++link) {
+            const auto position = Vector2{left + radius + spacing * static_cast<float>(link), y};
+            const auto physics = link ? PhysicsDesc{} : PhysicsDesc{0.0f};
+            scene.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, position, Vector2{radius, radius}, PhysicsMaterial{}, physics));
+            scene.bodies.back().gravity_enabled = link != 0u;
+            scene.bodies.back().drag_enabled = false;
+            if(link) {
+                const auto body_b = static_cast<uint32_t>(scene.bodies.size() - 1u);
+                scene.joints.push_back(SceneJointRecord{joint_type, body_b - 1u, body_b, spacing, 0.0f});
+            }
+        }
+    }
+}
+
+void GameStateStress::SpawnBodies(std::size_t count, LoadProgress* progress /*= nullptr*/) noexcept {
+    const auto bounds = _scene.GetPhysicsDescription().world_bounds;
+    const auto is_stacked = _loaded_desc.distribution == StressDistribution::Stacked;
+    const auto first_new_body = _scene.GetBodyCount();
+    const auto new_size = (std::min)(first_new_body + count, _target_body_count);
+    const auto spawn_count = new_size - first_new_body;
+    auto shape_dist = CreateShapeDistribution();
+    std::vector<SceneBodyRecord> records{};
+    records.reserve(spawn_count);
+    for(std::size_t i = first_new_body; i < new_size; ++i) {
+        records.push_back(CreateBodyRecord(CalcSpawnPosition(i, bounds), shape_dist));
+        records.back().gravity_enabled = is_stacked;
+        records.back().drag_enabled = false;
+        //Generating the records is about half of the work; creating the bodies is the rest.
+        if(progress && (i % 1024u) == 0u) {
+            progress->fraction.store(0.5f * static_cast<float>(i - first_new_body) / static_cast<float>(spawn_count), std::memory_order_relaxed);
+        }
+    }
+    _scene.AddBodies(records.data(), records.size());
+    if(progress) {
+        progress->fraction.store(1.0f, std::memory_order_relaxed);
+    }
+}
+
+Vector2 GameStateStress::CalcSpawnPosition(std::size_t index, const AABB2& bounds) noexcept {
+    const auto radius = _loaded_desc.body_radius;
+    switch(_loaded_desc.distribution) {
+    case StressDistribution::Uniform:
+    {
+        std::uniform_real_distribution<float> x_dist{bounds.mins.x + radius, bounds.maxs.x - radius};
+        std::uniform_real_distribution<float> y_dist{bounds.mins.y + radius, bounds.maxs.y - radius};
+        return Vector2{x_dist(_rng), y_dist(_rng)};
+    }
+    case StressDistribution::Clumped:
+    {
+        const auto& center = _clump_centers[index % _clump_centers.size()];
+        const auto bodies_per_clump = static_cast<float>(_target_body_count / _clump_centers.size());
+        std::normal_distribution<float> offset_dist{0.0f, std::sqrt(bodies_per_clump) * radius};
+        const auto x = std::clamp(center.x + offset_dist(_rng), bounds.mins.x + radius, bounds.maxs.x - radius);
+        const auto y = std::clamp(center.y + offset_dist(_rng), bounds.mins.y + radius, bounds.maxs.y - radius);
+        return Vector2{x, y};
+    }
+    case StressDistribution::Stacked:
+    {
+        //Touching columns resting on the bottom of the world.
+        const auto diameter = radius * 2.0f;
+        const auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<float>(_target_body_count))));
+        const auto column = index % columns;
+        const auto row = index / columns;
+        const auto left = -static_cast<float>(columns) * radius;
+        return Vector2{left + radius + diameter * static_cast<float>(column), bounds.maxs.y - radius - diameter * static_cast<float>(row)};
+    }
+    default: ERROR_AND_DIE("StressDistribution values have changed. Refactor GameStateStress::CalcSpawnPosition.");
+    }
+}
+
+std::discrete_distribution<int> GameStateStress::CreateShapeDistribution() const noexcept {
+    const auto weights = std::array<int, 4>{(std::max)(_loaded_desc.circle_weight, 0), (std::max)(_loaded_desc.aabb_weight, 0), (std::max)(_loaded_desc.obb_weight, 0), (std::max)(_loaded_desc.polygon_weight, 0)};
+    return std::discrete_distribution<int>{std::cbegin(weights), std::cend(weights)};
+}
+
+SceneBodyRecord GameStateStress::CreateBodyRecord(const Vector2& position, std::discrete_distribution<int>& shape_dist) noexcept {
+    const auto radius = _loaded_desc.body_radius;
+    switch(shape_dist(_rng)) {
+    case 1: return MakeBodyRecord(SceneColliderType::AABB, position, Vector2{radius, radius});
+    case 2: return MakeBodyRecord(SceneColliderType::OBB, position, Vector2{radius, radius});
+    case 3:
+    {
+        std::uniform_int_distribution<int> sides_dist{3, 6};
+        auto record = MakeBodyRecord(SceneColliderType::Polygon, position, Vector2{radius, radius} * 2.0f);
+        record.polygon_sides = static_cast<uint32_t>(sides_dist(_rng));
+        return record;
+    }
+    case 0:
+    default: return MakeBodyRecord(SceneColliderType::Circle, position, Vector2{radius, radius});
+    }
+}
+
+void GameStateStress::BeginFrame() noexcept {
+    _joint_solver.BeginFrame();
+    _contact_solver.BeginFrame();
+}
+
+void GameStateStress::Update([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept {
+    const auto start = StressClock::now();
+    Accumulate(_timings.frame_ms, std::chrono::duration<float, std::milli>{deltaSeconds}.count());
+    if(g_theInputSystem->WasKeyJustPressed(KeyCode::Esc)) {
+        g_theApp<Game>->SetIsQuitting(true);
+        return;
+    }
+    if(g_theInputSystem->WasKeyJustPressed(KeyCode::F1)) {
+        ToggleShowDebugWindow();
+    }
+    g_thePhysicsSystem->Debug_ShowWorldPartition(_show_world_partition);
+    g_theRenderer->UpdateGameTime(deltaSeconds);
+    UpdateBroadphases();
+    if(_show_debug_window) {
+        ShowDebugWindow();
+    }
+
+    Camera2D& base_camera = _ui_camera;
+    base_camera.Update(deltaSeconds);
+    Accumulate(_timings.update_ms, CalcMillisecondsSince(start));
+}
+
+void GameStateStress::Render() const noexcept {
+    const auto start = StressClock::now();
+    g_theRenderer->BeginRenderToBackbuffer();
+
+    //2D View / HUD
+    const auto ui_view_height = static_cast<float>(g_theGame->GetSettings().GetWindowHeight());
+    const auto ui_view_width = ui_view_height * _ui_camera.GetAspectRatio();
+    const auto ui_view_extents = Vector2{ui_view_width, ui_view_height};
+    const auto ui_view_half_extents = ui_view_extents * 0.5f;
+    g_theRenderer->BeginHUDRender(_ui_camera, ui_view_half_extents, ui_view_height);
+
+    g_theRenderer->SetMaterial(g_theRenderer->GetMaterial("__2D"));
+    g_theRenderer->DrawAxes(static_cast<float>((std::max)(ui_view_extents.x, ui_view_extents.y)), false);
+    const auto& broadphase = _broadphases[static_cast<std::size_t>(_desc.broadphase.type)];
+    const auto show_broadphase = _show_broadphase && _run_broadphase && broadphase;
+    const auto& snapshot = _scene.GetRenderSnapshot();
+    auto sink = RendererDebugDrawSink{};
+    if(_show_collision || show_broadphase) {
+        _debug_shapes.Begin(AABB2{_ui_camera.position - ui_view_half_extents, _ui_camera.position + ui_view_half_extents});
+        if(_show_collision) {
+            _debug_shapes.AddSnapshot(snapshot);
+        }
+        //Built in Update, so the simulation thread does not touch it.
+        if(show_broadphase) {
+            broadphase->AddDebugShapes(_debug_shapes);
+        }
+        _debug_shapes.Submit(sink);
+    }
+    snapshot.overlay.Submit(sink);
+    Accumulate(_timings.render_ms, CalcMillisecondsSince(start));
+}
+
+bool GameStateStress::CanRestartInPlace() const noexcept {
+    //A tuned description or a switch of scene files needs a rebuild.
+    return IsSameScene(_desc, _loaded_desc) && (!_desc.load_scene_file || _loaded_exported_scene == _load_exported_scene);
+}
+
+void GameStateStress::AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept {
+    if(_scene.GetJointSolver() == SceneJointSolver::Parallel) {
+        PROFILE_STAGE(ProfileStage::JointSolve);
+        _joint_solver.SetDescription(_desc.joints);
+        _joint_solver.Solve(_scene, timestep);
+    }
+    _islands.SetDescription(_desc.sleep);
+    _islands.Update(_scene, timestep);
+    if(IsRunningContacts()) {
+        PROFILE_STAGE(ProfileStage::Contacts);
+        _contacts.SetDescription(_desc.contacts);
+        _contacts.Update(_scene);
+        if(_desc.solve_contacts) {
+            _contact_solver.SetDescription(_desc.contact_solver);
+            _contact_solver.Solve(_scene, _contacts.GetManifolds(), timestep);
+        }
+    }
+}
+
+bool GameStateStress::IsRunningContacts() const noexcept {
+    return _run_contacts || _desc.solve_contacts;
+}
+
+void GameStateStress::AddRenderOverlay(DebugShapeBatch& overlay) const noexcept {
+    if(!_show_contacts || !IsRunningContacts()) {
+        return;
+    }
+    for(const auto& manifold : _contacts.GetManifolds()) {
+        for(std::size_t i = 0u; i < manifold.point_count; ++i) {
+            overlay.AddCircle(manifold.points[i].position, 2.0f, Rgba::Red);
+        }
+    }
+}
+
+void GameStateStress::OnRestart() noexcept {
+    //The restore drops bodies spawned since OnEnter, so spawn them again from the same seed.
+    _rng = _rng_on_enter;
+    //It may also have reattached joints.
+    _joint_solver.Rebuild(_scene);
+    _contacts.Reset();
+    _islands.Reset();
+}
+
+Scene* GameStateStress::GetScene() noexcept {
+    return &_scene;
+}
+
+const ParallelJointSolver* GameStateStress::GetJointSolver() const noexcept {
+    return &_joint_solver;
+}
+
+const ContactCache* GameStateStress::GetContactCache() const noexcept {
+    return IsRunningContacts() ? &_contacts : nullptr;
+}
+
+const ContactSolver* GameStateStress::GetContactSolver() const noexcept {
+    return _desc.solve_contacts ? &_contact_solver : nullptr;
+}
+
+void GameStateStress::EndFrame() noexcept {
+    if(_loaded_desc.spawn_per_frame && _scene.GetBodyCount() < _target_body_count) {
+        const auto start = StressClock::now();
+        SpawnBodies(_loaded_desc.spawn_per_frame);
+        Accumulate(_timings.spawn_ms, CalcMillisecondsSince(start));
+    }
+}
+
+void GameStateStress::UpdateBroadphases() noexcept {
+    if(!_run_broadphase) {
+        return;
+    }
+    _scene.CalcBodyBounds(_body_bounds);
+    for(std::size_t i = 0u; i < _broadphases.size(); ++i) {
+        const auto type = static_cast<BroadphaseType>(i);
+        if(!_compare_broadphases && type != _desc.broadphase.type) {
+            continue;
+        }
+        auto& broadphase = _broadphases[i];
+        if(!broadphase) {
+            auto desc = _desc.broadphase;
+            desc.type = type;
+            broadphase = CreateBroadphase(desc, _scene.GetPhysicsDescription().world_bounds);
+        }
+        auto& stats = _broadphase_stats[i];
+        const auto build_start = StressClock::now();
+        broadphase->Build(_body_bounds);
+        Accumulate(stats.build_ms, CalcMillisecondsSince(build_start));
+        const auto find_start = StressClock::now();
+        broadphase->FindPairs(_broadphase_pairs);
+        Accumulate(stats.find_ms, CalcMillisecondsSince(find_start));
+        stats.pair_count = _broadphase_pairs.size();
+        stats.cell_count = broadphase->GetCellCount();
+    }
+}
+
+void GameStateStress::ToggleShowDebugWindow() noexcept {
+    _show_debug_window = !_show_debug_window;
+}
+
+void GameStateStress::ShowDebugWindow() {
+    if(ImGui::Begin("Debug Window", &_show_debug_window)) {
+        ImGui::Checkbox("Show Quadtree", &_show_world_partition);
+        ImGui::Checkbox("Show Collision", &_show_collision);
+        if(ImGui::CollapsingHeader("Scene", ImGuiTreeNodeFlags_DefaultOpen)) {
+            int body_count = static_cast<int>(_desc.body_count);
+            if(ImGui::SliderInt("Bodies", &body_count, 100, 100000)) {
+                _desc.body_count = static_cast<std::size_t>(body_count);
+            }
+            const char* distributions[] = {"Uniform", "Clumped", "Stacked", "Ropes"};
+            int distribution = static_cast<int>(_desc.distribution);
+            if(ImGui::Combo("Distribution", &distribution, distributions, 4)) {
+                _desc.distribution = static_cast<StressDistribution>(distribution);
+            }
+            if(_desc.distribution == StressDistribution::Ropes) {
+                int rope_links = static_cast<int>(_desc.rope_links);
+                if(ImGui::SliderInt("Rope links", &rope_links, 2, 1000)) {
+                    _desc.rope_links = static_cast<std::size_t>(rope_links);
+                }
+                ImGui::Checkbox("Parallel joint solver", &_desc.parallel_joints);
+            }
+            ImGui::SliderInt("Circle weight", &_desc.circle_weight, 0, 10);
+            ImGui::SliderInt("AABB weight", &_desc.aabb_weight, 0, 10);
+            ImGui::SliderInt("OBB weight", &_desc.obb_weight, 0, 10);
+            ImGui::SliderInt("Polygon weight", &_desc.polygon_weight, 0, 10);
+            ImGui::SliderFloat("Body radius", &_desc.body_radius, 1.0f, 25.0f);
+            int spawn_per_frame = static_cast<int>(_desc.spawn_per_frame);
+            if(ImGui::SliderInt("Spawn per frame", &spawn_per_frame, 0, 1000)) {
+                _desc.spawn_per_frame = static_cast<std::size_t>(spawn_per_frame);
+            }
+            int seed = static_cast<int>(_desc.seed);
+            if(ImGui::InputInt("Seed", &seed)) {
+                _desc.seed = static_cast<unsigned int>(seed);
+            }
+            ImGui::Checkbox("Load scene file", &_desc.load_scene_file);
+            if(_desc.load_scene_file) {
+                ImGui::Checkbox("Load exported scene", &_load_exported_scene);
+            }
+            if(ImGui::Button("Export scene")) {
+                [[maybe_unused]] const auto saved = SceneFile::Save(SceneFile::GetExportFilepath("Stress"), _scene.Export().GetView());
+            }
+            ImGui::Text("Press R or Restart Demo to rebuild the scene.");
+        }
+        ShowBroadphaseSettings();
+        if(_scene.GetJointSolver() == SceneJointSolver::Parallel && ImGui::CollapsingHeader("Joint solver")) {
+            _joint_solver.SetDescription(_desc.joints);
+            _joint_solver.ShowDebugUI();
+            _desc.joints = _joint_solver.GetDescription();
+        }
+        if(ImGui::CollapsingHeader("Contacts")) {
+            const auto was_running = IsRunningContacts();
+            ImGui::Checkbox("Run contact cache", &_run_contacts);
+            ImGui::Checkbox("Solve contacts", &_desc.solve_contacts);
+            if(was_running && !IsRunningContacts()) {
+                _contacts.Reset();
+            }
+            ImGui::Checkbox("Show contacts", &_show_contacts);
+            _contacts.SetDescription(_desc.contacts);
+            _contacts.ShowDebugUI();
+            _desc.contacts = _contacts.GetDescription();
+            if(_desc.solve_contacts) {
+                _contact_solver.SetDescription(_desc.contact_solver);
+                _contact_solver.ShowDebugUI();
+                _desc.contact_solver = _contact_solver.GetDescription();
+            }
+        }
+        if(ImGui::CollapsingHeader("Sleeping")) {
+            _islands.SetDescription(_desc.sleep);
+            _islands.ShowDebugUI((std::max)(0.0f, _timings.frame_ms - _timings.update_ms - _timings.render_ms));
+            _desc.sleep = _islands.GetDescription();
+        }
+        if(ImGui::CollapsingHeader("Timings", ImGuiTreeNodeFlags_DefaultOpen)) {
+            ImGui::Text("Bodies: %zu", _scene.GetBodyCount());
+            ImGui::Text("Spawn: %.3f ms", _timings.spawn_ms);
+            ImGui::Text("Update: %.3f ms", _timings.update_ms);
+            ImGui::Text("Render: %.3f ms", _timings.render_ms);
+            ImGui::Text("Physics + engine: %.3f ms", (std::max)(0.0f, _timings.frame_ms - _timings.update_ms - _timings.render_ms));
+            ImGui::Text("Frame: %.3f ms", _timings.frame_ms);
+        }
+        _inspector.ShowBodyList(_scene, _selected_body);
+    }
+    ImGui::End();
+}
+
+void GameStateStress::ShowBroadphaseSettings() {
+    if(!ImGui::CollapsingHeader("Broadphase")) {
+        return;
+    }
+    ImGui::Checkbox("Run broadphase", &_run_broadphase);
+    const char* types[] = {GetBroadphaseName(BroadphaseType::Quadtree), GetBroadphaseName(BroadphaseType::SpatialHash)};
+    int type = static_cast<int>(_desc.broadphase.type);
+    if(ImGui::Combo("Type", &type, types, static_cast<int>(BroadphaseType::Max))) {
+        _desc.broadphase.type = static_cast<BroadphaseType>(type);
+    }
+    if(ImGui::SliderFloat("Cell size (0 = auto)", &_desc.broadphase.cell_size, 0.0f, 100.0f)) {
+        _broadphases[static_cast<std::size_t>(BroadphaseType::SpatialHash)].reset();
+    }
+    ImGui::Text("Auto cell size: %.2f", SpatialHashBroadphase::CalcCellSize(_body_bounds));
+    ImGui::Checkbox("Compare both", &_compare_broadphases);
+    ImGui::Checkbox("Show broadphase cells", &_show_broadphase);
+    for(std::size_t i = 0u; i < _broadphase_stats.size(); ++i) {
+        if(!_compare_broadphases && i != static_cast<std::size_t>(_desc.broadphase.type)) {
+            continue;
+        }
+        const auto& stats = _broadphase_stats[i];
+        ImGui::Text("%s: %zu pairs, %zu cells", GetBroadphaseName(static_cast<BroadphaseType>(i)), stats.pair_count, stats.cell_count);
+        ImGui::Text("    Build: %.3f ms Pairs: %.3f ms", stats.build_ms, stats.find_ms);
+    }
+    const auto& quadtree_stats = _broadphase_stats[static_cast<std::size_t>(BroadphaseType::Quadtree)];
+    const auto& hash_stats = _broadphase_stats[static_cast<std::size_t>(BroadphaseType::SpatialHash)];
+    if(_compare_broadphases && quadtree_stats.pair_count != hash_stats.pair_count) {
+        ImGui::Text("Pair counts differ!");
+    }
+}
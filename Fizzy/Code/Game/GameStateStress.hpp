@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Engine/Physics/PhysicsSystem.hpp"
+#include "Engine/Physics/RigidBody.hpp"
+
+#include "Engine/Math/Vector2.hpp"
+
+#include "Engine/Renderer/Camera2D.hpp"
+
+#include "Game/BodyInspector.hpp"
+#include "Game/Broadphase.hpp"
+#include "Game/ContactCache.hpp"
+#include "Game/ContactSolver.hpp"
+#include "Game/DebugDraw.hpp"
+#include "Game/GameGuid.hpp"
+#include "Game/IState.hpp"
+#include "Game/IslandManager.hpp"
+#include "Game/JointSolver.hpp"
+#include "Game/Scene.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <vector>
+
+enum class StressDistribution {
+    Uniform
+    , Clumped
+    , Stacked
+    , Ropes //Horizontal chains hanging from a static anchor, alternating rods and cables.
+};
+
+struct StressSceneDesc {
+    std::size_t body_count = 10000u;
+    StressDistribution distribution = StressDistribution::Uniform;
+    int circle_weight = 1;
+    int aabb_weight = 1;
+    int obb_weight = 1;
+    int polygon_weight = 1;
+    float body_radius = 4.0f;
+    unsigned int seed = 0u;
+    //Bodies added per frame until body_count is reached; 0 spawns the whole scene on enter.
+    std::size_t spawn_per_frame = 0u;
+    //Bodies per rope, anchor included, for StressDistribution::Ropes.
+    std::size_t rope_links = 50u;
+    //Solve rods and cables with ParallelJointSolver instead of the physics system.
+    bool parallel_joints = true;
+    //Load Data/Scenes/Stress.fzscene instead of generating the scene, if it exists.
+    bool load_scene_file = false;
+    //Game-side broadphase run beside the engine's. Changing it does not rebuild the scene.
+    BroadphaseDesc broadphase{};
+    //Off by default so the stress numbers measure every body. Changing it does not rebuild the scene.
+    IslandSleepDesc sleep{false};
+    //Used by the parallel joint solver. Changing it does not rebuild the scene.
+    JointSolverDesc joints{};
+    //Game-side contact cache. Changing it does not rebuild the scene.
+    ContactCacheDesc contacts{};
+    //Solve the cache's manifolds with ContactSolver after each step, which
+    //runs the cache too. Off by default since it changes the simulation.
+    //Changing it does not rebuild the scene.
+    bool solve_contacts = false;
+    ContactSolverDesc contact_solver{};
+};
+
+class GameStateStress : public IState {
+public:
+
+    // {C3E1F0A7-5B2D-4E8A-9D64-1F7B3A2C8E90}
+    static inline constexpr GUID ID = {0xc3e1f0a7, 0x5b2d, 0x4e8a, { 0x9d, 0x64, 0x1f, 0x7b, 0x3a, 0x2c, 0x8e, 0x90 }};
+
+    GameStateStress() = default;
+    GameStateStress(const GameStateStress& other) = default;
+    GameStateStress(GameStateStress&& other) = default;
+    GameStateStress& operator=(const GameStateStress& other) = default;
+    GameStateStress& operator=(GameStateStress&& other) = default;
+    virtual ~GameStateStress() = default;
+
+    //The description survives restarts so a scene can be tuned and rebuilt.
+    static void SetSceneDescription(const StressSceneDesc& desc) noexcept;
+    [[nodiscard]] static const StressSceneDesc& GetSceneDescription() noexcept;
+
+    void BeforeLoad() noexcept override;
+    void OnLoad(const LoadContext& context, LoadProgress& progress) noexcept override;
+    void OnEnter() noexcept override;
+    void OnExit() noexcept override;
+
+    void BeginFrame() noexcept override;
+    void Update([[maybe_unused]] TimeUtils::FPSeconds deltaSeconds) noexcept override;
+    void Render() const noexcept override;
+    void EndFrame() noexcept override;
+
+    [[nodiscard]] Scene* GetScene() noexcept override;
+    [[nodiscard]] const ParallelJointSolver* GetJointSolver() const noexcept override;
+    [[nodiscard]] const ContactCache* GetContactCache() const noexcept override;
+    [[nodiscard]] const ContactSolver* GetContactSolver() const noexcept override;
+    [[nodiscard]] bool CanRestartInPlace() const noexcept override;
+    void AfterPhysicsStep(TimeUtils::FPSeconds timestep) noexcept override;
+    //Contact points, which the cache updates after each step.
+    void AddRenderOverlay(DebugShapeBatch& overlay) const noexcept override;
+    void OnRestart() noexcept override;
+
+protected:
+private:
+    struct PhaseTimings {
+        float spawn_ms{};
+        float update_ms{};
+        float render_ms{};
+        float frame_ms{};
+    };
+
+    struct BroadphaseStats {
+        float build_ms{};
+        float find_ms{};
+        std::size_t pair_count{};
+        std::size_t cell_count{};
+    };
+
+    void SetupWorld(const IntVector2& world_dims) noexcept;
+    void AddRopes(SceneDesc& scene) const noexcept;
+    void SpawnBodies(std::size_t count, LoadProgress* progress = nullptr) noexcept;
+    [[nodiscard]] AABB2 CalcWorldBounds(const IntVector2& world_dims) const noexcept;
+    [[nodiscard]] Vector2 CalcSpawnPosition(std::size_t index, const AABB2& bounds) noexcept;
+    //Picks circle, AABB, OBB or polygon by the loaded description's weights.
+    //Built once per spawn and passed to every CreateBodyRecord call.
+    [[nodiscard]] std::discrete_distribution<int> CreateShapeDistribution() const noexcept;
+    [[nodiscard]] SceneBodyRecord CreateBodyRecord(const Vector2& position, std::discrete_distribution<int>& shape_dist) noexcept;
+
+    //The cache runs when shown or when its manifolds are solved.
+    [[nodiscard]] bool IsRunningContacts() const noexcept;
+    //Finds the pairs of the selected broadphase, or of both when comparing.
+    void UpdateBroadphases() noexcept;
+    void ShowBroadphaseSettings();
+    void ShowDebugWindow();
+    void ToggleShowDebugWindow() noexcept;
+
+    static inline StressSceneDesc _desc{};
+    //The description the current scene was built from, copied from _desc on the frame thread before loading.
+    StressSceneDesc _loaded_desc{};
+    //With load_scene_file, load SceneFile::GetExportFilepath instead of the scene folder's file. Takes effect on restart.
+    static inline bool _load_exported_scene = false;
+    bool _loaded_exported_scene = false;
+    Scene _scene{};
+    IslandManager _islands{};
+    ParallelJointSolver _joint_solver{};
+    ContactCache _contacts{};
+    ContactSolver _contact_solver{};
+    BodyInspector _inspector{};
+    std::size_t _selected_body{};
+    std::vector<Vector2> _clump_centers{};
+    std::size_t _target_body_count{};
+    std::mt19937 _rng{};
+    //_rng as the scene's snapshot was captured, so a restart spawns the same bodies.
+    std::mt19937 _rng_on_enter{};
+    mutable PhaseTimings _timings{};
+    mutable Camera2D _ui_camera{};
+    mutable DebugShapeBatch _debug_shapes{};
+    std::array<std::unique_ptr<IBroadphase>, static_cast<std::size_t>(BroadphaseType::Max)> _broadphases{};
+    std::array<BroadphaseStats, static_cast<std::size_t>(BroadphaseType::Max)> _broadphase_stats{};
+    std::vector<AABB2> _body_bounds{};
+    std::vector<BroadphasePair> _broadphase_pairs{};
+    bool _show_debug_window = true;
+    bool _show_world_partition = false;
+    bool _show_collision = false;
+    bool _run_broadphase = false;
+    bool _compare_broadphases = false;
+    bool _show_broadphase = false;
+    bool _run_contacts = false;
+    bool _show_contacts = false;
+};
@@ -0,0 +1,584 @@
+#include "Game/HeadlessSimulation.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Physics/PhysicsSystem.hpp"
+
+#include "Game/AllocationCounter.hpp"
+#include "Game/ContactSolver.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/GameStateConstraints.hpp"
+#include "Game/Scene.hpp"
+#include "Game/GameStateSleepManagement.hpp"
+#include "Game/GameStateStress.hpp"
+#include "Game/JointSolver.hpp"
+#include "Game/SceneQuery.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <utility>
+
+bool TryParseStateId(const std::string& text, GUID& out_id) noexcept {
+    static const std::array<std::pair<const char*, GUID>, 4> named_states{
+        std::make_pair("GravityDrag", GameStateGravityDrag::ID)
+        , std::make_pair("Constraints", GameStateConstraints::ID)
+        , std::make_pair("SleepManagement", GameStateSleepManagement::ID)
+        , std::make_pair("Stress", GameStateStress::ID)
+    };
+    for(const auto& [name, id] : named_states) {
+        if(text == name) {
+            out_id = id;
+            return true;
+        }
+    }
+    unsigned int data1{};
+    unsigned int data2{};
+    unsigned int data3{};
+    unsigned int data4[8]{};
+    const auto fields = std::sscanf(text.c_str(), "{%8x-%4x-%4x-%2x%2x-%2x%2x%2x%2x%2x%2x}"
+                                    , &data1, &data2, &data3
+                                    , &data4[0], &data4[1], &data4[2], &data4[3]
+                                    , &data4[4], &data4[5], &data4[6], &data4[7]);
+    if(fields != 11) {
+        return false;
+    }
+    out_id.Data1 = static_cast<decltype(out_id.Data1)>(data1);
+    out_id.Data2 = static_cast<decltype(out_id.Data2)>(data2);
+    out_id.Data3 = static_cast<decltype(out_id.Data3)>(data3);
+    for(std::size_t i = 0u; i < 8u; ++i) {
+        out_id.Data4[i] = static_cast<unsigned char>(data4[i]);
+    }
+    return true;
+}
+
+std::vector<NarrowphaseBenchmarkResult> BenchmarkSolvedNarrowphase(const HeadlessSimulationDesc& desc) noexcept {
+    const auto stress = GameStateStress::GetSceneDescription();
+    auto simulation_desc = desc;
+    simulation_desc.stateId = GameStateStress::ID;
+    std::vector<NarrowphaseBenchmarkResult> results(3u);
+    std::vector<std::size_t> first_point_counts{};
+    for(std::size_t i = 0u; i < results.size(); ++i) {
+        auto solved = stress;
+        solved.solve_contacts = true;
+        solved.contacts.world_shapes = i != 0u;
+        solved.contacts.cache_axes = i == 2u;
+        GameStateStress::SetSceneDescription(solved);
+        std::vector<std::size_t> point_counts{};
+        {
+            HeadlessSimulation simulation{simulation_desc};
+            results[i] = simulation.BenchmarkContactPath(point_counts);
+        }
+        results[i].world_shapes = solved.contacts.world_shapes;
+        results[i].cache_axes = solved.contacts.cache_axes;
+        if(!i) {
+            first_point_counts = point_counts;
+            continue;
+        }
+        for(std::size_t step = 0u; step < point_counts.size(); ++step) {
+            if(step >= first_point_counts.size() || point_counts[step] != first_point_counts[step]) {
+                ++results[i].mismatched_steps;
+            }
+        }
+    }
+    GameStateStress::SetSceneDescription(stress);
+    return results;
+}
+
+HeadlessSimulation::HeadlessSimulation(const HeadlessSimulationDesc& desc) noexcept
+    : _desc{desc}
+{
+    //Loads stay on the stepping thread so a run is repeatable step for step.
+    _state.SetAsyncLoading(false);
+    _state.ChangeState(_desc.stateId);
+}
+
+HeadlessSimulationResult HeadlessSimulation::Run() noexcept {
+    using clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+    using s = std::chrono::duration<double>;
+
+    HeadlessSimulationResult result{};
+
+    //The first frame enters the state and builds its world; keep it out of the step timings.
+    const auto setup_start = clock::now();
+    Step();
+    result.setup_milliseconds = ms{clock::now() - setup_start}.count();
+    if(const auto* scene = _state.GetCurrentScene()) {
+        result.body_count = scene->GetBodyCount();
+    }
+#if !defined(FINAL_BUILD)
+    //Keep the setup frame out of the stage timings too.
+    g_theFrameProfiler.Reset();
+#endif
+
+    _debug_sink.Reset();
+    _debug_shape_count = 0u;
+    const auto allocations_before = GetAllocationCounts();
+    const auto start = clock::now();
+    for(std::size_t i = 0u; i < _desc.steps; ++i) {
+        Step();
+    }
+    const auto elapsed = clock::now() - start;
+    const auto allocations_after = GetAllocationCounts();
+
+    result.steps = _desc.steps;
+    result.total_seconds = s{elapsed}.count();
+    if(result.total_seconds > 0.0) {
+        result.steps_per_second = static_cast<double>(result.steps) / result.total_seconds;
+    }
+    if(result.steps) {
+        result.milliseconds_per_step = ms{elapsed}.count() / static_cast<double>(result.steps);
+        result.allocations_per_step = static_cast<double>(allocations_after.count - allocations_before.count) / static_cast<double>(result.steps);
+        result.allocated_bytes_per_step = static_cast<double>(allocations_after.bytes - allocations_before.bytes) / static_cast<double>(result.steps);
+        result.debug_draws_per_step = static_cast<double>(_debug_sink.draw_count) / static_cast<double>(result.steps);
+        result.debug_shapes_per_step = static_cast<double>(_debug_shape_count) / static_cast<double>(result.steps);
+        result.debug_vertices_per_step = static_cast<double>(_debug_sink.vertex_count) / static_cast<double>(result.steps);
+    }
+    return result;
+}
+
+HeadlessReplayResult HeadlessSimulation::Replay(const InputRecording& recording) noexcept {
+    using clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+    using s = std::chrono::duration<double>;
+
+    HeadlessReplayResult result{};
+    result.frames = recording.frames.size();
+    result.first_divergent_frame = result.frames;
+
+    //The first BeginFrame enters the state, as it did on the frame the recording began.
+    const auto setup_start = clock::now();
+    _state.BeginFrame();
+    result.setup_milliseconds = ms{clock::now() - setup_start}.count();
+
+    auto next_event = std::cbegin(recording.events);
+    const auto last_event = std::cend(recording.events);
+    auto measured = clock::duration{};
+    for(std::size_t i = 0u; i < result.frames; ++i) {
+        const auto frame_start = clock::now();
+        if(i) {
+            _state.BeginFrame();
+        }
+        for(; next_event != last_event && next_event->frame <= i; ++next_event) {
+            _state.ApplyRecordedEvent(*next_event);
+            ++result.events;
+        }
+        const auto& frame = recording.frames[i];
+        for(uint32_t step = 0u; step < frame.substeps; ++step) {
+            StepPhysics(recording.step);
+        }
+        _state.EndFrame();
+        const auto frame_time = clock::now() - frame_start;
+        measured += frame_time;
+        result.max_milliseconds_per_frame = (std::max)(result.max_milliseconds_per_frame, ms{frame_time}.count());
+
+        const auto* scene = _state.GetCurrentScene();
+        if((scene ? scene->CalcStateHash() : 0u) != frame.world_hash) {
+            if(!result.divergent_frames) {
+                result.first_divergent_frame = i;
+            }
+            ++result.divergent_frames;
+        }
+    }
+    result.total_seconds = s{measured}.count();
+    if(result.frames) {
+        result.milliseconds_per_frame = ms{measured}.count() / static_cast<double>(result.frames);
+    }
+    return result;
+}
+
+std::vector<IntegrationBenchmarkResult> HeadlessSimulation::BenchmarkIntegration() noexcept {
+    using clock = std::chrono::steady_clock;
+    using ns = std::chrono::duration<double, std::nano>;
+
+    std::vector<IntegrationBenchmarkResult> results{};
+    _state.BeginFrame();
+    const auto* scene = _state.GetCurrentScene();
+    if(!scene || !scene->GetBodyCount() || !_desc.steps) {
+        return results;
+    }
+    auto initial = BodyIntegrationState{};
+    initial.Gather(*scene);
+    const auto params = IntegrationParams{};
+    auto reference = BodyIntegrationState{};
+    for(std::size_t i = 0u; i < static_cast<std::size_t>(IntegratorKernel::Max); ++i) {
+        const auto kernel = static_cast<IntegratorKernel>(i);
+        if(!IsIntegratorKernelSupported(kernel)) {
+            continue;
+        }
+        auto state = initial;
+        const auto start = clock::now();
+        for(std::size_t step = 0u; step < _desc.steps; ++step) {
+            state.Integrate(kernel, params, _desc.timestep);
+        }
+        const auto elapsed = clock::now() - start;
+        auto result = IntegrationBenchmarkResult{};
+        result.kernel = kernel;
+        result.nanoseconds_per_body = ns{elapsed}.count() / static_cast<double>(_desc.steps * state.GetBodyCount());
+        //Scalar always runs first and is the reference.
+        if(kernel == IntegratorKernel::Scalar) {
+            reference = std::move(state);
+        } else {
+            result.max_difference = state.CalcMaxDifference(reference);
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+std::vector<BroadphaseBenchmarkResult> HeadlessSimulation::BenchmarkBroadphase(const BroadphaseDesc& broadphase) noexcept {
+    using clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+
+    constexpr auto type_count = static_cast<std::size_t>(BroadphaseType::Max);
+    std::vector<BroadphaseBenchmarkResult> results(type_count);
+    std::array<std::unique_ptr<IBroadphase>, type_count> broadphases{};
+    _state.BeginFrame();
+    const auto* scene = _state.GetCurrentScene();
+    if(!scene || !_desc.steps) {
+        return {};
+    }
+    for(std::size_t i = 0u; i < type_count; ++i) {
+        auto desc = broadphase;
+        desc.type = static_cast<BroadphaseType>(i);
+        broadphases[i] = CreateBroadphase(desc, scene->GetPhysicsDescription().world_bounds);
+        results[i].type = desc.type;
+    }
+    auto bounds = std::vector<AABB2>{};
+    auto pairs = std::vector<BroadphasePair>{};
+    for(std::size_t step = 0u; step < _desc.steps; ++step) {
+        Step();
+        scene = _state.GetCurrentScene();
+        if(!scene) {
+            break;
+        }
+        scene->CalcBodyBounds(bounds);
+        auto quadtree_pair_count = std::size_t{};
+        for(std::size_t i = 0u; i < type_count; ++i) {
+            auto& result = results[i];
+            const auto build_start = clock::now();
+            broadphases[i]->Build(bounds);
+            const auto find_start = clock::now();
+            broadphases[i]->FindPairs(pairs);
+            const auto find_end = clock::now();
+            result.build_milliseconds += ms{find_start - build_start}.count();
+            result.find_pairs_milliseconds += ms{find_end - find_start}.count();
+            result.pairs_per_step += static_cast<double>(pairs.size());
+            result.cells_per_step += static_cast<double>(broadphases[i]->GetCellCount());
+            if(result.type == BroadphaseType::Quadtree) {
+                quadtree_pair_count = pairs.size();
+            } else if(pairs.size() != quadtree_pair_count) {
+                ++result.mismatched_steps;
+            }
+        }
+    }
+    const auto steps = static_cast<double>(_desc.steps);
+    for(auto& result : results) {
+        result.build_milliseconds /= steps;
+        result.find_pairs_milliseconds /= steps;
+        result.pairs_per_step /= steps;
+        result.cells_per_step /= steps;
+    }
+    return results;
+}
+
+std::vector<ContactBenchmarkResult> HeadlessSimulation::BenchmarkContacts(const ContactCacheDesc& contacts) noexcept {
+    std::vector<ContactBenchmarkResult> results(2u);
+    std::array<ContactCache, 2u> caches{};
+    for(std::size_t i = 0u; i < caches.size(); ++i) {
+        auto desc = contacts;
+        desc.persistent = i != 0u;
+        caches[i].SetDescription(desc);
+        results[i].persistent = desc.persistent;
+    }
+    _state.BeginFrame();
+    if(!_state.GetCurrentScene() || !_desc.steps) {
+        return {};
+    }
+    for(std::size_t step = 0u; step < _desc.steps; ++step) {
+        Step();
+        auto* scene = _state.GetCurrentScene();
+        if(!scene) {
+            break;
+        }
+        //Built once up front so no cache's time includes the shared broadphase.
+        [[maybe_unused]] const auto& broadphase = scene->UpdateBroadphase();
+        for(std::size_t i = 0u; i < caches.size(); ++i) {
+            caches[i].Update(*scene);
+            const auto& stats = caches[i].GetStats();
+            auto& result = results[i];
+            result.update_milliseconds += stats.update_ms;
+            result.pairs_per_step += static_cast<double>(stats.pair_count);
+            result.points_per_step += static_cast<double>(stats.point_count);
+            result.narrowphase_fraction += static_cast<double>(stats.added_pair_count + stats.separated_pair_count + stats.recomputed_pair_count);
+        }
+    }
+    const auto steps = static_cast<double>(_desc.steps);
+    for(auto& result : results) {
+        result.narrowphase_fraction = result.pairs_per_step > 0.0 ? result.narrowphase_fraction / result.pairs_per_step : 0.0;
+        result.update_milliseconds /= steps;
+        result.pairs_per_step /= steps;
+        result.points_per_step /= steps;
+    }
+    return results;
+}
+
+std::vector<NarrowphaseBenchmarkResult> HeadlessSimulation::BenchmarkNarrowphase(const ContactCacheDesc& contacts) noexcept {
+    std::vector<NarrowphaseBenchmarkResult> results(3u);
+    std::array<ContactCache, 3u> caches{};
+    for(std::size_t i = 0u; i < caches.size(); ++i) {
+        auto desc = contacts;
+        //Every pair that moved at all runs the narrowphase.
+        desc.persistent = true;
+        desc.refresh_distance = 0.0f;
+        desc.refresh_degrees = 0.0f;
+        desc.world_shapes = i != 0u;
+        desc.cache_axes = i == 2u;
+        caches[i].SetDescription(desc);
+        results[i].world_shapes = desc.world_shapes;
+        results[i].cache_axes = desc.cache_axes;
+    }
+    _state.BeginFrame();
+    if(!_state.GetCurrentScene() || !_desc.steps) {
+        return {};
+    }
+    for(std::size_t step = 0u; step < _desc.steps; ++step) {
+        Step();
+        auto* scene = _state.GetCurrentScene();
+        if(!scene) {
+            break;
+        }
+        //Built once up front so no cache's time includes the shared broadphase.
+        [[maybe_unused]] const auto& broadphase = scene->UpdateBroadphase();
+        for(std::size_t i = 0u; i < caches.size(); ++i) {
+            caches[i].Update(*scene);
+            const auto& stats = caches[i].GetStats();
+            auto& result = results[i];
+            result.update_milliseconds += stats.update_ms;
+            result.narrowphase_pairs_per_step += static_cast<double>(stats.added_pair_count + stats.separated_pair_count + stats.recomputed_pair_count);
+            result.axis_rejected_per_step += static_cast<double>(stats.separated_pair_count);
+            result.points_per_step += static_cast<double>(stats.point_count);
+            if(stats.point_count != caches[0].GetStats().point_count) {
+                ++result.mismatched_steps;
+            }
+        }
+    }
+    const auto steps = static_cast<double>(_desc.steps);
+    for(auto& result : results) {
+        result.update_milliseconds /= steps;
+        result.narrowphase_pairs_per_step /= steps;
+        result.axis_rejected_per_step /= steps;
+        result.points_per_step /= steps;
+    }
+    return results;
+}
+
+QueryBenchmarkResult HeadlessSimulation::BenchmarkQueries(std::size_t query_count) noexcept {
+    using clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+
+    auto result = QueryBenchmarkResult{};
+    result.queries_per_step = query_count;
+    _state.BeginFrame();
+    if(!_state.GetCurrentScene() || !_desc.steps || !query_count) {
+        return result;
+    }
+    const auto bounds = _state.GetCurrentScene()->GetPhysicsDescription().world_bounds;
+    const auto ray_length = (bounds.maxs.x - bounds.mins.x) * 0.1f;
+    //Fixed seed so runs are comparable.
+    std::mt19937 rng{0u};
+    std::uniform_real_distribution<float> x_dist{bounds.mins.x, bounds.maxs.x};
+    std::uniform_real_distribution<float> y_dist{bounds.mins.y, bounds.maxs.y};
+    std::uniform_real_distribution<float> angle_dist{0.0f, 6.2831853f};
+    auto points = std::vector<Vector2>(query_count);
+    auto rays = std::vector<SceneRay>(query_count);
+    auto hits = std::vector<SceneQueryHit>{};
+    auto overlaps = SceneOverlapResults{};
+    auto query = SceneQuery{};
+    const auto count_hits = [&hits]() {
+        return static_cast<double>(std::count_if(std::begin(hits), std::end(hits), [](const SceneQueryHit& hit) { return hit.hit; }));
+    };
+    for(std::size_t step = 0u; step < _desc.steps; ++step) {
+        Step();
+        auto* scene = _state.GetCurrentScene();
+        if(!scene) {
+            break;
+        }
+        for(std::size_t i = 0u; i < query_count; ++i) {
+            points[i] = Vector2{x_dist(rng), y_dist(rng)};
+            const auto angle = angle_dist(rng);
+            rays[i] = SceneRay{points[i], points[i] + Vector2{std::cos(angle), std::sin(angle)} * ray_length};
+        }
+        const auto rebuild_start = clock::now();
+        query.Rebuild(*scene);
+        const auto pick_start = clock::now();
+        query.PickPoints(points, hits);
+        const auto pick_end = clock::now();
+        result.pick_hit_rate += count_hits();
+        query.CastRays(rays, hits);
+        const auto ray_end = clock::now();
+        result.ray_hit_rate += count_hits();
+        query.FindNearest(points, ray_length, hits);
+        const auto nearest_end = clock::now();
+        result.nearest_hit_rate += count_hits();
+        query.OverlapCircles(points, ray_length * 0.1f, overlaps);
+        const auto overlap_end = clock::now();
+        result.bodies_per_overlap += static_cast<double>(overlaps.bodies.size());
+        result.rebuild_milliseconds += ms{pick_start - rebuild_start}.count();
+        result.pick_milliseconds += ms{pick_end - pick_start}.count();
+        result.ray_milliseconds += ms{ray_end - pick_end}.count();
+        result.nearest_milliseconds += ms{nearest_end - ray_end}.count();
+        result.overlap_milliseconds += ms{overlap_end - nearest_end}.count();
+    }
+    const auto steps = static_cast<double>(_desc.steps);
+    const auto queries = steps * static_cast<double>(query_count);
+    result.rebuild_milliseconds /= steps;
+    result.pick_milliseconds /= steps;
+    result.ray_milliseconds /= steps;
+    result.nearest_milliseconds /= steps;
+    result.overlap_milliseconds /= steps;
+    result.pick_hit_rate /= queries;
+    result.ray_hit_rate /= queries;
+    result.nearest_hit_rate /= queries;
+    result.bodies_per_overlap /= queries;
+    return result;
+}
+
+void HeadlessSimulation::Step() noexcept {
+    _state.BeginFrame();
+    StepPhysics(_desc.timestep);
+    _state.EndFrame();
+    if(_desc.debug_draw) {
+        DrawDebugShapes();
+    }
+}
+
+void HeadlessSimulation::StepPhysics(TimeUtils::FPSeconds timestep) noexcept {
+    PROFILE_STAGE(ProfileStage::Physics);
+    g_thePhysicsSystem->BeginFrame();
+    g_thePhysicsSystem->Update(timestep);
+    g_thePhysicsSystem->EndFrame();
+    _state.AfterPhysicsStep(timestep);
+}
+
+void HeadlessSimulation::DrawDebugShapes() noexcept {
+    PROFILE_STAGE(ProfileStage::StateRender);
+    const auto* scene = _state.GetCurrentScene();
+    if(!scene) {
+        return;
+    }
+    //No camera, so cull against the whole world.
+    _debug_shapes.Begin(g_thePhysicsSystem->GetWorldDescription().world_bounds);
+    _debug_shapes.AddScene(*scene);
+    for(std::size_t i = 0u; i < static_cast<std::size_t>(DebugShapeType::Max); ++i) {
+        _debug_shape_count += _debug_shapes.GetShapeCount(static_cast<DebugShapeType>(i));
+    }
+    _debug_shapes.Submit(_debug_sink);
+}
+
+JointStabilityResult HeadlessSimulation::CheckJointStability() noexcept {
+    auto result = JointStabilityResult{};
+    _state.BeginFrame();
+    const auto* solver = _state.GetCurrentJointSolver();
+    if(!solver || !solver->GetStats().joint_count || _desc.steps < 10u) {
+        return result;
+    }
+    result.joint_count = solver->GetStats().joint_count;
+    const auto tenth = _desc.steps / 10u;
+    for(std::size_t step = 0u; step < _desc.steps; ++step) {
+        Step();
+        solver = _state.GetCurrentJointSolver();
+        if(!solver) {
+            break;
+        }
+        const auto& stats = solver->GetStats();
+        const auto error = stats.initial_error;
+        result.max_initial_error = (std::max)(result.max_initial_error, error);
+        if(tenth <= step && step < tenth * 2u) {
+            result.settled_initial_error = (std::max)(result.settled_initial_error, error);
+        }
+        if(_desc.steps - tenth <= step) {
+            result.final_initial_error = (std::max)(result.final_initial_error, error);
+        }
+        if(stats.iterations_used >= solver->GetDescription().max_iterations && stats.residual_error > solver->GetDescription().tolerance) {
+            ++result.unconverged_steps;
+        }
+        ++result.steps;
+    }
+    const auto limit = result.settled_initial_error * 2.0f + (solver ? solver->GetDescription().tolerance : 0.0f);
+    result.is_bounded = result.steps == _desc.steps && result.final_initial_error <= limit;
+    return result;
+}
+
+ContactSolverResult HeadlessSimulation::CheckContactSolver() noexcept {
+    auto result = ContactSolverResult{};
+    _state.BeginFrame();
+    if(!_state.GetCurrentContactSolver()) {
+        return result;
+    }
+    auto warm_started = 0.0;
+    auto points = 0.0;
+    for(std::size_t step = 0u; step < _desc.steps; ++step) {
+        Step();
+        const auto* solver = _state.GetCurrentContactSolver();
+        if(!solver) {
+            break;
+        }
+        const auto& stats = solver->GetStats();
+        points += static_cast<double>(stats.point_count);
+        warm_started += static_cast<double>(stats.warm_started_point_count);
+        result.iterations_per_step += static_cast<double>(stats.iterations_used);
+        result.solve_milliseconds += static_cast<double>(stats.solve_ms);
+        result.max_residual_change = (std::max)(result.max_residual_change, stats.residual_change);
+        if(stats.iterations_used >= solver->GetDescription().max_iterations && stats.residual_change > solver->GetDescription().tolerance) {
+            ++result.unconverged_steps;
+        }
+        ++result.steps;
+    }
+    if(result.steps) {
+        const auto steps = static_cast<double>(result.steps);
+        result.points_per_step = points / steps;
+        result.iterations_per_step /= steps;
+        result.solve_milliseconds /= steps;
+    }
+    result.warm_started_fraction = points > 0.0 ? warm_started / points : 0.0;
+    return result;
+}
+
+NarrowphaseBenchmarkResult HeadlessSimulation::BenchmarkContactPath(std::vector<std::size_t>& point_counts) noexcept {
+    auto result = NarrowphaseBenchmarkResult{};
+    result.solved = true;
+    point_counts.clear();
+    _state.BeginFrame();
+    if(!_state.GetCurrentContactCache() || !_desc.steps) {
+        return result;
+    }
+    point_counts.reserve(_desc.steps);
+    for(std::size_t step = 0u; step < _desc.steps; ++step) {
+        Step();
+        const auto* cache = _state.GetCurrentContactCache();
+        const auto* solver = _state.GetCurrentContactSolver();
+        if(!cache || !solver) {
+            break;
+        }
+        const auto& stats = cache->GetStats();
+        result.update_milliseconds += stats.update_ms;
+        result.narrowphase_pairs_per_step += static_cast<double>(stats.added_pair_count + stats.separated_pair_count + stats.recomputed_pair_count);
+        result.axis_rejected_per_step += static_cast<double>(stats.separated_pair_count);
+        result.points_per_step += static_cast<double>(stats.point_count);
+        result.solve_milliseconds += solver->GetStats().solve_ms;
+        point_counts.push_back(stats.point_count);
+    }
+    const auto steps = static_cast<double>(_desc.steps);
+    result.update_milliseconds /= steps;
+    result.narrowphase_pairs_per_step /= steps;
+    result.axis_rejected_per_step /= steps;
+    result.points_per_step /= steps;
+    result.solve_milliseconds /= steps;
+    return result;
+}
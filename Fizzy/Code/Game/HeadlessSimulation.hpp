@@ -0,0 +1,213 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Game/BodyIntegrator.hpp"
+#include "Game/Broadphase.hpp"
+#include "Game/ContactCache.hpp"
+#include "Game/DebugDraw.hpp"
+#include "Game/GameGuid.hpp"
+#include "Game/GameStateMachine.hpp"
+#include "Game/GameStateGravityDrag.hpp"
+#include "Game/InputRecorder.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct HeadlessSimulationDesc {
+    GUID stateId = GameStateGravityDrag::ID;
+    std::size_t steps = 1000u;
+    TimeUtils::FPSeconds timestep = TimeUtils::FPSeconds{1.0f / 60.0f};
+    //Batch the scene's collision outlines every step into a recording sink.
+    bool debug_draw = false;
+};
+
+struct HeadlessSimulationResult {
+    std::size_t steps = 0u;
+    //Bodies in the state's scene once it was built; 0 if it has none.
+    std::size_t body_count = 0u;
+    double setup_milliseconds = 0.0;
+    double total_seconds = 0.0;
+    double steps_per_second = 0.0;
+    double milliseconds_per_step = 0.0;
+    //Heap allocations during the timed steps. Zero unless operator new
+    //records them; see AllocationCounter.hpp.
+    double allocations_per_step = 0.0;
+    double allocated_bytes_per_step = 0.0;
+    //Only filled in when HeadlessSimulationDesc::debug_draw is set.
+    double debug_draws_per_step = 0.0;
+    double debug_shapes_per_step = 0.0;
+    double debug_vertices_per_step = 0.0;
+};
+
+struct HeadlessReplayResult {
+    std::size_t frames = 0u;
+    std::size_t events = 0u;
+    double setup_milliseconds = 0.0;
+    double total_seconds = 0.0;
+    double milliseconds_per_frame = 0.0;
+    double max_milliseconds_per_frame = 0.0;
+    //Frames whose world hash differs from the recording's.
+    std::size_t divergent_frames = 0u;
+    //Index of the first of them, or frames if the replay matched throughout.
+    std::size_t first_divergent_frame = 0u;
+};
+
+struct IntegrationBenchmarkResult {
+    IntegratorKernel kernel{IntegratorKernel::Scalar};
+    double nanoseconds_per_body = 0.0;
+    //Largest difference from the scalar kernel's positions and velocities after the last step.
+    float max_difference = 0.0f;
+};
+
+struct BroadphaseBenchmarkResult {
+    BroadphaseType type{BroadphaseType::Quadtree};
+    double build_milliseconds = 0.0;
+    double find_pairs_milliseconds = 0.0;
+    double pairs_per_step = 0.0;
+    double cells_per_step = 0.0;
+    //Steps where this broadphase found a different number of pairs than the quadtree.
+    std::size_t mismatched_steps = 0u;
+};
+
+struct ContactBenchmarkResult {
+    bool persistent = false;
+    //Per step, averaged over the steps.
+    double update_milliseconds = 0.0;
+    double pairs_per_step = 0.0;
+    double points_per_step = 0.0;
+    //Fraction of pairs that ran the narrowphase instead of being refreshed or left asleep.
+    double narrowphase_fraction = 0.0;
+};
+
+struct NarrowphaseBenchmarkResult {
+    bool world_shapes = false;
+    bool cache_axes = false;
+    //Timed on the state's own cache while its contact solver used the manifolds.
+    bool solved = false;
+    //Per step, averaged over the steps.
+    double update_milliseconds = 0.0;
+    //Pairs that ran the narrowphase, and those of them rejected by their cached separating axis.
+    double narrowphase_pairs_per_step = 0.0;
+    double axis_rejected_per_step = 0.0;
+    double points_per_step = 0.0;
+    //Steps where this path found a different number of contact points than the first.
+    std::size_t mismatched_steps = 0u;
+    //Per step, averaged over the steps; only when solved.
+    double solve_milliseconds = 0.0;
+};
+
+struct QueryBenchmarkResult {
+    std::size_t queries_per_step = 0u;
+    //Milliseconds per step, averaged over the steps.
+    double rebuild_milliseconds = 0.0;
+    double pick_milliseconds = 0.0;
+    double ray_milliseconds = 0.0;
+    double nearest_milliseconds = 0.0;
+    double overlap_milliseconds = 0.0;
+    //Fraction of queries that found a body, and bodies per overlap query.
+    double pick_hit_rate = 0.0;
+    double ray_hit_rate = 0.0;
+    double nearest_hit_rate = 0.0;
+    double bodies_per_overlap = 0.0;
+};
+
+struct JointStabilityResult {
+    std::size_t steps = 0u;
+    std::size_t joint_count = 0u;
+    //Worst length error, in px, the joint solver started a step with: over
+    //the second tenth of the steps, once the release has settled, over the
+    //last tenth, and over the whole run.
+    float settled_initial_error = 0.0f;
+    float final_initial_error = 0.0f;
+    float max_initial_error = 0.0f;
+    //Steps that used every iteration without reaching the tolerance.
+    std::size_t unconverged_steps = 0u;
+    //The last tenth's worst error stayed within twice the second tenth's, plus the tolerance.
+    bool is_bounded = false;
+};
+
+struct ContactSolverResult {
+    std::size_t steps = 0u;
+    //Per step, averaged over the steps.
+    double points_per_step = 0.0;
+    double iterations_per_step = 0.0;
+    double solve_milliseconds = 0.0;
+    //Fraction of points that started their step from a carried impulse.
+    double warm_started_fraction = 0.0;
+    //Steps that used every iteration without reaching the tolerance, and the
+    //largest impulse change any step ended on.
+    std::size_t unconverged_steps = 0u;
+    float max_residual_change = 0.0f;
+};
+
+//Accepts a demo name ("GravityDrag", "Constraints", "SleepManagement", "Stress")
+//or a registry-format GUID string ("{4A8529AB-0CCE-44A4-B039-6ADEB8D270E0}").
+[[nodiscard]] bool TryParseStateId(const std::string& text, GUID& out_id) noexcept;
+//Runs the Stress state once per narrowphase path, each on a fresh
+//simulation for desc.steps steps, with its contact solver using the
+//manifolds, and times the state's own contact cache and solver. The Stress
+//description's refresh settings are kept, so this measures the path a
+//solved scene actually takes.
+[[nodiscard]] std::vector<NarrowphaseBenchmarkResult> BenchmarkSolvedNarrowphase(const HeadlessSimulationDesc& desc) noexcept;
+
+//Drives a GameStateMachine and the physics system at a fixed step without
+//a window. Only the simulation side of a state is exercised: BeginFrame/EndFrame
+//and the physics step. IState::Update and IState::Render, which own input,
+//ImGui and drawing, are never called, so g_theRenderer, g_theInputSystem and
+//g_theUISystem are allowed to be null.
+class HeadlessSimulation {
+public:
+    explicit HeadlessSimulation(const HeadlessSimulationDesc& desc) noexcept;
+    HeadlessSimulation(const HeadlessSimulation& other) = delete;
+    HeadlessSimulation(HeadlessSimulation&& other) = delete;
+    HeadlessSimulation& operator=(const HeadlessSimulation& other) = delete;
+    HeadlessSimulation& operator=(HeadlessSimulation&& other) = delete;
+    ~HeadlessSimulation() = default;
+
+    [[nodiscard]] HeadlessSimulationResult Run() noexcept;
+    //Replays a recording of the state the simulation was created for, as fast
+    //as possible: each frame applies its events and takes its recorded steps,
+    //then the world hash is compared with the recorded one.
+    [[nodiscard]] HeadlessReplayResult Replay(const InputRecording& recording) noexcept;
+    //Enters the state, then integrates a structure-of-arrays copy of its
+    //bodies for desc.steps steps with every kernel the CPU supports.
+    [[nodiscard]] std::vector<IntegrationBenchmarkResult> BenchmarkIntegration() noexcept;
+    //Runs the state for desc.steps steps and times every broadphase building
+    //and finding pairs over the same body bounds after each step.
+    [[nodiscard]] std::vector<BroadphaseBenchmarkResult> BenchmarkBroadphase(const BroadphaseDesc& broadphase) noexcept;
+    //Runs the state for desc.steps steps and updates a contact cache with and
+    //without persistence after each one.
+    [[nodiscard]] std::vector<ContactBenchmarkResult> BenchmarkContacts(const ContactCacheDesc& contacts) noexcept;
+    //Runs the state for desc.steps steps and after each one updates contact
+    //caches that recompute every pair that moved, building shapes per pair,
+    //building world shapes per body, and also testing cached separating axes.
+    [[nodiscard]] std::vector<NarrowphaseBenchmarkResult> BenchmarkNarrowphase(const ContactCacheDesc& contacts) noexcept;
+    //Runs the state for desc.steps steps and after each one rebuilds a
+    //SceneQuery and times query_count batched picks, rays, nearest-body and
+    //circle overlap queries at random points in the world.
+    [[nodiscard]] QueryBenchmarkResult BenchmarkQueries(std::size_t query_count) noexcept;
+    //Runs the state for desc.steps steps and tracks the error its parallel
+    //joint solver starts each step with. A warm start that builds up across
+    //steps shows as an error that keeps growing after the joints settle.
+    [[nodiscard]] JointStabilityResult CheckJointStability() noexcept;
+    //Runs the state for desc.steps steps and tracks how many iterations its
+    //contact solver needs and how many points it warm starts.
+    [[nodiscard]] ContactSolverResult CheckContactSolver() noexcept;
+    //Runs the state for desc.steps steps and times its own contact cache and
+    //solver from their stats, recording the contact points of every step.
+    [[nodiscard]] NarrowphaseBenchmarkResult BenchmarkContactPath(std::vector<std::size_t>& point_counts) noexcept;
+
+protected:
+private:
+    void Step() noexcept;
+    void StepPhysics(TimeUtils::FPSeconds timestep) noexcept;
+    void DrawDebugShapes() noexcept;
+
+    HeadlessSimulationDesc _desc{};
+    GameStateMachine _state{};
+    DebugShapeBatch _debug_shapes{};
+    RecordingDebugDrawSink _debug_sink{};
+    std::size_t _debug_shape_count{};
+};
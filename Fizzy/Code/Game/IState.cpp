@@ -0,0 +1,15 @@
+#include "Game/IState.hpp"
+
+#include "Game/InputRecorder.hpp"
+
+void IState::SubmitEvent(const RecordedEvent& event) noexcept {
+    if(_event_queue) {
+        _event_queue->push_back(event);
+    } else {
+        ApplyRecordedEvent(event);
+    }
+}
+
+void IState::SetEventQueue(std::vector<RecordedEvent>* queue) noexcept {
+    _event_queue = queue;
+}
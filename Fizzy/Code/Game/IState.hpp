@@ -2,10 +2,43 @@
 
 #include "Engine/Core/TimeUtils.hpp"
 
+#include "Engine/Math/IntVector2.hpp"
+
+#include <atomic>
+#include <vector>
+
+class ContactCache;
+class ContactSolver;
+class DebugShapeBatch;
+class ParallelJointSolver;
+class Scene;
+struct RecordedEvent;
+
+//Written by IState::OnLoad on the loading thread, read by the frame thread.
+struct LoadProgress {
+    std::atomic<float> fraction{0.0f};
+};
+
+//Taken on the frame thread before IState::OnLoad, so a load on the loading
+//thread never reads the renderer for them.
+struct LoadContext {
+    IntVector2 world_dimensions{};
+};
+
 class IState {
 public:
     virtual ~IState() = default;
 
+    //Called on the frame thread just before OnLoad. Copy anything the load
+    //reads that the running state or its UI may change in the meantime.
+    virtual void BeforeLoad() noexcept {
+        /* DO NOTHING */
+    }
+    //Builds the state's world before OnEnter. May run on a loading thread while
+    //the previous state is still running, so it must not touch the engine systems.
+    virtual void OnLoad([[maybe_unused]] const LoadContext& context, [[maybe_unused]] LoadProgress& progress) noexcept {
+        /* DO NOTHING */
+    }
     virtual void OnEnter() noexcept = 0;
     virtual void OnExit() noexcept = 0;
     virtual void BeginFrame() noexcept = 0;
@@ -13,7 +46,55 @@ public:
     virtual void Render() const noexcept = 0;
     virtual void EndFrame() noexcept = 0;
 
+    //The scene stepped by the state machine's fixed-step mode and restored on
+    //restart, if the state has one.
+    [[nodiscard]] virtual Scene* GetScene() noexcept {
+        return nullptr;
+    }
+    //The state's parallel joint solver, if it has one, for reporting its convergence.
+    [[nodiscard]] virtual const ParallelJointSolver* GetJointSolver() const noexcept {
+        return nullptr;
+    }
+    //The state's contact cache while it runs, for reporting its work.
+    [[nodiscard]] virtual const ContactCache* GetContactCache() const noexcept {
+        return nullptr;
+    }
+    //The state's contact solver while it is solving, for reporting its convergence.
+    [[nodiscard]] virtual const ContactSolver* GetContactSolver() const noexcept {
+        return nullptr;
+    }
+    //False forces a restart to rebuild the state instead of restoring its scene's snapshot.
+    [[nodiscard]] virtual bool CanRestartInPlace() const noexcept {
+        return true;
+    }
+    //Applies a player action that changes the world. Live input and replays both
+    //come through here so a recording reproduces the session.
+    virtual void ApplyRecordedEvent([[maybe_unused]] const RecordedEvent& event) noexcept {
+        /* DO NOTHING */
+    }
+    //Applies a live player action now or, while the state machine steps the
+    //scene on its simulation thread, queues it for that thread to apply before
+    //its next step. Input should come through here rather than changing bodies directly.
+    void SubmitEvent(const RecordedEvent& event) noexcept;
+    //Set by the state machine before each Update; nullptr applies events at once.
+    void SetEventQueue(std::vector<RecordedEvent>* queue) noexcept;
+    //Adds shapes drawn over the scene that come from data the physics steps
+    //produce, e.g. contact points, to the render snapshot being published.
+    //Runs on the simulation thread when there is one.
+    virtual void AddRenderOverlay([[maybe_unused]] DebugShapeBatch& overlay) const noexcept {
+        /* DO NOTHING */
+    }
+    //Called after each physics step with the time it covered. In variable-step
+    //mode the engine steps physics itself and this is called once per frame.
+    virtual void AfterPhysicsStep([[maybe_unused]] TimeUtils::FPSeconds timestep) noexcept {
+        /* DO NOTHING */
+    }
+    //Called after a restart restored the scene's snapshot in place of OnLoad and OnEnter.
+    virtual void OnRestart() noexcept {
+        /* DO NOTHING */
+    }
+
 protected:
 private:
-    
+    std::vector<RecordedEvent>* _event_queue{};
 };
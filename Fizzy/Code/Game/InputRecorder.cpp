@@ -0,0 +1,184 @@
+#include "Game/InputRecorder.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+InputRecorder g_theInputRecorder{};
+
+namespace {
+
+template<typename T>
+void WriteRecords(std::ofstream& ofs, const T* records, std::size_t count) noexcept {
+    if(count) {
+        ofs.write(reinterpret_cast<const char*>(records), static_cast<std::streamsize>(sizeof(T) * count));
+    }
+}
+
+template<typename T>
+bool ReadRecords(std::ifstream& ifs, std::vector<T>& records, std::size_t count) noexcept {
+    records.resize(count);
+    if(count) {
+        ifs.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(sizeof(T) * count));
+    }
+    return static_cast<bool>(ifs);
+}
+
+//Ten times the largest body count the game or the benchmark suite asks for,
+//so a corrupt count fails here instead of exhausting memory building the scene.
+constexpr std::size_t max_stress_body_count = 1000000u;
+
+//Byte offsets of every bool in StressSceneDesc. A bool's byte must be 0 or 1
+//before the desc is copied out, or reading it is undefined.
+constexpr std::array<std::size_t, 9> stress_bool_offsets{
+    offsetof(StressSceneDesc, parallel_joints)
+    , offsetof(StressSceneDesc, load_scene_file)
+    , offsetof(StressSceneDesc, sleep) + offsetof(IslandSleepDesc, enabled)
+    , offsetof(StressSceneDesc, joints) + offsetof(JointSolverDesc, warm_start)
+    , offsetof(StressSceneDesc, contacts) + offsetof(ContactCacheDesc, persistent)
+    , offsetof(StressSceneDesc, contacts) + offsetof(ContactCacheDesc, world_shapes)
+    , offsetof(StressSceneDesc, contacts) + offsetof(ContactCacheDesc, cache_axes)
+    , offsetof(StressSceneDesc, solve_contacts)
+    , offsetof(StressSceneDesc, contact_solver) + offsetof(ContactSolverDesc, warm_start)
+};
+
+//The desc is raw bytes in the file, so reject any the Stress state cannot build.
+bool ReadStressDesc(std::ifstream& ifs, StressSceneDesc& stress) noexcept {
+    auto bytes = std::array<unsigned char, sizeof(StressSceneDesc)>{};
+    ifs.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if(!ifs) {
+        return false;
+    }
+    for(const auto offset : stress_bool_offsets) {
+        if(bytes[offset] > 1u) {
+            return false;
+        }
+    }
+    auto desc = StressSceneDesc{};
+    std::memcpy(&desc, bytes.data(), sizeof(desc));
+    const auto weights = std::array<int, 4>{desc.circle_weight, desc.aabb_weight, desc.obb_weight, desc.polygon_weight};
+    for(const auto weight : weights) {
+        if(weight < 0) {
+            return false;
+        }
+    }
+    const auto is_valid = desc.distribution >= StressDistribution::Uniform
+                          && desc.distribution <= StressDistribution::Ropes
+                          && desc.broadphase.type < BroadphaseType::Max
+                          && desc.body_count <= max_stress_body_count
+                          && desc.rope_links <= max_stress_body_count
+                          && desc.spawn_per_frame <= max_stress_body_count
+                          && (desc.circle_weight || desc.aabb_weight || desc.obb_weight || desc.polygon_weight)
+                          && std::isfinite(desc.body_radius) && desc.body_radius > 0.0f;
+    if(!is_valid) {
+        return false;
+    }
+    stress = desc;
+    return true;
+}
+
+} // namespace
+
+bool InputRecording::Save(const std::filesystem::path& filepath) const noexcept {
+    auto header = InputRecordingHeader{};
+    header.version = current_version;
+    header.stress_desc_size = static_cast<uint32_t>(sizeof(StressSceneDesc));
+    header.frame_record_size = static_cast<uint32_t>(sizeof(RecordedFrame));
+    header.event_record_size = static_cast<uint32_t>(sizeof(RecordedEvent));
+    header.frame_count = static_cast<uint32_t>(frames.size());
+    header.event_count = static_cast<uint32_t>(events.size());
+    header.step_seconds = step.count();
+    header.state_id = state_id;
+
+    std::error_code ec{};
+    if(filepath.has_parent_path()) {
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+    }
+    std::ofstream ofs{filepath, std::ios_base::binary | std::ios_base::trunc};
+    if(!ofs) {
+        return false;
+    }
+    WriteRecords(ofs, &header, 1u);
+    WriteRecords(ofs, &stress, 1u);
+    WriteRecords(ofs, frames.data(), frames.size());
+    WriteRecords(ofs, events.data(), events.size());
+    return static_cast<bool>(ofs);
+}
+
+bool InputRecording::Load(const std::filesystem::path& filepath) noexcept {
+    std::ifstream ifs{filepath, std::ios_base::binary};
+    if(!ifs) {
+        return false;
+    }
+    auto header = InputRecordingHeader{};
+    ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!ifs || std::memcmp(header.magic, InputRecordingHeader{}.magic, sizeof(header.magic)) != 0) {
+        return false;
+    }
+    if(header.version != current_version
+       || header.stress_desc_size != sizeof(StressSceneDesc)
+       || header.frame_record_size != sizeof(RecordedFrame)
+       || header.event_record_size != sizeof(RecordedEvent)
+       || !(header.step_seconds > 0.0f)) {
+        return false;
+    }
+    if(!ReadStressDesc(ifs, stress) || !ReadRecords(ifs, frames, header.frame_count) || !ReadRecords(ifs, events, header.event_count)) {
+        return false;
+    }
+    //Event types are raw bytes in the file, so reject any a state cannot apply.
+    for(const auto& event : events) {
+        if(event.type >= RecordedEventType::Max) {
+            return false;
+        }
+    }
+    state_id = header.state_id;
+    step = TimeUtils::FPSeconds{header.step_seconds};
+    return true;
+}
+
+void InputRecorder::Begin(const GUID& state_id, TimeUtils::FPSeconds step) noexcept {
+    _recording.state_id = state_id;
+    _recording.step = step;
+    _recording.stress = GameStateStress::GetSceneDescription();
+    _recording.frames.clear();
+    _recording.events.clear();
+    _is_recording = true;
+}
+
+void InputRecorder::Stop() noexcept {
+    _is_recording = false;
+}
+
+bool InputRecorder::IsRecording() const noexcept {
+    return _is_recording;
+}
+
+RecordedEvent InputRecorder::Record(RecordedEventType type, const Vector2& point, uint32_t index /*= 0u*/, uint32_t sub_index /*= 0u*/) noexcept {
+    auto event = RecordedEvent{};
+    event.frame = static_cast<uint32_t>(_recording.frames.size());
+    event.index = index;
+    event.sub_index = sub_index;
+    event.type = type;
+    event.point = point;
+    if(_is_recording) {
+        _recording.events.push_back(event);
+    }
+    return event;
+}
+
+void InputRecorder::EndFrame(int substeps, uint64_t world_hash) noexcept {
+    if(!_is_recording) {
+        return;
+    }
+    auto frame = RecordedFrame{};
+    frame.substeps = static_cast<uint32_t>(substeps);
+    frame.world_hash = world_hash;
+    _recording.frames.push_back(frame);
+}
+
+const InputRecording& InputRecorder::GetRecording() const noexcept {
+    return _recording;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Math/Vector2.hpp"
+
+#include "Game/GameGuid.hpp"
+#include "Game/GameStateStress.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <type_traits>
+#include <vector>
+
+//Everything a player can do that changes the world. States apply these
+//through IState::ApplyRecordedEvent, both live and during a replay.
+enum class RecordedEventType : uint8_t {
+    ApplyImpulse //index: body, point: mouse position
+    , AddBody //point: mouse position
+    , DetachJoint //index: joint, sub_index: 0 for body A, 1 for body B
+    , FireProjectile //point: launch velocity, sub_index: 1 if the projectile uses continuous collision
+    , Max
+};
+
+struct RecordedEvent {
+    uint32_t frame{};
+    uint32_t index{};
+    uint32_t sub_index{};
+    RecordedEventType type{RecordedEventType::Max};
+    Vector2 point{};
+};
+
+struct RecordedFrame {
+    //Fixed steps taken this frame.
+    uint32_t substeps{};
+    uint32_t reserved{};
+    //Scene::CalcStateHash at the end of the frame.
+    uint64_t world_hash{};
+};
+
+static_assert(std::is_trivially_copyable_v<RecordedEvent>, "Recordings store RecordedEvent as raw bytes.");
+static_assert(std::is_trivially_copyable_v<RecordedFrame>, "Recordings store RecordedFrame as raw bytes.");
+static_assert(std::is_trivially_copyable_v<StressSceneDesc>, "Recordings store StressSceneDesc as raw bytes.");
+static_assert(std::is_standard_layout_v<StressSceneDesc>, "Recordings validate StressSceneDesc's bools by offset.");
+
+//Binary recording layout:
+//  InputRecordingHeader
+//  StressSceneDesc
+//  RecordedFrame[frame_count]
+//  RecordedEvent[event_count]
+struct InputRecordingHeader {
+    char magic[4]{'F', 'Z', 'R', 'C'};
+    uint32_t version{};
+    uint32_t stress_desc_size{};
+    uint32_t frame_record_size{};
+    uint32_t event_record_size{};
+    uint32_t frame_count{};
+    uint32_t event_count{};
+    float step_seconds{};
+    GUID state_id{};
+};
+
+//A state entered from scratch, stepped at a fixed rate, and the events
+//applied to it, in frame order.
+struct InputRecording {
+    static inline constexpr uint32_t current_version = 1u;
+    static inline constexpr const char* extension = ".fzrec";
+
+    GUID state_id{};
+    TimeUtils::FPSeconds step{};
+    //The Stress scene is generated from this, so a replay needs it too.
+    StressSceneDesc stress{};
+    std::vector<RecordedFrame> frames{};
+    std::vector<RecordedEvent> events{};
+
+    [[nodiscard]] bool Save(const std::filesystem::path& filepath) const noexcept;
+    //Returns false if the file is missing, was written with a different record
+    //layout, or holds a Stress desc or event the game cannot apply.
+    [[nodiscard]] bool Load(const std::filesystem::path& filepath) noexcept;
+};
+
+//Logs events and per-frame world hashes while recording. Events pass
+//through unchanged when it is not, so states always route them through Record.
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    InputRecorder(const InputRecorder& other) = delete;
+    InputRecorder(InputRecorder&& other) = delete;
+    InputRecorder& operator=(const InputRecorder& other) = delete;
+    InputRecorder& operator=(InputRecorder&& other) = delete;
+    ~InputRecorder() = default;
+
+    void Begin(const GUID& state_id, TimeUtils::FPSeconds step) noexcept;
+    void Stop() noexcept;
+    [[nodiscard]] bool IsRecording() const noexcept;
+
+    //Stamps the event with the current frame and keeps it if recording.
+    [[nodiscard]] RecordedEvent Record(RecordedEventType type, const Vector2& point, uint32_t index = 0u, uint32_t sub_index = 0u) noexcept;
+    void EndFrame(int substeps, uint64_t world_hash) noexcept;
+
+    [[nodiscard]] const InputRecording& GetRecording() const noexcept;
+
+protected:
+private:
+    InputRecording _recording{};
+    bool _is_recording = false;
+};
+
+extern InputRecorder g_theInputRecorder;
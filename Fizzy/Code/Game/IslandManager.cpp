@@ -0,0 +1,177 @@
+#include "Game/IslandManager.hpp"
+
+#include "Engine/UI/UISystem.hpp"
+
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+constexpr float degrees_to_radians = 3.14159265358979f / 180.0f;
+
+bool IsDynamic(const RigidBody& body) noexcept {
+    return body.GetInverseMass() > 0.0f;
+}
+
+} // namespace
+
+void IslandManager::SetDescription(const IslandSleepDesc& desc) noexcept {
+    _desc = desc;
+}
+
+const IslandSleepDesc& IslandManager::GetDescription() const noexcept {
+    return _desc;
+}
+
+void IslandManager::Update(Scene& scene, TimeUtils::FPSeconds timestep) noexcept {
+    const auto start = std::chrono::steady_clock::now();
+    const auto count = scene.GetBodyCount();
+    if(!_desc.enabled) {
+        //Bodies this manager put to sleep would otherwise never wake again.
+        if(_stats.asleep_body_count) {
+            WakeAll(scene);
+        }
+        _stats = IslandStats{};
+        _stats.awake_body_count = count;
+        return;
+    }
+    _rest_seconds.resize(count, 0.0f);
+    //A sleeping island keeps its links from the step it fell asleep; only
+    //awake and new bodies start this step on their own.
+    const auto previous_count = _parents.size();
+    _parents.resize(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        const auto parent = i < previous_count ? _parents[i] : static_cast<uint32_t>(i);
+        if(scene.GetBody(i).IsAwake() || parent >= previous_count || scene.GetBody(parent).IsAwake()) {
+            _parents[i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    const auto& broadphase = scene.UpdateBroadphase();
+    const auto& bounds = broadphase.GetBounds();
+    const auto is_linked = [&scene](uint32_t a, uint32_t b) {
+        const auto& body_a = scene.GetBody(a);
+        const auto& body_b = scene.GetBody(b);
+        //Two sleeping bodies that touch are already in the same island.
+        return IsDynamic(body_a) && IsDynamic(body_b) && (body_a.IsAwake() || body_b.IsAwake());
+    };
+    for(const auto& contact : broadphase.GetPairs()) {
+        if(is_linked(contact.a, contact.b)) {
+            Merge(contact.a, contact.b);
+        }
+    }
+    const auto joint_count = scene.GetJoints().size();
+    for(std::size_t i = 0u; i < joint_count; ++i) {
+        const auto& record = scene.GetJointRecord(i);
+        if(scene.IsJointIntact(i) && is_linked(record.body_a, record.body_b)) {
+            Merge(record.body_a, record.body_b);
+        }
+    }
+
+    _island_active.assign(count, 0u);
+    for(std::size_t i = 0u; i < count; ++i) {
+        const auto& body = scene.GetBody(i);
+        if(!body.IsAwake()) {
+            continue;
+        }
+        const auto root = FindRoot(static_cast<uint32_t>(i));
+        const auto& velocity = body.GetVelocity();
+        const auto radius = (std::max)(bounds[i].maxs.x - bounds[i].mins.x, bounds[i].maxs.y - bounds[i].mins.y) * 0.5f;
+        const auto rim_speed = body.GetAngularVelocityDegrees() * degrees_to_radians * radius;
+        const auto energy = 0.5f * (velocity.x * velocity.x + velocity.y * velocity.y + rim_speed * rim_speed);
+        _rest_seconds[i] = energy < _desc.energy_threshold ? _rest_seconds[i] + timestep.count() : 0.0f;
+        if(_rest_seconds[i] < _desc.time_to_sleep.count()) {
+            _island_active[root] = 1u;
+        }
+    }
+
+    _stats = IslandStats{};
+    for(std::size_t i = 0u; i < count; ++i) {
+        auto& body = scene.GetBody(i);
+        const auto root = FindRoot(static_cast<uint32_t>(i));
+        if(_island_active[root]) {
+            if(!body.IsAwake()) {
+                body.SetAwake(true);
+                _rest_seconds[i] = 0.0f;
+                ++_stats.woken_body_count;
+            }
+        } else if(body.IsAwake()) {
+            body.SetVelocity(Vector2::ZERO);
+            body.SetAngularVelocityDegrees(0.0f);
+            body.SetAwake(false);
+        }
+        if(root == i) {
+            ++_stats.island_count;
+            if(!_island_active[root]) {
+                ++_stats.sleeping_island_count;
+            }
+        }
+        if(body.IsAwake()) {
+            ++_stats.awake_body_count;
+        } else {
+            ++_stats.asleep_body_count;
+        }
+    }
+    _stats.hashed_body_count = broadphase.GetStats().hashed_body_count;
+    _stats.update_ms = std::chrono::duration<float, std::milli>{std::chrono::steady_clock::now() - start}.count();
+}
+
+void IslandManager::Reset() noexcept {
+    _rest_seconds.clear();
+    _parents.clear();
+    _stats = IslandStats{};
+}
+
+const IslandStats& IslandManager::GetStats() const noexcept {
+    return _stats;
+}
+
+void IslandManager::ShowDebugUI(float physics_ms) noexcept {
+    ImGui::Checkbox("Island sleeping", &_desc.enabled);
+    ImGui::SliderFloat("Sleep energy", &_desc.energy_threshold, 0.0f, 50.0f);
+    float time_to_sleep = _desc.time_to_sleep.count();
+    if(ImGui::SliderFloat("Time to sleep (s)", &time_to_sleep, 0.0f, 5.0f)) {
+        _desc.time_to_sleep = TimeUtils::FPSeconds{time_to_sleep};
+    }
+    auto& average_ms = _desc.enabled ? _physics_ms_sleeping : _physics_ms_not_sleeping;
+    average_ms += (physics_ms - average_ms) * 0.05f;
+    ImGui::Text("Islands: %zu (%zu asleep)", _stats.island_count, _stats.sleeping_island_count);
+    ImGui::Text("Bodies awake: %zu asleep: %zu", _stats.awake_body_count, _stats.asleep_body_count);
+    ImGui::Text("Woken this step: %zu", _stats.woken_body_count);
+    ImGui::Text("Bounds hashed this step: %zu", _stats.hashed_body_count);
+    ImGui::Text("Island update: %.3f ms", _stats.update_ms);
+    ImGui::Text("Physics: %.3f ms sleeping, %.3f ms not sleeping", _physics_ms_sleeping, _physics_ms_not_sleeping);
+    if(_physics_ms_sleeping > 0.0f && _physics_ms_not_sleeping > 0.0f) {
+        ImGui::Text("Saved by sleeping: %.3f ms", _physics_ms_not_sleeping - _physics_ms_sleeping);
+    } else {
+        ImGui::Text("Toggle island sleeping to measure the time saved.");
+    }
+}
+
+uint32_t IslandManager::FindRoot(uint32_t index) noexcept {
+    while(_parents[index] != index) {
+        //Path halving keeps the trees flat without recursion.
+        _parents[index] = _parents[_parents[index]];
+        index = _parents[index];
+    }
+    return index;
+}
+
+void IslandManager::Merge(uint32_t a, uint32_t b) noexcept {
+    const auto root_a = FindRoot(a);
+    const auto root_b = FindRoot(b);
+    if(root_a != root_b) {
+        //Lower index as root keeps the islands independent of contact order.
+        _parents[(std::max)(root_a, root_b)] = (std::min)(root_a, root_b);
+    }
+}
+
+void IslandManager::WakeAll(Scene& scene) noexcept {
+    const auto count = scene.GetBodyCount();
+    for(std::size_t i = 0u; i < count; ++i) {
+        scene.GetBody(i).SetAwake(true);
+    }
+    _rest_seconds.assign(count, 0.0f);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+struct IslandSleepDesc {
+    bool enabled = true;
+    //Kinetic energy per unit mass, linear plus the rim speed of any spin, in px^2/s^2.
+    float energy_threshold = 2.0f;
+    //How long every body of an island must stay below the threshold before the island sleeps.
+    TimeUtils::FPSeconds time_to_sleep = TimeUtils::FPSeconds{0.5f};
+};
+
+struct IslandStats {
+    std::size_t island_count{};
+    std::size_t sleeping_island_count{};
+    std::size_t awake_body_count{};
+    std::size_t asleep_body_count{};
+    //Bodies woken this step because an awake body touched or was jointed to their island.
+    std::size_t woken_body_count{};
+    //Bodies whose bounds the scene's broadphase computed and hashed this step.
+    std::size_t hashed_body_count{};
+    float update_ms{};
+};
+
+//Groups a scene's bodies into islands each step: bodies whose bounds touch or
+//that share an intact joint end up in the same island. Static bodies (no
+//inverse mass) never join islands, so a shared floor does not chain every
+//stack together. An island sleeps only as a whole, once all its bodies have
+//rested for time_to_sleep, and wakes as a whole as soon as any awake body
+//joins it. Sleeping bodies are taken out of the simulation with
+//RigidBody::SetAwake(false) and have their velocities zeroed. The pairs come
+//from the scene's shared broadphase, which keeps sleeping bodies' bounds
+//between steps, and a sleeping island keeps its links until it wakes, so
+//only awake bodies are rehashed and relinked each step.
+class IslandManager {
+public:
+    IslandManager() = default;
+    IslandManager(const IslandManager& other) = default;
+    IslandManager(IslandManager&& other) = default;
+    IslandManager& operator=(const IslandManager& other) = default;
+    IslandManager& operator=(IslandManager&& other) = default;
+    ~IslandManager() = default;
+
+    void SetDescription(const IslandSleepDesc& desc) noexcept;
+    [[nodiscard]] const IslandSleepDesc& GetDescription() const noexcept;
+
+    //Call after every physics step with the time it covered.
+    void Update(Scene& scene, TimeUtils::FPSeconds timestep) noexcept;
+    //Forgets every body's rest time, e.g. after the scene was rebuilt or restored.
+    void Reset() noexcept;
+
+    [[nodiscard]] const IslandStats& GetStats() const noexcept;
+
+    //Checkbox, thresholds and counts for a state's debug window. physics_ms is
+    //the state's current physics cost; it is averaged separately with sleeping
+    //on and off so the window can show what sleeping saves.
+    void ShowDebugUI(float physics_ms) noexcept;
+
+protected:
+private:
+    [[nodiscard]] uint32_t FindRoot(uint32_t index) noexcept;
+    void Merge(uint32_t a, uint32_t b) noexcept;
+    void WakeAll(Scene& scene) noexcept;
+
+    IslandSleepDesc _desc{};
+    IslandStats _stats{};
+    std::vector<uint32_t> _parents{};
+    std::vector<float> _rest_seconds{};
+    //Per island root: 1 if any body in it is awake and still moving.
+    std::vector<uint8_t> _island_active{};
+    float _physics_ms_sleeping{};
+    float _physics_ms_not_sleeping{};
+};
@@ -0,0 +1,118 @@
+#include "Game/JobSystem.hpp"
+
+#include <algorithm>
+
+JobSystem g_theJobSystem{};
+
+JobSystem::~JobSystem() noexcept {
+    Shutdown();
+}
+
+void JobSystem::Initialize(std::size_t worker_count) noexcept {
+    Shutdown();
+    _queues.clear();
+    for(std::size_t i = 0u; i < worker_count + 1u; ++i) {
+        _queues.push_back(std::make_unique<WorkQueue>());
+    }
+    _is_running = true;
+    _workers.reserve(worker_count);
+    for(std::size_t i = 0u; i < worker_count; ++i) {
+        _workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+void JobSystem::Shutdown() noexcept {
+    {
+        std::scoped_lock<std::mutex> lock(_wake_mutex);
+        _is_running = false;
+    }
+    _wake.notify_all();
+    for(auto& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+std::size_t JobSystem::GetWorkerCount() const noexcept {
+    return _workers.size();
+}
+
+std::size_t JobSystem::CalcDefaultWorkerCount() noexcept {
+    const auto hardware_threads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+    return hardware_threads > 1u ? hardware_threads - 1u : 0u;
+}
+
+void JobSystem::ParallelFor(std::size_t count, std::size_t chunk_size, const RangeFunction& func) noexcept {
+    chunk_size = (std::max)(chunk_size, std::size_t{1u});
+    if(_workers.empty() || count <= chunk_size) {
+        if(count) {
+            func(0u, count);
+        }
+        return;
+    }
+    const auto chunk_count = (count + chunk_size - 1u) / chunk_size;
+    std::atomic<std::size_t> remaining{chunk_count};
+    //Deal the chunks out round-robin; stealing evens out whatever is left uneven.
+    for(std::size_t i = 0u; i < chunk_count; ++i) {
+        const auto first = i * chunk_size;
+        auto& queue = *_queues[i % _queues.size()];
+        std::scoped_lock<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{&func, first, (std::min)(first + chunk_size, count), &remaining});
+    }
+    {
+        std::scoped_lock<std::mutex> lock(_wake_mutex);
+        _queued += chunk_count;
+    }
+    _wake.notify_all();
+    const auto caller_index = _queues.size() - 1u;
+    while(remaining.load(std::memory_order_acquire)) {
+        if(auto job = Job{}; TryGetJob(caller_index, job)) {
+            Run(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::TryGetJob(std::size_t queue_index, Job& job) noexcept {
+    {
+        auto& own = *_queues[queue_index];
+        std::scoped_lock<std::mutex> lock(own.mutex);
+        if(!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            --_queued;
+            return true;
+        }
+    }
+    for(std::size_t offset = 1u; offset < _queues.size(); ++offset) {
+        auto& victim = *_queues[(queue_index + offset) % _queues.size()];
+        std::scoped_lock<std::mutex> lock(victim.mutex);
+        if(!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            --_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::Run(const Job& job) noexcept {
+    (*job.func)(job.first, job.last);
+    job.remaining->fetch_sub(1u, std::memory_order_release);
+}
+
+void JobSystem::WorkerLoop(std::size_t queue_index) noexcept {
+    for(;;) {
+        if(auto job = Job{}; TryGetJob(queue_index, job)) {
+            Run(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_wake_mutex);
+        _wake.wait(lock, [this]() { return !_is_running || _queued.load() != 0u; });
+        if(!_is_running) {
+            return;
+        }
+    }
+}
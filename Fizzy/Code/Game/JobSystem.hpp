@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Splits per-body loops across worker threads. Each worker owns a queue of
+//chunks; it takes from the back of its own and steals from the front of the
+//others when it runs dry. The calling thread works on the chunks too, so with
+//no workers every loop runs serially on the caller.
+class JobSystem {
+public:
+    using RangeFunction = std::function<void(std::size_t first, std::size_t last)>;
+
+    JobSystem() = default;
+    JobSystem(const JobSystem& other) = delete;
+    JobSystem(JobSystem&& other) = delete;
+    JobSystem& operator=(const JobSystem& other) = delete;
+    JobSystem& operator=(JobSystem&& other) = delete;
+    ~JobSystem() noexcept;
+
+    //Restarts the pool with worker_count threads. 0 runs every loop serially.
+    void Initialize(std::size_t worker_count) noexcept;
+    void Shutdown() noexcept;
+    [[nodiscard]] std::size_t GetWorkerCount() const noexcept;
+    //hardware_concurrency less the calling thread.
+    [[nodiscard]] static std::size_t CalcDefaultWorkerCount() noexcept;
+
+    //Calls func over [0, count) in chunks of at most chunk_size and returns
+    //once every chunk has run. Chunks run concurrently, so func may only touch
+    //the elements in its range. Must only be called from one thread at a time.
+    void ParallelFor(std::size_t count, std::size_t chunk_size, const RangeFunction& func) noexcept;
+
+protected:
+private:
+    struct Job {
+        const RangeFunction* func{};
+        std::size_t first{};
+        std::size_t last{};
+        std::atomic<std::size_t>* remaining{};
+    };
+
+    struct WorkQueue {
+        std::mutex mutex{};
+        std::deque<Job> jobs{};
+    };
+
+    [[nodiscard]] bool TryGetJob(std::size_t queue_index, Job& job) noexcept;
+    void Run(const Job& job) noexcept;
+    void WorkerLoop(std::size_t queue_index) noexcept;
+
+    //One queue per worker, then the caller's.
+    std::vector<std::unique_ptr<WorkQueue>> _queues{};
+    std::vector<std::thread> _workers{};
+    std::mutex _wake_mutex{};
+    std::condition_variable _wake{};
+    //Jobs waiting in a queue; guarded by _wake_mutex when it goes up so a worker cannot miss the wake.
+    std::atomic<std::size_t> _queued{0u};
+    bool _is_running = false;
+};
+
+extern JobSystem g_theJobSystem;
@@ -0,0 +1,283 @@
+#include "Game/JointSolver.hpp"
+
+#include "Engine/UI/UISystem.hpp"
+
+#include "Game/JobSystem.hpp"
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+constexpr std::size_t max_colors = 64u;
+//Joints per job system chunk within a batch.
+constexpr std::size_t joint_chunk_size = 512u;
+constexpr std::size_t body_chunk_size = 4096u;
+
+void StoreMax(std::atomic<float>& target, float value) noexcept {
+    auto current = target.load(std::memory_order_relaxed);
+    while(current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        /* DO NOTHING */
+    }
+}
+
+} // namespace
+
+std::size_t JointBatches::GetBatchCount() const noexcept {
+    return batch_offsets.empty() ? 0u : batch_offsets.size() - 1u;
+}
+
+JointBatches ColorJointGraph(const std::vector<uint32_t>& body_a, const std::vector<uint32_t>& body_b, std::size_t body_count) noexcept {
+    const auto joint_count = body_a.size();
+    std::vector<uint64_t> used_colors(body_count, 0u);
+    std::vector<std::vector<uint32_t>> colors{};
+    std::vector<uint32_t> overflow{};
+    for(std::size_t i = 0u; i < joint_count; ++i) {
+        const auto used = used_colors[body_a[i]] | used_colors[body_b[i]];
+        if(used == ~uint64_t{0u}) {
+            overflow.push_back(static_cast<uint32_t>(i));
+            continue;
+        }
+        auto color = std::size_t{0u};
+        while(used & (uint64_t{1u} << color)) {
+            ++color;
+        }
+        used_colors[body_a[i]] |= uint64_t{1u} << color;
+        used_colors[body_b[i]] |= uint64_t{1u} << color;
+        if(colors.size() <= color) {
+            colors.resize(color + 1u);
+        }
+        colors[color].push_back(static_cast<uint32_t>(i));
+    }
+    auto batches = JointBatches{};
+    batches.joints.reserve(joint_count);
+    batches.batch_offsets.reserve(colors.size() + overflow.size() + 1u);
+    batches.batch_offsets.push_back(0u);
+    for(const auto& color : colors) {
+        batches.joints.insert(std::end(batches.joints), std::begin(color), std::end(color));
+        batches.batch_offsets.push_back(batches.joints.size());
+    }
+    for(const auto joint : overflow) {
+        batches.joints.push_back(joint);
+        batches.batch_offsets.push_back(batches.joints.size());
+    }
+    return batches;
+}
+
+void ParallelJointSolver::Rebuild(const Scene& scene) noexcept {
+    _body_a.clear();
+    _body_b.clear();
+    _length.clear();
+    _is_cable.clear();
+    const auto& joints = scene.GetJoints();
+    for(std::size_t i = 0u; i < joints.size(); ++i) {
+        const auto& record = scene.GetJointRecord(i);
+        if(joints[i] || record.type == SceneJointType::Spring || !scene.IsJointIntact(i)) {
+            continue;
+        }
+        _body_a.push_back(record.body_a);
+        _body_b.push_back(record.body_b);
+        _length.push_back(record.length);
+        _is_cable.push_back(record.type == SceneJointType::Cable ? 1u : 0u);
+    }
+    _accumulated.assign(_body_a.size(), 0.0f);
+    _previous_accumulated.assign(_body_a.size(), 0.0f);
+    _batches = ColorJointGraph(_body_a, _body_b, scene.GetBodyCount());
+    _stats = JointSolverStats{};
+    _stats.joint_count = _body_a.size();
+    _stats.batch_count = _batches.GetBatchCount();
+    for(std::size_t i = 0u; i < _stats.batch_count; ++i) {
+        _stats.largest_batch = (std::max)(_stats.largest_batch, _batches.batch_offsets[i + 1u] - _batches.batch_offsets[i]);
+    }
+}
+
+void ParallelJointSolver::BeginFrame() noexcept {
+    _stats.step_count = 0u;
+    _stats.frame_iterations = 0u;
+    _stats.frame_residual_error = 0.0f;
+    _stats.solve_ms = 0.0f;
+}
+
+void ParallelJointSolver::Solve(Scene& scene, TimeUtils::FPSeconds timestep) noexcept {
+    if(_body_a.empty() || timestep.count() <= 0.0f) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto body_count = scene.GetBodyCount();
+    _positions.resize(body_count);
+    _start_positions.resize(body_count);
+    _inverse_masses.resize(body_count);
+    g_theJobSystem.ParallelFor(body_count, body_chunk_size, [this, &scene](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            const auto& body = scene.GetBody(i);
+            _positions[i] = body.GetPosition();
+            _start_positions[i] = _positions[i];
+            //Sleeping bodies hold still, like static ones.
+            _inverse_masses[i] = body.IsAwake() ? body.GetInverseMass() : 0.0f;
+        }
+    });
+    //Each step accumulates afresh; only the warm start carries the last step's total over.
+    _previous_accumulated.swap(_accumulated);
+    std::fill(std::begin(_accumulated), std::end(_accumulated), 0.0f);
+    if(_desc.warm_start) {
+        ForEachBatch([this](uint32_t joint_index) {
+            WarmStartJoint(joint_index);
+            return 0.0f;
+        });
+    }
+    auto iterations = std::size_t{0u};
+    auto error = 0.0f;
+    while(iterations < _desc.max_iterations) {
+        //The largest error a joint had before its correction in this iteration.
+        error = ForEachBatch([this](uint32_t joint_index) { return SolveJoint(joint_index); });
+        if(!iterations) {
+            _stats.initial_error = error;
+        }
+        ++iterations;
+        if(error <= _desc.tolerance) {
+            break;
+        }
+    }
+    if(!iterations || error > _desc.tolerance) {
+        error = CalcMaxError();
+        if(!iterations) {
+            _stats.initial_error = error;
+        }
+    }
+    _stats.iterations_used = iterations;
+    _stats.residual_error = error;
+    const auto inverse_dt = 1.0f / timestep.count();
+    for(std::size_t i = 0u; i < body_count; ++i) {
+        const auto correction = _positions[i] - _start_positions[i];
+        if(correction.x == 0.0f && correction.y == 0.0f) {
+            continue;
+        }
+        auto& body = scene.GetBody(i);
+        const auto velocity = body.GetVelocity() + correction * inverse_dt;
+        body.SetPosition(_positions[i], true);
+        body.SetVelocity(velocity);
+    }
+    ++_stats.step_count;
+    _stats.frame_iterations += iterations;
+    _stats.frame_residual_error = (std::max)(_stats.frame_residual_error, error);
+    _stats.solve_ms += std::chrono::duration<float, std::milli>{std::chrono::steady_clock::now() - start}.count();
+}
+
+void ParallelJointSolver::Reset() noexcept {
+    std::fill(std::begin(_accumulated), std::end(_accumulated), 0.0f);
+    std::fill(std::begin(_previous_accumulated), std::end(_previous_accumulated), 0.0f);
+}
+
+void ParallelJointSolver::SetDescription(const JointSolverDesc& desc) noexcept {
+    _desc = desc;
+}
+
+const JointSolverDesc& ParallelJointSolver::GetDescription() const noexcept {
+    return _desc;
+}
+
+const JointSolverStats& ParallelJointSolver::GetStats() const noexcept {
+    return _stats;
+}
+
+void ParallelJointSolver::ShowDebugUI() noexcept {
+    int iterations = static_cast<int>(_desc.max_iterations);
+    if(ImGui::SliderInt("Max iterations", &iterations, 1, 64)) {
+        _desc.max_iterations = static_cast<std::size_t>(iterations);
+    }
+    ImGui::SliderFloat("Tolerance (px)", &_desc.tolerance, 0.0f, 1.0f, "%.3f");
+    ImGui::Checkbox("Warm start", &_desc.warm_start);
+    if(_desc.warm_start) {
+        ImGui::SliderFloat("Warm start scale", &_desc.warm_start_scale, 0.0f, 1.0f, "%.2f");
+    }
+    ImGui::Text("Joints: %zu in %zu batches, largest %zu", _stats.joint_count, _stats.batch_count, _stats.largest_batch);
+    ImGui::Text("Last step: %zu iterations, error %.4f -> %.4f px", _stats.iterations_used, _stats.initial_error, _stats.residual_error);
+    ImGui::Text("This frame: %zu steps, %zu iterations, worst residual %.4f px", _stats.step_count, _stats.frame_iterations, _stats.frame_residual_error);
+    ImGui::Text("Solve: %.3f ms on %zu workers", _stats.solve_ms, g_theJobSystem.GetWorkerCount() + 1u);
+}
+
+template<typename JointFn>
+float ParallelJointSolver::ForEachBatch(JointFn&& joint_fn) noexcept {
+    auto max_error = std::atomic<float>{0.0f};
+    for(std::size_t batch = 0u; batch < _batches.GetBatchCount(); ++batch) {
+        const auto batch_first = _batches.batch_offsets[batch];
+        const auto batch_size = _batches.batch_offsets[batch + 1u] - batch_first;
+        g_theJobSystem.ParallelFor(batch_size, joint_chunk_size, [this, batch_first, &joint_fn, &max_error](std::size_t first, std::size_t last) {
+            auto chunk_error = 0.0f;
+            for(auto i = first; i < last; ++i) {
+                chunk_error = (std::max)(chunk_error, joint_fn(_batches.joints[batch_first + i]));
+            }
+            StoreMax(max_error, chunk_error);
+        });
+    }
+    return max_error.load(std::memory_order_relaxed);
+}
+
+float ParallelJointSolver::CalcMaxError() const noexcept {
+    auto max_error = std::atomic<float>{0.0f};
+    g_theJobSystem.ParallelFor(_body_a.size(), joint_chunk_size, [this, &max_error](std::size_t first, std::size_t last) {
+        auto chunk_error = 0.0f;
+        for(auto i = first; i < last; ++i) {
+            chunk_error = (std::max)(chunk_error, CalcJointError(static_cast<uint32_t>(i)));
+        }
+        StoreMax(max_error, chunk_error);
+    });
+    return max_error.load(std::memory_order_relaxed);
+}
+
+float ParallelJointSolver::CalcJointError(uint32_t joint_index) const noexcept {
+    const auto offset = _positions[_body_b[joint_index]] - _positions[_body_a[joint_index]];
+    const auto stretch = std::sqrt(offset.x * offset.x + offset.y * offset.y) - _length[joint_index];
+    //A slack cable is not an error.
+    return _is_cable[joint_index] ? (std::max)(stretch, 0.0f) : std::abs(stretch);
+}
+
+void ParallelJointSolver::WarmStartJoint(uint32_t joint_index) noexcept {
+    const auto a = _body_a[joint_index];
+    const auto b = _body_b[joint_index];
+    const auto offset = _positions[b] - _positions[a];
+    const auto length = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+    const auto warm_start = _previous_accumulated[joint_index] * std::clamp(_desc.warm_start_scale, 0.0f, 1.0f);
+    if(length <= 0.0f || warm_start == 0.0f) {
+        return;
+    }
+    //Counted toward this step's total, so a cable can still take it back if it goes slack.
+    _accumulated[joint_index] = warm_start;
+    const auto correction = offset * (warm_start / length);
+    _positions[a] += correction * _inverse_masses[a];
+    _positions[b] -= correction * _inverse_masses[b];
+}
+
+float ParallelJointSolver::SolveJoint(uint32_t joint_index) noexcept {
+    const auto a = _body_a[joint_index];
+    const auto b = _body_b[joint_index];
+    const auto inverse_mass_a = _inverse_masses[a];
+    const auto inverse_mass_b = _inverse_masses[b];
+    const auto inverse_mass_sum = inverse_mass_a + inverse_mass_b;
+    if(inverse_mass_sum <= 0.0f) {
+        return 0.0f;
+    }
+    const auto offset = _positions[b] - _positions[a];
+    const auto length = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+    if(length <= 0.0f) {
+        return 0.0f;
+    }
+    const auto stretch = length - _length[joint_index];
+    auto& accumulated = _accumulated[joint_index];
+    auto delta = stretch / inverse_mass_sum;
+    //Cables only pull, so their total correction can fall back to zero but not below.
+    if(_is_cable[joint_index]) {
+        const auto previous = accumulated;
+        accumulated = (std::max)(previous + delta, 0.0f);
+        delta = accumulated - previous;
+    } else {
+        accumulated += delta;
+    }
+    const auto correction = offset * (delta / length);
+    _positions[a] += correction * inverse_mass_a;
+    _positions[b] -= correction * inverse_mass_b;
+    return _is_cable[joint_index] ? (std::max)(stretch, 0.0f) : std::abs(stretch);
+}
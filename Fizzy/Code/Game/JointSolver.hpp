@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Math/Vector2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+//Joints grouped so no two joints in a batch share a body. Stored flat: the
+//joints of batch i are joints[batch_offsets[i], batch_offsets[i + 1]).
+struct JointBatches {
+    std::vector<uint32_t> joints{};
+    std::vector<std::size_t> batch_offsets{};
+
+    [[nodiscard]] std::size_t GetBatchCount() const noexcept;
+};
+
+//Greedy edge coloring of the joint graph given as one (body_a[i], body_b[i])
+//pair per joint: each joint takes the lowest color neither of its bodies uses
+//yet, and each color becomes a batch. Chains need two colors, ragdoll-like
+//trees about as many as their busiest body has joints. A body with more than
+//64 joints gets the rest in batches of one.
+[[nodiscard]] JointBatches ColorJointGraph(const std::vector<uint32_t>& body_a, const std::vector<uint32_t>& body_b, std::size_t body_count) noexcept;
+
+struct JointSolverDesc {
+    //Upper bound on iterations per step.
+    std::size_t max_iterations = 8u;
+    //Stop iterating once no joint is off its length by more than this, in px.
+    float tolerance = 0.01f;
+    //Start each step from part of the correction the previous step applied.
+    bool warm_start = true;
+    //Fraction of the previous step's correction reapplied. Position
+    //corrections do not carry over exactly like impulses, so reapplying all
+    //of it overshoots whenever the load changes.
+    float warm_start_scale = 0.8f;
+};
+
+struct JointSolverStats {
+    std::size_t joint_count{};
+    std::size_t batch_count{};
+    std::size_t largest_batch{};
+    //Last step.
+    std::size_t iterations_used{};
+    //Largest length error, in px, at the start and end of the last step.
+    float initial_error{};
+    float residual_error{};
+    //Since BeginFrame.
+    std::size_t step_count{};
+    std::size_t frame_iterations{};
+    float frame_residual_error{};
+    float solve_ms{};
+};
+
+//Position-based solver for the rods and cables of a scene whose joint
+//solver is SceneJointSolver::Parallel. Each iteration walks the batches in
+//order; the joints of a batch touch disjoint bodies, so they are projected
+//in parallel on g_theJobSystem without locks. Positions are solved on a
+//copy and written back once per step, and the correction divided by the
+//step is added to each body's velocity so the joints do not gain energy.
+//
+//Each joint accumulates the correction it applied over the step, clamped so
+//a cable only ever pulls. With warm starting the next step first reapplies a
+//scaled share of that total along the joint's new direction, so a chain held
+//up against gravity starts close to solved and converges in a few iterations
+//instead of rebuilding its tension every step. Only the last step's total is
+//carried over, so the warm start cannot build up across steps.
+class ParallelJointSolver {
+public:
+    ParallelJointSolver() = default;
+    ParallelJointSolver(const ParallelJointSolver& other) = default;
+    ParallelJointSolver(ParallelJointSolver&& other) = default;
+    ParallelJointSolver& operator=(const ParallelJointSolver& other) = default;
+    ParallelJointSolver& operator=(ParallelJointSolver&& other) = default;
+    ~ParallelJointSolver() = default;
+
+    //Colors the scene's intact rods and cables. Call after the scene is
+    //registered and again after one of them is detached.
+    void Rebuild(const Scene& scene) noexcept;
+    void BeginFrame() noexcept;
+    void Solve(Scene& scene, TimeUtils::FPSeconds timestep) noexcept;
+    //Drops the warm start, e.g. after bodies were teleported by a restart.
+    void Reset() noexcept;
+
+    void SetDescription(const JointSolverDesc& desc) noexcept;
+    [[nodiscard]] const JointSolverDesc& GetDescription() const noexcept;
+    [[nodiscard]] const JointSolverStats& GetStats() const noexcept;
+
+    //Settings and convergence for a state's debug window.
+    void ShowDebugUI() noexcept;
+
+protected:
+private:
+    //Returns the joint's length error before the correction.
+    float SolveJoint(uint32_t joint_index) noexcept;
+    void WarmStartJoint(uint32_t joint_index) noexcept;
+    [[nodiscard]] float CalcJointError(uint32_t joint_index) const noexcept;
+    [[nodiscard]] float CalcMaxError() const noexcept;
+    //Runs joint_fn over every joint batch by batch and returns the largest value it returned.
+    template<typename JointFn>
+    float ForEachBatch(JointFn&& joint_fn) noexcept;
+
+    JointBatches _batches{};
+    //Per joint, copied from the records on Rebuild.
+    std::vector<uint32_t> _body_a{};
+    std::vector<uint32_t> _body_b{};
+    std::vector<float> _length{};
+    std::vector<uint8_t> _is_cable{};
+    //Correction along the joint, in px times mass, summed over the step. Positive pulls.
+    std::vector<float> _accumulated{};
+    //_accumulated as the previous step left it, for the warm start.
+    std::vector<float> _previous_accumulated{};
+    //Per body.
+    std::vector<Vector2> _positions{};
+    std::vector<Vector2> _start_positions{};
+    std::vector<float> _inverse_masses{};
+    JointSolverDesc _desc{};
+    JointSolverStats _stats{};
+};
@@ -0,0 +1,584 @@
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Physics/PhysicsSystem.hpp"
+
+#include "Game/AllocationCounter.hpp"
+#include "Game/BenchmarkSuite.hpp"
+#include "Game/FrameProfiler.hpp"
+#include "Game/GameStateStress.hpp"
+#include "Game/HeadlessSimulation.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/SelfTest.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+//Count every heap allocation for the per-step allocation numbers. The array
+//and nothrow forms call these, so replacing them covers all of operator new.
+void* operator new(std::size_t size) {
+    RecordAllocation(size);
+    if(auto* ptr = std::malloc(size ? size : 1u)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    RecordAllocation(size);
+    const auto align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+    auto* ptr = _aligned_malloc(size ? size : 1u, align);
+#else
+    //aligned_alloc wants a size that is a multiple of the alignment.
+    auto* ptr = std::aligned_alloc(align, ((size ? size : 1u) + align - 1u) / align * align);
+#endif
+    if(ptr) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(ptr, alignment);
+}
+
+namespace {
+
+void PrintUsage() noexcept {
+    std::cout << "Usage: FizzyHeadless [--state=<name|{GUID}>] [--steps=<count>] [--hz=<rate>]\n"
+              << "                     [--bodies=<count>] [--distribution=<uniform|clumped|stacked|ropes>] [--seed=<value>]\n"
+              << "                     [--spawn-per-frame=<count>] [--scene-file] [--rope-links=<count>]\n"
+              << "                     [--engine-joints] [--joint-iterations=<count>] [--joint-tolerance=<px>]\n"
+              << "                     [--no-warm-start] [--warm-start-scale=<fraction>] [--check-joints]\n"
+              << "                     [--solve-contacts] [--contact-iterations=<count>] [--no-contact-warm-start] [--check-contacts]\n"
+              << "                     [--sleep] [--profile-csv=<path>]\n"
+              << "                     [--debug-draw] [--replay=<path>] [--workers=<count>]\n"
+              << "                     [--bench-integrate] [--bench-broadphase] [--broadphase-cell=<size>]\n"
+              << "                     [--bench-contacts] [--bench-narrowphase] [--bench-queries[=<count>]]\n"
+              << "                     [--shape-weights=<circle,aabb,obb,polygon>]\n"
+              << "                     [--suite=<path>] [--suite-bodies=<count,...>] [--compare=<path>] [--threshold=<percent>]\n"
+              << "                     [--self-test]\n"
+              << "    --state         GravityDrag, Constraints, SleepManagement, Stress or a state GUID. Default: GravityDrag\n"
+              << "    --steps         Number of fixed simulation steps to time. Default: 1000\n"
+              << "    --hz            Fixed simulation rate in steps per simulated second. Default: 60\n"
+              << "    --bodies        Stress scene body count. Default: 10000\n"
+              << "    --distribution  Stress scene body layout. Default: uniform\n"
+              << "    --seed          Stress scene random seed. Default: 0\n"
+              << "    --shape-weights Relative odds of each Stress scene collider shape. Default: 1,1,1,1\n"
+              << "    --spawn-per-frame  Stress scene bodies added per step instead of all at once. Default: 0\n"
+              << "    --scene-file    Load the Stress scene from Data/Scenes/Stress.fzscene instead of generating it.\n"
+              << "    --rope-links    Bodies per rope for the ropes distribution. Default: 50\n"
+              << "    --engine-joints Leave rope joints to the physics system instead of the parallel joint solver.\n"
+              << "    --joint-iterations Most parallel joint solver iterations per step. Default: 8\n"
+              << "    --joint-tolerance  Length error, in px, at which the joint solver stops iterating. Default: 0.01\n"
+              << "    --no-warm-start    Start every joint solve from zero instead of the previous step's corrections.\n"
+              << "    --warm-start-scale Fraction of the previous step's joint corrections reapplied. Default: 0.8\n"
+              << "    --check-joints     Track the parallel joint solver's error at the start of each step; fails if it\n"
+              << "                       keeps growing after the joints settle.\n"
+              << "    --solve-contacts   Solve the Stress scene's cached contact manifolds with the game-side contact solver.\n"
+              << "    --contact-iterations Most contact solver iterations per step. Default: 8\n"
+              << "    --no-contact-warm-start Start every contact solve from zero instead of the carried impulses.\n"
+              << "    --check-contacts   Solve contacts and report the solver's iterations, warm started points and residual.\n"
+              << "    --sleep         Put resting islands of Stress scene bodies to sleep.\n"
+              << "    --profile-csv   Write per-stage timings of the last steps to a CSV file. Not available in FinalBuild.\n"
+              << "    --debug-draw    Batch collision outlines every step into a recording renderer and report the draw counts.\n"
+              << "    --replay        Replay a recording saved from the Demo window and report any world hash divergence.\n"
+              << "                    Its state and Stress settings replace --state and the Stress options.\n"
+              << "    --workers       Job system worker threads for the per-body passes; 0 runs them serially.\n"
+              << "                    Default: one less than the hardware thread count\n"
+              << "    --bench-integrate  Time the scalar and SIMD gravity/drag integrators on the state's bodies for --steps steps.\n"
+              << "    --bench-broadphase  Time the quadtree and spatial hash broadphases on the state's bodies after each step.\n"
+              << "    --broadphase-cell  Spatial hash cell size for --bench-broadphase. Default: 0, sized from the bodies\n"
+              << "    --bench-contacts Time the contact cache with and without persistent manifolds after each step.\n"
+              << "    --bench-narrowphase Time the contact narrowphase with per-pair shapes, per-body world shapes and cached separating axes.\n"
+              << "                    With --solve-contacts, runs the Stress state once per path with its contact solver\n"
+              << "                    using the manifolds and times its own cache.\n"
+              << "    --bench-queries  Time batches of picks, rays, nearest-body and overlap queries after each step. Default: 10000 of each\n"
+              << "    --suite         Run every demo and the Stress state at each --suite-bodies count for --steps steps,\n"
+              << "                    and write per-step, per-stage and allocation costs to a JSON file.\n"
+              << "    --suite-bodies  Stress body counts for --suite. Default: 100,1000,10000,100000\n"
+              << "    --compare       Compare the --suite results with a baseline JSON file; fails if any regressed.\n"
+              << "    --threshold     Percent a --compare metric may grow before it counts as a regression. Default: 10\n"
+              << "    --self-test     Run the built-in checks of the body pool and scene bookkeeping instead of a state;\n"
+              << "                    fails if any check fails.\n";
+}
+
+struct HeadlessOptions {
+    std::string profile_csv{};
+    std::string replay{};
+    std::size_t workers = JobSystem::CalcDefaultWorkerCount();
+    bool bench_integrate = false;
+    bool bench_broadphase = false;
+    bool bench_contacts = false;
+    bool bench_narrowphase = false;
+    bool check_joints = false;
+    bool check_contacts = false;
+    bool self_test = false;
+    //Queries of each kind per step for --bench-queries; 0 when not benchmarking.
+    std::size_t bench_queries = 0u;
+    std::string suite{};
+    std::string compare{};
+    std::vector<std::size_t> suite_body_counts{BenchmarkSuiteDesc{}.body_counts};
+    double threshold_percent = 10.0;
+};
+
+//"circle,aabb,obb,polygon", e.g. "0,0,1,3" for a polygon-heavy scene.
+bool ParseShapeWeights(const std::string& value, StressSceneDesc& stress) noexcept {
+    int* weights[] = {&stress.circle_weight, &stress.aabb_weight, &stress.obb_weight, &stress.polygon_weight};
+    const char* text = value.c_str();
+    for(std::size_t i = 0u; i < 4u; ++i) {
+        char* end = nullptr;
+        const auto weight = std::strtol(text, &end, 10);
+        if(end == text || weight < 0 || (i < 3u ? *end != ',' : *end != '\0')) {
+            return false;
+        }
+        *weights[i] = static_cast<int>(weight);
+        text = end + 1;
+    }
+    return true;
+}
+
+bool ParseBodyCounts(const std::string& value, std::vector<std::size_t>& body_counts) noexcept {
+    body_counts.clear();
+    const char* text = value.c_str();
+    while(*text) {
+        char* end = nullptr;
+        const auto count = std::strtoull(text, &end, 10);
+        if(end == text || !count || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        body_counts.push_back(static_cast<std::size_t>(count));
+        text = *end ? end + 1 : end;
+    }
+    return !body_counts.empty();
+}
+
+bool ParseArguments(int argc, char* argv[], HeadlessSimulationDesc& desc, StressSceneDesc& stress, HeadlessOptions& options) noexcept {
+    for(int i = 1; i < argc; ++i) {
+        const auto arg = std::string{argv[i]};
+        const auto equals = arg.find('=');
+        const auto key = arg.substr(0, equals);
+        const auto value = equals == std::string::npos ? std::string{} : arg.substr(equals + 1);
+        if(key == "--state") {
+            if(!TryParseStateId(value, desc.stateId)) {
+                std::cerr << "Unknown state: " << value << '\n';
+                return false;
+            }
+        } else if(key == "--steps") {
+            desc.steps = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if(key == "--hz") {
+            const auto hz = std::strtof(value.c_str(), nullptr);
+            if(hz <= 0.0f) {
+                std::cerr << "Invalid rate: " << value << '\n';
+                return false;
+            }
+            desc.timestep = TimeUtils::FPSeconds{1.0f / hz};
+        } else if(key == "--bodies") {
+            stress.body_count = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if(key == "--distribution") {
+            if(value == "uniform") {
+                stress.distribution = StressDistribution::Uniform;
+            } else if(value == "clumped") {
+                stress.distribution = StressDistribution::Clumped;
+            } else if(value == "stacked") {
+                stress.distribution = StressDistribution::Stacked;
+            } else if(value == "ropes") {
+                stress.distribution = StressDistribution::Ropes;
+            } else {
+                std::cerr << "Unknown distribution: " << value << '\n';
+                return false;
+            }
+        } else if(key == "--seed") {
+            stress.seed = static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if(key == "--shape-weights") {
+            if(!ParseShapeWeights(value, stress)) {
+                std::cerr << "Expected four comma-separated shape weights: " << value << '\n';
+                return false;
+            }
+        } else if(key == "--spawn-per-frame") {
+            stress.spawn_per_frame = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if(key == "--scene-file") {
+            stress.load_scene_file = true;
+        } else if(key == "--rope-links") {
+            stress.rope_links = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if(key == "--engine-joints") {
+            stress.parallel_joints = false;
+        } else if(key == "--joint-iterations") {
+            stress.joints.max_iterations = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if(key == "--joint-tolerance") {
+            stress.joints.tolerance = std::strtof(value.c_str(), nullptr);
+        } else if(key == "--no-warm-start") {
+            stress.joints.warm_start = false;
+        } else if(key == "--warm-start-scale") {
+            stress.joints.warm_start_scale = std::strtof(value.c_str(), nullptr);
+        } else if(key == "--check-joints") {
+            options.check_joints = true;
+        } else if(key == "--solve-contacts") {
+            stress.solve_contacts = true;
+        } else if(key == "--contact-iterations") {
+            stress.contact_solver.max_iterations = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if(key == "--no-contact-warm-start") {
+            stress.contact_solver.warm_start = false;
+        } else if(key == "--self-test") {
+            options.self_test = true;
+        } else if(key == "--check-contacts") {
+            stress.solve_contacts = true;
+            options.check_contacts = true;
+        } else if(key == "--sleep") {
+            stress.sleep.enabled = true;
+        } else if(key == "--debug-draw") {
+            desc.debug_draw = true;
+        } else if(key == "--profile-csv") {
+            options.profile_csv = value;
+        } else if(key == "--replay") {
+            options.replay = value;
+        } else if(key == "--bench-integrate") {
+            options.bench_integrate = true;
+        } else if(key == "--bench-broadphase") {
+            options.bench_broadphase = true;
+        } else if(key == "--bench-contacts") {
+            options.bench_contacts = true;
+        } else if(key == "--bench-narrowphase") {
+            options.bench_narrowphase = true;
+        } else if(key == "--bench-queries") {
+            options.bench_queries = value.empty() ? 10000u : static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else if(key == "--suite") {
+            options.suite = value;
+        } else if(key == "--suite-bodies") {
+            if(!ParseBodyCounts(value, options.suite_body_counts)) {
+                std::cerr << "Expected comma-separated body counts: " << value << '\n';
+                return false;
+            }
+        } else if(key == "--compare") {
+            options.compare = value;
+        } else if(key == "--threshold") {
+            options.threshold_percent = std::strtod(value.c_str(), nullptr);
+        } else if(key == "--broadphase-cell") {
+            stress.broadphase.cell_size = std::strtof(value.c_str(), nullptr);
+        } else if(key == "--workers") {
+            options.workers = static_cast<std::size_t>(std::strtoull(value.c_str(), nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    if(!options.compare.empty() && options.suite.empty()) {
+        std::cerr << "--compare needs --suite to write the results it compares.\n";
+        return false;
+    }
+    return true;
+}
+
+void PrintReplayResult(const HeadlessReplayResult& result) noexcept {
+    std::cout << "setup:      " << result.setup_milliseconds << " ms\n"
+              << "frames:     " << result.frames << '\n'
+              << "events:     " << result.events << '\n'
+              << "total:      " << result.total_seconds << " s\n"
+              << "ms/frame:   " << result.milliseconds_per_frame << '\n'
+              << "max ms/frame: " << result.max_milliseconds_per_frame << '\n';
+    if(result.divergent_frames) {
+        std::cout << "diverged:   " << result.divergent_frames << " frames, first at frame " << result.first_divergent_frame << '\n';
+    } else {
+        std::cout << "diverged:   none\n";
+    }
+}
+
+void PrintIntegrationBenchmark(const std::vector<IntegrationBenchmarkResult>& results) noexcept {
+    if(results.empty()) {
+        std::cout << "The state has no bodies to integrate.\n";
+        return;
+    }
+    for(const auto& result : results) {
+        std::cout << GetIntegratorKernelName(result.kernel) << ": " << result.nanoseconds_per_body << " ns/body"
+                  << ", max difference from scalar: " << result.max_difference << '\n';
+    }
+}
+
+void PrintBroadphaseBenchmark(const std::vector<BroadphaseBenchmarkResult>& results) noexcept {
+    if(results.empty()) {
+        std::cout << "The state has no scene to partition.\n";
+        return;
+    }
+    for(const auto& result : results) {
+        std::cout << GetBroadphaseName(result.type) << ": build " << result.build_milliseconds << " ms"
+                  << ", pairs " << result.find_pairs_milliseconds << " ms"
+                  << ", " << result.pairs_per_step << " pairs/step"
+                  << ", " << result.cells_per_step << " cells/step";
+        if(result.mismatched_steps) {
+            std::cout << ", pair count differs from the quadtree on " << result.mismatched_steps << " steps";
+        }
+        std::cout << '\n';
+    }
+}
+
+void PrintContactBenchmark(const std::vector<ContactBenchmarkResult>& results) noexcept {
+    if(results.empty()) {
+        std::cout << "The state has no scene to collide.\n";
+        return;
+    }
+    for(const auto& result : results) {
+        std::cout << (result.persistent ? "Persistent" : "From scratch") << ": " << result.update_milliseconds << " ms"
+                  << ", " << result.pairs_per_step << " pairs/step"
+                  << ", " << result.points_per_step << " points/step"
+                  << ", narrowphase on " << result.narrowphase_fraction * 100.0 << "% of pairs\n";
+    }
+}
+
+void PrintNarrowphaseBenchmark(const std::vector<NarrowphaseBenchmarkResult>& results) noexcept {
+    if(results.empty()) {
+        std::cout << "The state has no scene to collide.\n";
+        return;
+    }
+    for(const auto& result : results) {
+        std::cout << (result.world_shapes ? "World shapes" : "Per-pair shapes") << (result.cache_axes ? " + cached axes" : "")
+                  << ": " << result.update_milliseconds << " ms"
+                  << ", narrowphase on " << result.narrowphase_pairs_per_step << " pairs/step"
+                  << ", " << result.axis_rejected_per_step << " rejected by cached axis"
+                  << ", " << result.points_per_step << " points/step";
+        if(result.solved) {
+            std::cout << ", solve " << result.solve_milliseconds << " ms";
+        }
+        if(result.mismatched_steps) {
+            std::cout << ", point count differs from per-pair shapes on " << result.mismatched_steps << " steps";
+        }
+        std::cout << '\n';
+    }
+}
+
+void PrintJointStability(const JointStabilityResult& result) noexcept {
+    if(!result.joint_count) {
+        std::cout << "The state has no joints in a parallel joint solver, or fewer than 10 steps were run.\n";
+        return;
+    }
+    std::cout << "joints:     " << result.joint_count << '\n'
+              << "steps:      " << result.steps << '\n'
+              << "settled:    " << result.settled_initial_error << " px worst initial error\n"
+              << "final:      " << result.final_initial_error << " px worst initial error\n"
+              << "max:        " << result.max_initial_error << " px\n"
+              << "unconverged: " << result.unconverged_steps << " steps\n"
+              << (result.is_bounded ? "bounded:    yes\n" : "bounded:    NO, the error grew after settling\n");
+}
+
+void PrintContactSolver(const ContactSolverResult& result) noexcept {
+    if(!result.steps) {
+        std::cout << "The state has no contact solver.\n";
+        return;
+    }
+    std::cout << "steps:      " << result.steps << '\n'
+              << "points:     " << result.points_per_step << " per step, " << result.warm_started_fraction * 100.0 << "% warm started\n"
+              << "iterations: " << result.iterations_per_step << " per step\n"
+              << "solve:      " << result.solve_milliseconds << " ms\n"
+              << "residual:   " << result.max_residual_change << " worst impulse change\n"
+              << "unconverged: " << result.unconverged_steps << " steps\n";
+}
+
+void PrintSuiteResult(const BenchmarkSuiteResult& result) noexcept {
+    for(const auto& c : result.cases) {
+        std::cout << c.name << ": " << c.body_count << " bodies"
+                  << ", " << c.milliseconds_per_step << " ms/step"
+                  << ", " << c.allocations_per_step << " allocs/step"
+                  << ", setup " << c.setup_milliseconds << " ms\n";
+    }
+}
+
+void PrintRegressions(const std::vector<BenchmarkRegression>& regressions, double threshold_percent) noexcept {
+    if(regressions.empty()) {
+        std::cout << "No regressions over " << threshold_percent << "%.\n";
+        return;
+    }
+    for(const auto& regression : regressions) {
+        const auto change = regression.baseline > 0.0 ? (regression.current / regression.baseline - 1.0) * 100.0 : 100.0;
+        std::cout << "REGRESSION " << regression.name << ' ' << regression.metric << ": "
+                  << regression.baseline << " -> " << regression.current << " (+" << change << "%)\n";
+    }
+}
+
+void PrintQueryBenchmark(const QueryBenchmarkResult& result) noexcept {
+    std::cout << "queries:    " << result.queries_per_step << " of each kind per step\n"
+              << "rebuild:    " << result.rebuild_milliseconds << " ms\n"
+              << "pick:       " << result.pick_milliseconds << " ms, " << result.pick_hit_rate * 100.0 << "% hit\n"
+              << "ray:        " << result.ray_milliseconds << " ms, " << result.ray_hit_rate * 100.0 << "% hit\n"
+              << "nearest:    " << result.nearest_milliseconds << " ms, " << result.nearest_hit_rate * 100.0 << "% found\n"
+              << "overlap:    " << result.overlap_milliseconds << " ms, " << result.bodies_per_overlap << " bodies/query\n";
+}
+
+//Runs the benchmark suite in place of a single state, writes its JSON and
+//compares it with the baseline, if one was given.
+int RunSuite(const HeadlessSimulationDesc& desc, const HeadlessOptions& options) noexcept {
+    auto baseline = BenchmarkSuiteResult{};
+    if(!options.compare.empty() && !BenchmarkSuite::LoadJson(options.compare, baseline)) {
+        std::cerr << "Could not read baseline: " << options.compare << '\n';
+        return EXIT_FAILURE;
+    }
+    auto suite_desc = BenchmarkSuiteDesc{};
+    suite_desc.simulation = desc;
+    suite_desc.body_counts = options.suite_body_counts;
+    const auto result = BenchmarkSuite::Run(suite_desc);
+    g_theJobSystem.Shutdown();
+    g_thePhysicsSystem = nullptr;
+
+    std::cout << "workers:    " << options.workers << '\n';
+    PrintSuiteResult(result);
+    if(!BenchmarkSuite::SaveJson(options.suite, result)) {
+        std::cerr << "Could not write suite results: " << options.suite << '\n';
+        return EXIT_FAILURE;
+    }
+    if(options.compare.empty()) {
+        return EXIT_SUCCESS;
+    }
+    if(baseline.workers != result.workers) {
+        std::cout << "The baseline ran with " << baseline.workers << " workers; timings may not be comparable.\n";
+    }
+    const auto regressions = BenchmarkSuite::Compare(baseline, result, options.threshold_percent / 100.0);
+    PrintRegressions(regressions, options.threshold_percent);
+    return regressions.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int RunSelfTest() noexcept {
+    const auto result = SelfTest::Run();
+    g_theJobSystem.Shutdown();
+    g_thePhysicsSystem = nullptr;
+
+    for(const auto& failure : result.failures) {
+        std::cout << "FAILED " << failure << '\n';
+    }
+    std::cout << result.check_count << " checks, " << result.failures.size() << " failed\n";
+    return result.failures.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    auto desc = HeadlessSimulationDesc{};
+    auto stress = GameStateStress::GetSceneDescription();
+    auto options = HeadlessOptions{};
+    if(!ParseArguments(argc, argv, desc, stress, options)) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    auto recording = InputRecording{};
+    if(!options.replay.empty()) {
+        if(!recording.Load(options.replay)) {
+            std::cerr << "Could not read recording: " << options.replay << '\n';
+            return EXIT_FAILURE;
+        }
+        desc.stateId = recording.state_id;
+        stress = recording.stress;
+    }
+    GameStateStress::SetSceneDescription(stress);
+
+    //No renderer, input or UI system is created; the simulation only needs physics.
+    auto physics = std::make_unique<PhysicsSystem>();
+    g_thePhysicsSystem = physics.get();
+    g_thePhysicsSystem->Initialize();
+    g_theJobSystem.Initialize(options.workers);
+
+    if(!options.suite.empty()) {
+        return RunSuite(desc, options);
+    }
+    if(options.self_test) {
+        return RunSelfTest();
+    }
+
+    auto result = HeadlessSimulationResult{};
+    auto replay_result = HeadlessReplayResult{};
+    auto benchmark_results = std::vector<IntegrationBenchmarkResult>{};
+    auto broadphase_results = std::vector<BroadphaseBenchmarkResult>{};
+    auto contact_results = std::vector<ContactBenchmarkResult>{};
+    auto narrowphase_results = std::vector<NarrowphaseBenchmarkResult>{};
+    auto query_result = QueryBenchmarkResult{};
+    auto joint_result = JointStabilityResult{};
+    auto contact_solver_result = ContactSolverResult{};
+    if(options.bench_narrowphase && stress.solve_contacts) {
+        //Each path needs a run of its own, since the solver feeds back into the scene.
+        narrowphase_results = BenchmarkSolvedNarrowphase(desc);
+    } else {
+        HeadlessSimulation simulation{desc};
+        if(options.bench_integrate) {
+            benchmark_results = simulation.BenchmarkIntegration();
+        } else if(options.bench_broadphase) {
+            broadphase_results = simulation.BenchmarkBroadphase(stress.broadphase);
+        } else if(options.bench_contacts) {
+            contact_results = simulation.BenchmarkContacts(stress.contacts);
+        } else if(options.bench_narrowphase) {
+            narrowphase_results = simulation.BenchmarkNarrowphase(stress.contacts);
+        } else if(options.bench_queries) {
+            query_result = simulation.BenchmarkQueries(options.bench_queries);
+        } else if(options.check_joints) {
+            joint_result = simulation.CheckJointStability();
+        } else if(options.check_contacts) {
+            contact_solver_result = simulation.CheckContactSolver();
+        } else if(options.replay.empty()) {
+            result = simulation.Run();
+        } else {
+            replay_result = simulation.Replay(recording);
+        }
+    }
+    g_theJobSystem.Shutdown();
+    g_thePhysicsSystem = nullptr;
+
+    std::cout << "workers:    " << options.workers << '\n';
+    if(options.bench_integrate) {
+        PrintIntegrationBenchmark(benchmark_results);
+    } else if(options.bench_broadphase) {
+        PrintBroadphaseBenchmark(broadphase_results);
+    } else if(options.bench_contacts) {
+        PrintContactBenchmark(contact_results);
+    } else if(options.bench_narrowphase) {
+        PrintNarrowphaseBenchmark(narrowphase_results);
+    } else if(options.bench_queries) {
+        PrintQueryBenchmark(query_result);
+    } else if(options.check_joints) {
+        PrintJointStability(joint_result);
+    } else if(options.check_contacts) {
+        PrintContactSolver(contact_solver_result);
+    } else if(!options.replay.empty()) {
+        PrintReplayResult(replay_result);
+    } else {
+        std::cout << "setup:      " << result.setup_milliseconds << " ms\n"
+                  << "steps:      " << result.steps << '\n'
+                  << "total:      " << result.total_seconds << " s\n"
+                  << "steps/sec:  " << result.steps_per_second << '\n'
+                  << "ms/step:    " << result.milliseconds_per_step << '\n'
+                  << "allocs/step: " << result.allocations_per_step << '\n';
+        if(desc.debug_draw) {
+            std::cout << "draws/step: " << result.debug_draws_per_step << '\n'
+                      << "shapes/step: " << result.debug_shapes_per_step << '\n'
+                      << "verts/step: " << result.debug_vertices_per_step << '\n';
+        }
+    }
+    if(!options.profile_csv.empty()) {
+#if !defined(FINAL_BUILD)
+        if(!g_theFrameProfiler.ExportCsv(options.profile_csv)) {
+            std::cerr << "Could not write profile: " << options.profile_csv << '\n';
+            return EXIT_FAILURE;
+        }
+#else
+        std::cerr << "Profiling is compiled out of FinalBuild.\n";
+#endif
+    }
+    if(options.check_joints && !joint_result.is_bounded) {
+        return EXIT_FAILURE;
+    }
+    //A diverged replay fails so scripts can bisect on it.
+    return replay_result.divergent_frames ? EXIT_FAILURE : EXIT_SUCCESS;
+}
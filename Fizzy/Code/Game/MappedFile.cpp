@@ -0,0 +1,112 @@
+#include "Game/MappedFile.hpp"
+
+#ifdef _WIN32
+#include "Engine/Core/Win.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() noexcept {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::filesystem::path& filepath) noexcept {
+    Close();
+    auto file = ::CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size{};
+    if(!::GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        ::CloseHandle(file);
+        return false;
+    }
+    auto mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping) {
+        ::CloseHandle(file);
+        return false;
+    }
+    auto* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!view) {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return false;
+    }
+    _file_handle = file;
+    _mapping_handle = mapping;
+    _data = static_cast<const unsigned char*>(view);
+    _size = static_cast<std::size_t>(file_size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() noexcept {
+    if(_data) {
+        ::UnmapViewOfFile(_data);
+    }
+    if(_mapping_handle) {
+        ::CloseHandle(_mapping_handle);
+    }
+    if(_file_handle) {
+        ::CloseHandle(_file_handle);
+    }
+    _file_handle = nullptr;
+    _mapping_handle = nullptr;
+    _data = nullptr;
+    _size = 0u;
+}
+
+#else
+
+bool MappedFile::Open(const std::filesystem::path& filepath) noexcept {
+    Close();
+    const auto file_descriptor = ::open(filepath.c_str(), O_RDONLY);
+    if(file_descriptor < 0) {
+        return false;
+    }
+    struct stat file_stats{};
+    if(::fstat(file_descriptor, &file_stats) != 0 || file_stats.st_size == 0) {
+        ::close(file_descriptor);
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(file_stats.st_size);
+    auto* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    if(view == MAP_FAILED) {
+        ::close(file_descriptor);
+        return false;
+    }
+    _file_descriptor = file_descriptor;
+    _data = static_cast<const unsigned char*>(view);
+    _size = size;
+    return true;
+}
+
+void MappedFile::Close() noexcept {
+    if(_data) {
+        ::munmap(const_cast<unsigned char*>(_data), _size);
+    }
+    if(_file_descriptor >= 0) {
+        ::close(_file_descriptor);
+    }
+    _file_descriptor = -1;
+    _data = nullptr;
+    _size = 0u;
+}
+
+#endif
+
+bool MappedFile::IsOpen() const noexcept {
+    return _data != nullptr;
+}
+
+const unsigned char* MappedFile::GetData() const noexcept {
+    return _data;
+}
+
+std::size_t MappedFile::GetSize() const noexcept {
+    return _size;
+}
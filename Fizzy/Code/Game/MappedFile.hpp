@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+//Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) = delete;
+    ~MappedFile() noexcept;
+
+    [[nodiscard]] bool Open(const std::filesystem::path& filepath) noexcept;
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept;
+    [[nodiscard]] const unsigned char* GetData() const noexcept;
+    [[nodiscard]] std::size_t GetSize() const noexcept;
+
+protected:
+private:
+#ifdef _WIN32
+    void* _file_handle{};
+    void* _mapping_handle{};
+#else
+    int _file_descriptor{-1};
+#endif
+    const unsigned char* _data{};
+    std::size_t _size{};
+};
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+//Pool with stable element addresses. Elements live in fixed-size chunks that
+//never move, so pointers handed out (e.g. to the physics system or to joints)
+//stay valid until that element is erased. Generational handles detect use
+//after erase: a slot's generation only ever grows, so a handle to an erased
+//element never matches whatever later reuses its slot. Live elements are
+//also tracked in a dense list for indexed access; erasing swaps the last
+//element's index into the gap, so both insertion and removal are O(1).
+template<typename T, std::size_t ChunkSize = 256u>
+class ObjectPool {
+public:
+    struct Handle {
+        uint32_t slot = std::numeric_limits<uint32_t>::max();
+        uint32_t generation = 0u;
+
+        [[nodiscard]] bool operator==(const Handle& rhs) const noexcept {
+            return slot == rhs.slot && generation == rhs.generation;
+        }
+        [[nodiscard]] bool operator!=(const Handle& rhs) const noexcept {
+            return !(*this == rhs);
+        }
+    };
+
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool& other) = delete;
+    ObjectPool(ObjectPool&& other) noexcept = default;
+    ObjectPool& operator=(const ObjectPool& other) = delete;
+    ObjectPool& operator=(ObjectPool&& other) noexcept {
+        if(this != &other) {
+            clear();
+            _chunks = std::move(other._chunks);
+            _generations = std::move(other._generations);
+            _slot_to_dense = std::move(other._slot_to_dense);
+            _dense_to_slot = std::move(other._dense_to_slot);
+            _free_slots = std::move(other._free_slots);
+        }
+        return *this;
+    }
+    ~ObjectPool() noexcept {
+        clear();
+    }
+
+    template<typename... Args>
+    Handle emplace_back(Args&&... args) {
+        const auto slot = AcquireSlot();
+        try {
+            ::new(static_cast<void*>(GetSlotAddress(slot))) T(std::forward<Args>(args)...);
+        } catch(...) {
+            _free_slots.push_back(slot);
+            throw;
+        }
+        _slot_to_dense[slot] = static_cast<uint32_t>(_dense_to_slot.size());
+        _dense_to_slot.push_back(slot);
+        return Handle{slot, _generations[slot]};
+    }
+
+    Handle push_back(T&& value) {
+        return emplace_back(std::move(value));
+    }
+
+    //Returns false for a handle that is no longer valid.
+    bool erase(const Handle& handle) noexcept {
+        if(!IsValid(handle)) {
+            return false;
+        }
+        const auto slot = handle.slot;
+        std::destroy_at(GetSlotAddress(slot));
+        const auto dense_index = _slot_to_dense[slot];
+        const auto last_slot = _dense_to_slot.back();
+        _dense_to_slot[dense_index] = last_slot;
+        _slot_to_dense[last_slot] = dense_index;
+        _dense_to_slot.pop_back();
+        ReleaseSlot(slot);
+        return true;
+    }
+
+    //Erases the element at the last index, which leaves every other index alone.
+    void pop_back() noexcept {
+        const auto slot = _dense_to_slot.back();
+        std::destroy_at(GetSlotAddress(slot));
+        _dense_to_slot.pop_back();
+        ReleaseSlot(slot);
+    }
+
+    //Destroys every element but keeps the chunks for reuse. Released last to
+    //first, so refilling the pool takes the slots back in their old order.
+    void clear() noexcept {
+        for(auto i = _dense_to_slot.size(); i > 0u; --i) {
+            const auto slot = _dense_to_slot[i - 1u];
+            std::destroy_at(GetSlotAddress(slot));
+            ReleaseSlot(slot);
+        }
+        _dense_to_slot.clear();
+    }
+
+    //Releases all chunks. Only valid when the pool is empty. The generations
+    //are kept, so handles from before still fail IsValid.
+    void shrink_to_fit() noexcept {
+        if(empty()) {
+            for(auto& chunk : _chunks) {
+                chunk.reset();
+            }
+        }
+    }
+
+    void reserve(std::size_t count) {
+        while(_chunks.size() * ChunkSize < count) {
+            _chunks.push_back(std::make_unique<Chunk>());
+        }
+        _generations.reserve(count);
+        _slot_to_dense.reserve(count);
+        _dense_to_slot.reserve(count);
+        _free_slots.reserve(count);
+    }
+
+    [[nodiscard]] bool IsValid(const Handle& handle) const noexcept {
+        return handle.slot < _generations.size() && _generations[handle.slot] == handle.generation && _slot_to_dense[handle.slot] != invalid_index;
+    }
+
+    [[nodiscard]] T* Get(const Handle& handle) noexcept {
+        return IsValid(handle) ? GetSlotAddress(handle.slot) : nullptr;
+    }
+
+    [[nodiscard]] const T* Get(const Handle& handle) const noexcept {
+        return IsValid(handle) ? GetSlotAddress(handle.slot) : nullptr;
+    }
+
+    [[nodiscard]] Handle GetHandle(std::size_t index) const noexcept {
+        const auto slot = _dense_to_slot[index];
+        return Handle{slot, _generations[slot]};
+    }
+
+    [[nodiscard]] T& operator[](std::size_t index) noexcept {
+        return *GetSlotAddress(_dense_to_slot[index]);
+    }
+
+    [[nodiscard]] const T& operator[](std::size_t index) const noexcept {
+        return *GetSlotAddress(_dense_to_slot[index]);
+    }
+
+    [[nodiscard]] T& back() noexcept {
+        return (*this)[size() - 1u];
+    }
+
+    [[nodiscard]] const T& back() const noexcept {
+        return (*this)[size() - 1u];
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return _dense_to_slot.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return _dense_to_slot.empty();
+    }
+
+protected:
+private:
+    static inline constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+    struct Chunk {
+        alignas(T) unsigned char storage[sizeof(T) * ChunkSize];
+    };
+
+    [[nodiscard]] uint32_t AcquireSlot() {
+        const auto is_new = _free_slots.empty();
+        const auto slot = is_new ? static_cast<uint32_t>(_generations.size()) : _free_slots.back();
+        //Everything that can throw comes first, so a failure leaves the pool as it was.
+        const auto chunk = slot / ChunkSize;
+        if(chunk >= _chunks.size()) {
+            _chunks.resize(chunk + 1u);
+        }
+        //shrink_to_fit may have released the chunk of a free slot.
+        if(!_chunks[chunk]) {
+            _chunks[chunk] = std::make_unique<Chunk>();
+        }
+        if(!is_new) {
+            _free_slots.pop_back();
+            return slot;
+        }
+        //The free list has room for every slot, so ReleaseSlot never allocates.
+        if(_generations.capacity() <= slot || _slot_to_dense.capacity() <= slot || _free_slots.capacity() <= slot) {
+            const auto capacity = (std::max)(std::size_t{slot} * 2u, ChunkSize);
+            _generations.reserve(capacity);
+            _slot_to_dense.reserve(capacity);
+            _free_slots.reserve(capacity);
+        }
+        _generations.push_back(0u);
+        _slot_to_dense.push_back(invalid_index);
+        return slot;
+    }
+
+    void ReleaseSlot(uint32_t slot) noexcept {
+        ++_generations[slot];
+        _slot_to_dense[slot] = invalid_index;
+        _free_slots.push_back(slot);
+    }
+
+    [[nodiscard]] T* GetSlotAddress(uint32_t slot) const noexcept {
+        auto* const bytes = _chunks[slot / ChunkSize]->storage + (slot % ChunkSize) * sizeof(T);
+        return std::launder(reinterpret_cast<T*>(bytes));
+    }
+
+    std::vector<std::unique_ptr<Chunk>> _chunks{};
+    std::vector<uint32_t> _generations{};
+    std::vector<uint32_t> _slot_to_dense{};
+    std::vector<uint32_t> _dense_to_slot{};
+    std::vector<uint32_t> _free_slots{};
+};
@@ -0,0 +1,534 @@
+#include "Game/Scene.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+#include "Engine/Physics/CableJoint.hpp"
+#include "Engine/Physics/Collider.hpp"
+#include "Engine/Physics/RodJoint.hpp"
+#include "Engine/Physics/SpringJoint.hpp"
+
+#include "Game/FrameProfiler.hpp"
+#include "Game/IState.hpp"
+#include "Game/JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+//Bodies per job system chunk for the per-body passes.
+constexpr std::size_t body_chunk_size = 4096u;
+
+constexpr uint64_t fnv_offset_basis = 14695981039346656037ull;
+constexpr uint64_t fnv_prime = 1099511628211ull;
+
+//Blends along the shorter arc so a wrap from 359 to 0 does not spin the body backwards.
+[[nodiscard]] float BlendOrientationDegrees(float previous, float current, float alpha) noexcept {
+    auto delta = std::fmod(current - previous, 360.0f);
+    if(delta > 180.0f) {
+        delta -= 360.0f;
+    } else if(delta < -180.0f) {
+        delta += 360.0f;
+    }
+    return previous + delta * alpha;
+}
+
+template<typename T>
+void HashBytes(uint64_t& hash, const T& value) noexcept {
+    unsigned char bytes[sizeof(T)]{};
+    std::memcpy(bytes, &value, sizeof(T));
+    for(const auto byte : bytes) {
+        hash = (hash ^ byte) * fnv_prime;
+    }
+}
+
+//Half extents of a box that holds the collider at any orientation.
+Vector2 CalcBoundsHalfExtents(const SceneBodyRecord& record) noexcept {
+    switch(record.collider_type) {
+    case SceneColliderType::Circle: return Vector2{record.size.x, record.size.x};
+    case SceneColliderType::AABB: return record.size;
+    case SceneColliderType::OBB: {
+        const auto radius = record.size.CalcLength();
+        return Vector2{radius, radius};
+    }
+    case SceneColliderType::Polygon: {
+        const auto radius = (std::max)(record.size.x, record.size.y) * 0.5f;
+        return Vector2{radius, radius};
+    }
+    default: ERROR_AND_DIE("SceneColliderType values have changed. Refactor CalcBoundsHalfExtents.");
+    }
+}
+
+} // namespace
+
+SceneView SceneDesc::GetView() const noexcept {
+    return SceneView{&physics, bodies.data(), bodies.size(), joints.data(), joints.size()};
+}
+
+SceneBodyRecord MakeBodyRecord(SceneColliderType type, const Vector2& position, const Vector2& size, const PhysicsMaterial& material /*= PhysicsMaterial{}*/, const PhysicsDesc& physics /*= PhysicsDesc{}*/) noexcept {
+    auto record = SceneBodyRecord{};
+    record.collider_type = type;
+    record.position = position;
+    record.size = size;
+    record.material = material;
+    record.physics = physics;
+    if(type == SceneColliderType::Polygon) {
+        record.polygon_sides = 3u;
+    }
+    return record;
+}
+
+Scene::~Scene() noexcept {
+    Clear();
+}
+
+void Scene::Load(const SceneView& view) noexcept {
+    Build(view);
+    Register();
+}
+
+void Scene::Build(const SceneView& view, LoadProgress* progress /*= nullptr*/) noexcept {
+    Clear();
+    _physics_desc = view.physics ? *view.physics : PhysicsSystemDesc{};
+    _bodies.reserve(view.body_count);
+    _body_records.reserve(view.body_count);
+    for(std::size_t i = 0u; i < view.body_count; ++i) {
+        CreateBody(view.bodies[i]);
+        if(progress && (i % 1024u) == 0u) {
+            progress->fraction.store(static_cast<float>(i) / static_cast<float>(view.body_count), std::memory_order_relaxed);
+        }
+    }
+    //Joints are created by the physics system, so only the valid records are kept until Register.
+    _joint_records.reserve(view.joint_count);
+    for(std::size_t i = 0u; i < view.joint_count; ++i) {
+        const auto& record = view.joints[i];
+        if(record.body_a < _bodies.size() && record.body_b < _bodies.size()) {
+            _joint_records.push_back(record);
+        }
+    }
+    if(progress) {
+        progress->fraction.store(1.0f, std::memory_order_relaxed);
+    }
+}
+
+void Scene::Register() noexcept {
+    if(_is_registered) {
+        return;
+    }
+    std::vector<RigidBody*> body_ptrs(_bodies.size());
+    for(std::size_t i = 0u; i < _bodies.size(); ++i) {
+        body_ptrs[i] = &_bodies[i];
+    }
+    g_thePhysicsSystem->SetWorldDescription(_physics_desc);
+    g_thePhysicsSystem->AddObjects(body_ptrs);
+    _joints.reserve(_joint_records.size());
+    _is_joint_detached.assign(_joint_records.size(), 0u);
+    for(const auto& record : _joint_records) {
+        const auto is_solved_by_game = _joint_solver == SceneJointSolver::Parallel && record.type != SceneJointType::Spring;
+        _joints.push_back(is_solved_by_game ? nullptr : CreateJoint(record));
+    }
+    _is_registered = true;
+}
+
+bool Scene::IsRegistered() const noexcept {
+    return _is_registered;
+}
+
+const PhysicsSystemDesc& Scene::GetPhysicsDescription() const noexcept {
+    return _physics_desc;
+}
+
+void Scene::AddBodies(const SceneBodyRecord* records, std::size_t count) noexcept {
+    //Pooled bodies never move, so only the new bodies are registered.
+    const auto first_new_body = _bodies.size();
+    for(std::size_t i = 0u; i < count; ++i) {
+        CreateBody(records[i]);
+    }
+    _is_broadphase_current = false;
+    if(!_is_registered) {
+        return;
+    }
+    const auto new_size = _bodies.size();
+    std::vector<RigidBody*> new_body_ptrs(new_size - first_new_body);
+    for(auto i = first_new_body; i < new_size; ++i) {
+        new_body_ptrs[i - first_new_body] = &_bodies[i];
+    }
+    g_thePhysicsSystem->AddObjects(new_body_ptrs);
+}
+
+void Scene::AddBody(const SceneBodyRecord& record) noexcept {
+    AddBodies(&record, 1u);
+}
+
+void Scene::Clear() noexcept {
+    if(_is_registered) {
+        g_thePhysicsSystem->RemoveAllObjectsImmediately();
+        _is_registered = false;
+    }
+    _joints.clear();
+    _is_joint_detached.clear();
+    _joint_records.clear();
+    _bodies.clear();
+    _body_records.clear();
+    _previous_positions.clear();
+    _previous_orientations.clear();
+    _snapshot = Snapshot{};
+    _interpolation_alpha = 1.0f;
+    _broadphase.Reset();
+    _is_broadphase_current = false;
+}
+
+SceneDesc Scene::Export() const noexcept {
+    auto desc = SceneDesc{};
+    desc.physics = _physics_desc;
+    desc.bodies = _body_records;
+    desc.joints = _joint_records;
+    for(std::size_t i = 0u; i < _bodies.size(); ++i) {
+        const auto& body = _bodies[i];
+        auto& record = desc.bodies[i];
+        record.position = body.GetPosition();
+        record.velocity = body.GetVelocity();
+        record.acceleration = body.GetAcceleration();
+        record.orientation_degrees = body.GetOrientationDegrees();
+        record.gravity_enabled = body.IsGravityEnabled();
+        record.drag_enabled = body.IsDragEnabled();
+    }
+    return desc;
+}
+
+RigidBody& Scene::GetBody(std::size_t index) noexcept {
+    return _bodies[index];
+}
+
+const RigidBody& Scene::GetBody(std::size_t index) const noexcept {
+    return _bodies[index];
+}
+
+std::size_t Scene::GetBodyCount() const noexcept {
+    return _bodies.size();
+}
+
+const SceneBodyRecord& Scene::GetBodyRecord(std::size_t index) const noexcept {
+    return _body_records[index];
+}
+
+void Scene::SetJointSolver(SceneJointSolver solver) noexcept {
+    _joint_solver = solver;
+}
+
+SceneJointSolver Scene::GetJointSolver() const noexcept {
+    return _joint_solver;
+}
+
+const std::vector<Joint*>& Scene::GetJoints() const noexcept {
+    return _joints;
+}
+
+const SceneJointRecord& Scene::GetJointRecord(std::size_t index) const noexcept {
+    return _joint_records[index];
+}
+
+bool Scene::IsJointIntact(std::size_t index) const noexcept {
+    const auto* joint = _joints[index];
+    const auto& record = _joint_records[index];
+    if(!joint) {
+        return !_is_joint_detached[index];
+    }
+    return joint->GetBodyA() == &_bodies[record.body_a] && joint->GetBodyB() == &_bodies[record.body_b];
+}
+
+void Scene::DetachJoint(std::size_t index, bool is_body_a) noexcept {
+    auto* joint = _joints[index];
+    if(!joint) {
+        _is_joint_detached[index] = 1u;
+        return;
+    }
+    joint->Detach(is_body_a ? joint->GetBodyA() : joint->GetBodyB());
+}
+
+void Scene::StorePreviousTransforms() noexcept {
+    const auto count = _bodies.size();
+    _previous_positions.resize(count);
+    _previous_orientations.resize(count);
+    g_theJobSystem.ParallelFor(count, body_chunk_size, [this](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            _previous_positions[i] = _bodies[i].GetPosition();
+            _previous_orientations[i] = _bodies[i].GetOrientationDegrees();
+        }
+    });
+}
+
+void Scene::SetInterpolationAlpha(float alpha) noexcept {
+    _interpolation_alpha = std::clamp(alpha, 0.0f, 1.0f);
+}
+
+Vector2 Scene::CalcRenderPosition(std::size_t index) const noexcept {
+    const auto& current = _bodies[index].GetPosition();
+    //Bodies added since the last step have nothing to blend with.
+    if(index >= _previous_positions.size()) {
+        return current;
+    }
+    const auto& previous = _previous_positions[index];
+    return previous + (current - previous) * _interpolation_alpha;
+}
+
+float Scene::CalcRenderOrientationDegrees(std::size_t index) const noexcept {
+    const auto current = _bodies[index].GetOrientationDegrees();
+    if(index >= _previous_orientations.size()) {
+        return current;
+    }
+    return BlendOrientationDegrees(_previous_orientations[index], current, _interpolation_alpha);
+}
+
+RenderSnapshot& Scene::BeginRenderSnapshot() noexcept {
+    auto& snapshot = _render_snapshots.GetWriteBuffer();
+    const auto count = _bodies.size();
+    snapshot.bodies.resize(count);
+    snapshot.interpolation_alpha = _interpolation_alpha;
+    g_theJobSystem.ParallelFor(count, body_chunk_size, [this, &snapshot](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            const auto& body = _bodies[i];
+            const auto& record = _body_records[i];
+            auto& out = snapshot.bodies[i];
+            out.position = body.GetPosition();
+            out.orientation_degrees = body.GetOrientationDegrees();
+            //Bodies added since the last step have nothing to blend with.
+            out.previous_position = i < _previous_positions.size() ? _previous_positions[i] : out.position;
+            out.previous_orientation_degrees = i < _previous_orientations.size() ? _previous_orientations[i] : out.orientation_degrees;
+            out.size = record.size;
+            out.polygon_sides = record.polygon_sides;
+            out.collider_type = record.collider_type;
+            out.is_awake = body.IsAwake();
+        }
+    });
+    snapshot.joints.clear();
+    for(std::size_t i = 0u; i < _joints.size(); ++i) {
+        if(IsJointIntact(i)) {
+            const auto& record = _joint_records[i];
+            snapshot.joints.push_back(RenderSnapshotJoint{record.body_a, record.body_b});
+        }
+    }
+    constexpr auto far_away = (std::numeric_limits<float>::max)();
+    snapshot.overlay.Begin(AABB2{Vector2{-far_away, -far_away}, Vector2{far_away, far_away}});
+    return snapshot;
+}
+
+void Scene::PublishRenderSnapshot() noexcept {
+    _render_snapshots.Publish();
+}
+
+void Scene::AcquireRenderSnapshot() noexcept {
+    _render_snapshots.Acquire();
+}
+
+const RenderSnapshot& Scene::GetRenderSnapshot() const noexcept {
+    return _render_snapshots.GetReadBuffer();
+}
+
+Vector2 RenderSnapshot::CalcRenderPosition(std::size_t index) const noexcept {
+    const auto& body = bodies[index];
+    return body.previous_position + (body.position - body.previous_position) * interpolation_alpha;
+}
+
+float RenderSnapshot::CalcRenderOrientationDegrees(std::size_t index) const noexcept {
+    const auto& body = bodies[index];
+    return BlendOrientationDegrees(body.previous_orientation_degrees, body.orientation_degrees, interpolation_alpha);
+}
+
+uint64_t Scene::CalcStateHash() const noexcept {
+    auto hash = fnv_offset_basis;
+    HashBytes(hash, static_cast<uint64_t>(_bodies.size()));
+    for(std::size_t i = 0u; i < _bodies.size(); ++i) {
+        const auto& body = _bodies[i];
+        const auto& position = body.GetPosition();
+        const auto& velocity = body.GetVelocity();
+        HashBytes(hash, position.x);
+        HashBytes(hash, position.y);
+        HashBytes(hash, velocity.x);
+        HashBytes(hash, velocity.y);
+        HashBytes(hash, body.GetOrientationDegrees());
+        HashBytes(hash, body.GetAngularVelocityDegrees());
+    }
+    return hash;
+}
+
+void Scene::CalcBodyBounds(std::vector<AABB2>& bounds) const noexcept {
+    const auto count = _bodies.size();
+    bounds.resize(count);
+    g_theJobSystem.ParallelFor(count, body_chunk_size, [this, &bounds](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            bounds[i] = CalcBodyBounds(i);
+        }
+    });
+}
+
+AABB2 Scene::CalcBodyBounds(std::size_t index) const noexcept {
+    const auto half_extents = CalcBoundsHalfExtents(_body_records[index]);
+    const auto& position = _bodies[index].GetPosition();
+    return AABB2{position - half_extents, position + half_extents};
+}
+
+const SceneBroadphase& Scene::UpdateBroadphase() noexcept {
+    if(!_is_broadphase_current) {
+        PROFILE_STAGE(ProfileStage::Broadphase);
+        _broadphase.Update(*this);
+        _is_broadphase_current = true;
+    }
+    return _broadphase;
+}
+
+void Scene::InvalidateBroadphase() noexcept {
+    _is_broadphase_current = false;
+}
+
+void Scene::CaptureSnapshot() noexcept {
+    const auto count = _bodies.size();
+    _snapshot.positions.resize(count);
+    _snapshot.velocities.resize(count);
+    _snapshot.accelerations.resize(count);
+    _snapshot.orientations.resize(count);
+    _snapshot.angular_velocities.resize(count);
+    _snapshot.flags.resize(count);
+    g_theJobSystem.ParallelFor(count, body_chunk_size, [this](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            const auto& body = _bodies[i];
+            _snapshot.positions[i] = body.GetPosition();
+            _snapshot.velocities[i] = body.GetVelocity();
+            _snapshot.accelerations[i] = body.GetAcceleration();
+            _snapshot.orientations[i] = body.GetOrientationDegrees();
+            _snapshot.angular_velocities[i] = body.GetAngularVelocityDegrees();
+            auto flags = static_cast<uint8_t>(SnapshotFlags_None);
+            flags |= body.IsGravityEnabled() ? SnapshotFlags_Gravity : SnapshotFlags_None;
+            flags |= body.IsDragEnabled() ? SnapshotFlags_Drag : SnapshotFlags_None;
+            flags |= body.IsAwake() ? SnapshotFlags_Awake : SnapshotFlags_None;
+            _snapshot.flags[i] = flags;
+        }
+    });
+    _snapshot.is_valid = true;
+}
+
+bool Scene::RestoreSnapshot() noexcept {
+    const auto count = _snapshot.positions.size();
+    //Bodies are only ever added after a capture, so fewer means the snapshot is not this scene's.
+    if(!_snapshot.is_valid || count > _bodies.size()) {
+        return false;
+    }
+    if(count < _bodies.size() || !AreJointsIntact()) {
+        RestoreBodiesAndJoints(count);
+    }
+    for(std::size_t i = 0u; i < count; ++i) {
+        auto& body = _bodies[i];
+        const auto flags = _snapshot.flags[i];
+        //Teleport so the move is not treated as motion.
+        body.SetPosition(_snapshot.positions[i], true);
+        body.SetVelocity(_snapshot.velocities[i]);
+        body.SetAcceleration(_snapshot.accelerations[i]);
+        body.SetOrientationDegrees(_snapshot.orientations[i]);
+        body.SetAngularVelocityDegrees(_snapshot.angular_velocities[i]);
+        body.EnableGravity(flags & SnapshotFlags_Gravity);
+        body.EnableDrag(flags & SnapshotFlags_Drag);
+        body.SetAwake(flags & SnapshotFlags_Awake);
+    }
+    //Drop the blend with the pre-restart transforms; the buffers are already the right size.
+    if(!_previous_positions.empty()) {
+        StorePreviousTransforms();
+    }
+    _interpolation_alpha = 1.0f;
+    //Sleeping bodies may have been teleported, so their cached bounds are stale.
+    _broadphase.Reset();
+    _is_broadphase_current = false;
+    return true;
+}
+
+void Scene::RestoreBodiesAndJoints(std::size_t body_count) noexcept {
+    //The physics system only removes everything at once, so a registered
+    //scene is taken out like Clear does and registered again below, which
+    //recreates its joints attached to their records' bodies.
+    const auto was_registered = _is_registered;
+    if(was_registered) {
+        g_thePhysicsSystem->RemoveAllObjectsImmediately();
+        _is_registered = false;
+    }
+    _joints.clear();
+    _is_joint_detached.clear();
+    //Last first, so the bodies kept never move.
+    while(_bodies.size() > body_count) {
+        _bodies.pop_back();
+    }
+    _body_records.resize(body_count);
+    if(was_registered) {
+        Register();
+    }
+}
+
+bool Scene::AreJointsIntact() const noexcept {
+    for(std::size_t i = 0u; i < _joints.size(); ++i) {
+        if(!IsJointIntact(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Collider* Scene::CreateCollider(const SceneBodyRecord& record) noexcept {
+    switch(record.collider_type) {
+    case SceneColliderType::Circle: return new ColliderCircle(record.position, record.size.x);
+    case SceneColliderType::AABB: return new ColliderAABB(record.position, record.size);
+    case SceneColliderType::OBB: return new ColliderOBB(record.position, record.size);
+    case SceneColliderType::Polygon: return new ColliderPolygon(static_cast<int>(record.polygon_sides), record.position, record.size, record.orientation_degrees);
+    default: ERROR_AND_DIE("SceneColliderType values have changed. Refactor Scene::CreateCollider.");
+    }
+}
+
+void Scene::CreateBody(const SceneBodyRecord& record) noexcept {
+    _bodies.push_back(RigidBody(RigidBodyDesc(
+        record.position
+        , record.velocity
+        , record.acceleration
+        , CreateCollider(record)
+        , record.material
+        , record.physics
+    )));
+    auto& body = _bodies.back();
+    body.EnableGravity(record.gravity_enabled);
+    body.EnableDrag(record.drag_enabled);
+    if(record.collider_type != SceneColliderType::Polygon && record.orientation_degrees != 0.0f) {
+        body.SetOrientationDegrees(record.orientation_degrees);
+    }
+    _body_records.push_back(record);
+}
+
+Joint* Scene::CreateJoint(const SceneJointRecord& record) noexcept {
+    auto* bodyA = &_bodies[record.body_a];
+    auto* bodyB = &_bodies[record.body_b];
+    switch(record.type) {
+    case SceneJointType::Spring:
+    {
+        SpringJointDef spring{};
+        spring.rigidBodyA = bodyA;
+        spring.rigidBodyB = bodyB;
+        spring.k = record.k;
+        spring.length = record.length;
+        return g_thePhysicsSystem->CreateJoint(spring);
+    }
+    case SceneJointType::Rod:
+    {
+        RodJointDef rod{};
+        rod.rigidBodyA = bodyA;
+        rod.rigidBodyB = bodyB;
+        rod.length = record.length;
+        return g_thePhysicsSystem->CreateJoint(rod);
+    }
+    case SceneJointType::Cable:
+    {
+        CableJointDef cable{};
+        cable.rigidBodyA = bodyA;
+        cable.rigidBodyB = bodyB;
+        cable.length = record.length;
+        return g_thePhysicsSystem->CreateJoint(cable);
+    }
+    default: ERROR_AND_DIE("SceneJointType values have changed. Refactor Scene::CreateJoint.");
+    }
+}
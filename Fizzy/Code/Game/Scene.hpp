@@ -0,0 +1,260 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector2.hpp"
+
+#include "Engine/Physics/Joint.hpp"
+#include "Engine/Physics/PhysicsSystem.hpp"
+#include "Engine/Physics/PhysicsTypes.hpp"
+#include "Engine/Physics/RigidBody.hpp"
+
+#include "Game/DebugDraw.hpp"
+#include "Game/ObjectPool.hpp"
+#include "Game/SceneBroadphase.hpp"
+#include "Game/TripleBuffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+struct LoadProgress;
+
+enum class SceneColliderType : uint8_t {
+    Circle
+    , AABB
+    , OBB
+    , Polygon
+};
+
+enum class SceneJointType : uint8_t {
+    Spring
+    , Rod
+    , Cable
+};
+
+//Plain description of one body. Records are trivially copyable so a scene
+//file can be mapped and read in place.
+struct SceneBodyRecord {
+    Vector2 position{};
+    Vector2 velocity{};
+    Vector2 acceleration{};
+    //Collider size as its constructor takes it: x is the radius of a circle,
+    //the half extents of an AABB or OBB, the extents of a polygon.
+    Vector2 size{};
+    float orientation_degrees{};
+    uint32_t polygon_sides{};
+    PhysicsMaterial material{};
+    PhysicsDesc physics{};
+    SceneColliderType collider_type{SceneColliderType::Circle};
+    bool gravity_enabled = true;
+    bool drag_enabled = true;
+    //Swept against the other bodies after each step so it cannot tunnel; see ContinuousCollision.
+    bool continuous_collision = false;
+};
+
+struct SceneJointRecord {
+    SceneJointType type{SceneJointType::Rod};
+    uint32_t body_a{};
+    uint32_t body_b{};
+    float length{};
+    //Spring constant. Ignored by rods and cables.
+    float k{};
+};
+
+enum class SceneJointSolver : uint8_t {
+    Engine //Every joint is created in and solved by the physics system.
+    , Parallel //Rods and cables are left to ParallelJointSolver; springs stay in the physics system.
+};
+
+static_assert(std::is_trivially_copyable_v<PhysicsSystemDesc>, "Scene files store PhysicsSystemDesc as raw bytes.");
+static_assert(std::is_trivially_copyable_v<SceneBodyRecord>, "Scene files store SceneBodyRecord as raw bytes.");
+static_assert(std::is_trivially_copyable_v<SceneJointRecord>, "Scene files store SceneJointRecord as raw bytes.");
+
+//Non-owning view over scene records, pointing either into a SceneDesc or
+//straight into a memory-mapped scene file.
+struct SceneView {
+    const PhysicsSystemDesc* physics{};
+    const SceneBodyRecord* bodies{};
+    std::size_t body_count{};
+    const SceneJointRecord* joints{};
+    std::size_t joint_count{};
+};
+
+struct SceneDesc {
+    PhysicsSystemDesc physics{};
+    std::vector<SceneBodyRecord> bodies{};
+    std::vector<SceneJointRecord> joints{};
+
+    [[nodiscard]] SceneView GetView() const noexcept;
+};
+
+[[nodiscard]] SceneBodyRecord MakeBodyRecord(SceneColliderType type, const Vector2& position, const Vector2& size, const PhysicsMaterial& material = PhysicsMaterial{}, const PhysicsDesc& physics = PhysicsDesc{}) noexcept;
+
+struct RenderSnapshotBody {
+    Vector2 previous_position{};
+    Vector2 position{};
+    float previous_orientation_degrees{};
+    float orientation_degrees{};
+    Vector2 size{};
+    uint32_t polygon_sides{};
+    SceneColliderType collider_type{SceneColliderType::Circle};
+    bool is_awake = true;
+};
+
+struct RenderSnapshotJoint {
+    uint32_t body_a{};
+    uint32_t body_b{};
+};
+
+//Everything Render needs of a scene, copied out after a batch of steps so it
+//can be drawn while the next batch runs.
+struct RenderSnapshot {
+    std::vector<RenderSnapshotBody> bodies{};
+    //The intact joints, drawn between their bodies' render positions.
+    std::vector<RenderSnapshotJoint> joints{};
+    float interpolation_alpha = 1.0f;
+    //Shapes the state adds from data the steps produce, e.g. contact points. Not culled.
+    DebugShapeBatch overlay{};
+
+    [[nodiscard]] Vector2 CalcRenderPosition(std::size_t index) const noexcept;
+    [[nodiscard]] float CalcRenderOrientationDegrees(std::size_t index) const noexcept;
+};
+
+//Owns the bodies, colliders and joints of a running demo and keeps the
+//record each body was built from, so the live scene can be exported.
+class Scene {
+public:
+    Scene() = default;
+    Scene(const Scene& other) = delete;
+    //The physics system and the joints hold pointers into the scene's bodies.
+    Scene(Scene&& other) = delete;
+    Scene& operator=(const Scene& other) = delete;
+    Scene& operator=(Scene&& other) = delete;
+    //Clears the scene, so the bodies leave the physics system before they are destroyed.
+    ~Scene() noexcept;
+
+    //Build followed by Register.
+    void Load(const SceneView& view) noexcept;
+    //Creates the bodies and colliders without touching the engine, so a scene
+    //can be built off the frame thread. Replaces any previous contents.
+    void Build(const SceneView& view, LoadProgress* progress = nullptr) noexcept;
+    //Sets the world description, adds the bodies and creates the joints.
+    //Must run on the frame thread.
+    void Register() noexcept;
+    [[nodiscard]] bool IsRegistered() const noexcept;
+    [[nodiscard]] const PhysicsSystemDesc& GetPhysicsDescription() const noexcept;
+    //Adds bodies to the scene. If it is registered, only the new bodies are added to the physics system.
+    void AddBodies(const SceneBodyRecord* records, std::size_t count) noexcept;
+    void AddBody(const SceneBodyRecord& record) noexcept;
+    //Unregisters everything from the physics system and releases all bodies and colliders.
+    void Clear() noexcept;
+
+    //The records of the scene with each body's current motion state.
+    [[nodiscard]] SceneDesc Export() const noexcept;
+
+    [[nodiscard]] RigidBody& GetBody(std::size_t index) noexcept;
+    [[nodiscard]] const RigidBody& GetBody(std::size_t index) const noexcept;
+    [[nodiscard]] std::size_t GetBodyCount() const noexcept;
+    [[nodiscard]] const SceneBodyRecord& GetBodyRecord(std::size_t index) const noexcept;
+    //Who solves the scene's rods and cables. Takes effect on the next Register.
+    void SetJointSolver(SceneJointSolver solver) noexcept;
+    [[nodiscard]] SceneJointSolver GetJointSolver() const noexcept;
+    //One entry per joint record once registered; nullptr for joints the physics system does not own.
+    [[nodiscard]] const std::vector<Joint*>& GetJoints() const noexcept;
+    //The record GetJoints()[index] was created from.
+    [[nodiscard]] const SceneJointRecord& GetJointRecord(std::size_t index) const noexcept;
+    //False once the joint was detached from either of its record's bodies.
+    [[nodiscard]] bool IsJointIntact(std::size_t index) const noexcept;
+    //Detaches joint index from its record's body_a, or body_b if is_body_a is
+    //false. A joint the physics system does not own is only marked detached;
+    //rebuild its ParallelJointSolver so it stops being solved.
+    void DetachJoint(std::size_t index, bool is_body_a) noexcept;
+
+    //Fixed-step rendering: the transforms before the latest step are kept so
+    //Render can blend them with the current ones. alpha is the fraction of a
+    //step left in the accumulator; 1 renders the current transforms.
+    void StorePreviousTransforms() noexcept;
+    void SetInterpolationAlpha(float alpha) noexcept;
+    [[nodiscard]] Vector2 CalcRenderPosition(std::size_t index) const noexcept;
+    [[nodiscard]] float CalcRenderOrientationDegrees(std::size_t index) const noexcept;
+
+    //Render snapshots are triple buffered: whoever steps the scene fills the
+    //one BeginRenderSnapshot returns and publishes it, and Render acquires the
+    //newest and reads it through GetRenderSnapshot without locking.
+    //BeginRenderSnapshot copies the bodies and joints and clears the overlay.
+    [[nodiscard]] RenderSnapshot& BeginRenderSnapshot() noexcept;
+    void PublishRenderSnapshot() noexcept;
+    void AcquireRenderSnapshot() noexcept;
+    [[nodiscard]] const RenderSnapshot& GetRenderSnapshot() const noexcept;
+
+    //FNV-1a over every body's position, velocity, orientation and angular
+    //velocity bits. Equal only if the simulation ran bit for bit the same.
+    [[nodiscard]] uint64_t CalcStateHash() const noexcept;
+
+    //Axis-aligned bounds of every body at its current position. Rotating
+    //shapes use their bounding circle so the bounds hold at any orientation.
+    void CalcBodyBounds(std::vector<AABB2>& bounds) const noexcept;
+    [[nodiscard]] AABB2 CalcBodyBounds(std::size_t index) const noexcept;
+
+    //Bounds and overlapping pairs for the passes run after a physics step.
+    //Computed on the first call after InvalidateBroadphase, so those passes
+    //share one broadphase per step instead of each building their own.
+    [[nodiscard]] const SceneBroadphase& UpdateBroadphase() noexcept;
+    //The state machine calls this after every physics step. A pass that
+    //moves bodies calls it too, so the passes after it see the new bounds.
+    void InvalidateBroadphase() noexcept;
+
+    //Copies every body's motion state so a restart can put it back in place.
+    void CaptureSnapshot() noexcept;
+    //Writes the snapshot back into the existing bodies without allocating.
+    //Bodies added since the capture are removed and detached joints
+    //reattached first, which registers the scene again. Returns false, leaving
+    //the scene untouched, if nothing was captured since the last Build or Clear.
+    [[nodiscard]] bool RestoreSnapshot() noexcept;
+
+protected:
+private:
+    enum SnapshotFlags : uint8_t {
+        SnapshotFlags_None = 0u
+        , SnapshotFlags_Gravity = 1u << 0
+        , SnapshotFlags_Drag = 1u << 1
+        , SnapshotFlags_Awake = 1u << 2
+    };
+
+    //One array per field, so capture and restore walk them in lockstep.
+    struct Snapshot {
+        std::vector<Vector2> positions{};
+        std::vector<Vector2> velocities{};
+        std::vector<Vector2> accelerations{};
+        std::vector<float> orientations{};
+        std::vector<float> angular_velocities{};
+        std::vector<uint8_t> flags{};
+        bool is_valid = false;
+    };
+
+    //Truncates the bodies to body_count and recreates the joints from their records.
+    void RestoreBodiesAndJoints(std::size_t body_count) noexcept;
+    [[nodiscard]] bool AreJointsIntact() const noexcept;
+    //One heap collider per body, as the demos have always made them; the body's RigidBodyDesc takes it.
+    [[nodiscard]] Collider* CreateCollider(const SceneBodyRecord& record) noexcept;
+    void CreateBody(const SceneBodyRecord& record) noexcept;
+    [[nodiscard]] Joint* CreateJoint(const SceneJointRecord& record) noexcept;
+
+    PhysicsSystemDesc _physics_desc{};
+    ObjectPool<RigidBody> _bodies{};
+    std::vector<SceneBodyRecord> _body_records{};
+    std::vector<SceneJointRecord> _joint_records{};
+    std::vector<Joint*> _joints{};
+    //Per joint; set for joints the physics system does not own once detached.
+    std::vector<uint8_t> _is_joint_detached{};
+    std::vector<Vector2> _previous_positions{};
+    std::vector<float> _previous_orientations{};
+    Snapshot _snapshot{};
+    TripleBuffer<RenderSnapshot> _render_snapshots{};
+    SceneBroadphase _broadphase{};
+    float _interpolation_alpha = 1.0f;
+    SceneJointSolver _joint_solver{SceneJointSolver::Engine};
+    bool _is_registered = false;
+    bool _is_broadphase_current = false;
+};
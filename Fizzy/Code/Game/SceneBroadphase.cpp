@@ -0,0 +1,133 @@
+#include "Game/SceneBroadphase.hpp"
+
+#include "Game/JobSystem.hpp"
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+//Bodies per job system chunk.
+constexpr std::size_t bounds_chunk_size = 4096u;
+
+//The sleeping hash's results before they are mapped to bodies, one per thread so queries can run in parallel.
+thread_local std::vector<uint32_t> t_query_items{};
+
+BroadphasePair MakeBodyPair(uint32_t a, uint32_t b) noexcept {
+    return a < b ? BroadphasePair{a, b} : BroadphasePair{b, a};
+}
+
+} // namespace
+
+void SceneBroadphase::Update(const Scene& scene) noexcept {
+    const auto start = std::chrono::steady_clock::now();
+    const auto count = scene.GetBodyCount();
+    _bounds.resize(count);
+    _is_asleep.resize(count, 0u);
+    auto asleep_changed = false;
+    _awake_bodies.clear();
+    for(std::size_t i = 0u; i < count; ++i) {
+        const auto is_asleep = static_cast<uint8_t>(!scene.GetBody(i).IsAwake());
+        if(is_asleep != _is_asleep[i]) {
+            _is_asleep[i] = is_asleep;
+            asleep_changed = true;
+            //A body that fell asleep is hashed below with its current bounds.
+            if(is_asleep) {
+                _bounds[i] = scene.CalcBodyBounds(i);
+            }
+        }
+        if(!is_asleep) {
+            _awake_bodies.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if(asleep_changed) {
+        RebuildAsleep();
+    }
+    _stats.rebuilt_asleep = asleep_changed;
+
+    _awake_bounds.resize(_awake_bodies.size());
+    g_theJobSystem.ParallelFor(_awake_bodies.size(), bounds_chunk_size, [this, &scene](std::size_t first, std::size_t last) {
+        for(auto i = first; i < last; ++i) {
+            _awake_bounds[i] = scene.CalcBodyBounds(_awake_bodies[i]);
+            _bounds[_awake_bodies[i]] = _awake_bounds[i];
+        }
+    });
+    _awake.Build(_awake_bounds);
+    _awake.FindPairs(_hash_pairs);
+    //Both index lists are ascending, so mapping back keeps a < b.
+    _pairs.clear();
+    for(const auto& pair : _hash_pairs) {
+        _pairs.push_back(BroadphasePair{_awake_bodies[pair.a], _awake_bodies[pair.b]});
+    }
+    if(!_asleep_bodies.empty()) {
+        for(std::size_t i = 0u; i < _awake_bodies.size(); ++i) {
+            _asleep.Query(_awake_bounds[i], t_query_items);
+            for(const auto item : t_query_items) {
+                _pairs.push_back(MakeBodyPair(_awake_bodies[i], _asleep_bodies[item]));
+            }
+        }
+    }
+    _pairs.insert(std::end(_pairs), std::begin(_asleep_pairs), std::end(_asleep_pairs));
+
+    _stats.hashed_body_count = _awake_bodies.size() + (asleep_changed ? _asleep_bodies.size() : 0u);
+    _stats.asleep_body_count = _asleep_bodies.size();
+    _stats.pair_count = _pairs.size();
+    _stats.update_ms = std::chrono::duration<float, std::milli>{std::chrono::steady_clock::now() - start}.count();
+}
+
+void SceneBroadphase::Reset() noexcept {
+    _is_asleep.clear();
+    _asleep_bodies.clear();
+    _asleep_bounds.clear();
+    _asleep_pairs.clear();
+    _asleep.Build(_asleep_bounds);
+    _stats = SceneBroadphaseStats{};
+}
+
+const std::vector<AABB2>& SceneBroadphase::GetBounds() const noexcept {
+    return _bounds;
+}
+
+const std::vector<BroadphasePair>& SceneBroadphase::GetPairs() const noexcept {
+    return _pairs;
+}
+
+void SceneBroadphase::Query(const AABB2& area, std::vector<uint32_t>& items) const noexcept {
+    _awake.Query(area, items);
+    for(auto& item : items) {
+        item = _awake_bodies[item];
+    }
+    if(_asleep_bodies.empty()) {
+        return;
+    }
+    _asleep.Query(area, t_query_items);
+    for(const auto item : t_query_items) {
+        items.push_back(_asleep_bodies[item]);
+    }
+}
+
+float SceneBroadphase::GetCellSize() const noexcept {
+    return (std::max)(_awake.GetCellSize(), _asleep.GetCellSize());
+}
+
+const SceneBroadphaseStats& SceneBroadphase::GetStats() const noexcept {
+    return _stats;
+}
+
+void SceneBroadphase::RebuildAsleep() noexcept {
+    _asleep_bodies.clear();
+    _asleep_bounds.clear();
+    for(std::size_t i = 0u; i < _is_asleep.size(); ++i) {
+        if(_is_asleep[i]) {
+            _asleep_bodies.push_back(static_cast<uint32_t>(i));
+            _asleep_bounds.push_back(_bounds[i]);
+        }
+    }
+    _asleep.Build(_asleep_bounds);
+    _asleep.FindPairs(_hash_pairs);
+    _asleep_pairs.clear();
+    for(const auto& pair : _hash_pairs) {
+        _asleep_pairs.push_back(BroadphasePair{_asleep_bodies[pair.a], _asleep_bodies[pair.b]});
+    }
+}
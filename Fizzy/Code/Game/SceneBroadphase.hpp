@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+
+#include "Game/Broadphase.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+struct SceneBroadphaseStats {
+    //Bodies whose bounds were computed and hashed this update.
+    std::size_t hashed_body_count{};
+    std::size_t asleep_body_count{};
+    std::size_t pair_count{};
+    //True if the set of sleeping bodies changed and they were hashed again.
+    bool rebuilt_asleep = false;
+    float update_ms{};
+};
+
+//Bounds and overlapping pairs of a scene's bodies, shared by the passes that
+//run after a physics step. Awake bodies are hashed on every Update. Sleeping
+//bodies do not move, so they live in a second hash whose bounds and pairs are
+//kept until a body falls asleep or wakes; awake bodies are queried against it.
+class SceneBroadphase {
+public:
+    SceneBroadphase() = default;
+    SceneBroadphase(const SceneBroadphase& other) = default;
+    SceneBroadphase(SceneBroadphase&& other) = default;
+    SceneBroadphase& operator=(const SceneBroadphase& other) = default;
+    SceneBroadphase& operator=(SceneBroadphase&& other) = default;
+    ~SceneBroadphase() = default;
+
+    void Update(const Scene& scene) noexcept;
+    //Forgets the sleeping bodies' bounds, e.g. after a restore moved them.
+    void Reset() noexcept;
+
+    //One per body, indexed like the scene's bodies.
+    [[nodiscard]] const std::vector<AABB2>& GetBounds() const noexcept;
+    //Every overlapping pair once with a < b, in no particular order.
+    [[nodiscard]] const std::vector<BroadphasePair>& GetPairs() const noexcept;
+    //Replaces the contents of items with every body whose bounds overlap area, each once.
+    //Safe to call from several threads at once while nothing updates the broadphase.
+    void Query(const AABB2& area, std::vector<uint32_t>& items) const noexcept;
+    //The larger of the two hashes' cells, a starting size for searches that widen.
+    [[nodiscard]] float GetCellSize() const noexcept;
+    [[nodiscard]] const SceneBroadphaseStats& GetStats() const noexcept;
+
+protected:
+private:
+    void RebuildAsleep() noexcept;
+
+    SceneBroadphaseStats _stats{};
+    std::vector<AABB2> _bounds{};
+    std::vector<BroadphasePair> _pairs{};
+    //1 for bodies that were asleep when the sleeping hash was built.
+    std::vector<uint8_t> _is_asleep{};
+    //Each hash indexes its own bounds; these map those indices back to bodies.
+    SpatialHashBroadphase _awake{0.0f};
+    std::vector<AABB2> _awake_bounds{};
+    std::vector<uint32_t> _awake_bodies{};
+    SpatialHashBroadphase _asleep{0.0f};
+    std::vector<AABB2> _asleep_bounds{};
+    std::vector<uint32_t> _asleep_bodies{};
+    std::vector<BroadphasePair> _asleep_pairs{};
+    std::vector<BroadphasePair> _hash_pairs{};
+};
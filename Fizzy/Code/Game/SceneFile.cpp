@@ -0,0 +1,168 @@
+#include "Game/SceneFile.hpp"
+
+#include "Game/ContinuousCollision.hpp"
+#include "Game/GameConfig.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t block_alignment = 16u;
+
+constexpr uint64_t AlignBlock(uint64_t offset) noexcept {
+    return (offset + block_alignment - 1u) & ~(block_alignment - 1u);
+}
+
+bool IsBlockInFile(uint64_t offset, uint64_t block_size, std::size_t file_size) noexcept {
+    return offset % block_alignment == 0u && offset <= file_size && block_size <= file_size - offset;
+}
+
+//Checked through the raw byte, since reading a bool that is neither 0 nor 1 is undefined.
+bool IsBoolByteValid(const SceneBodyRecord& body, std::size_t offset) noexcept {
+    return reinterpret_cast<const unsigned char*>(&body)[offset] <= 1u;
+}
+
+//Enum and bool values are raw bytes in the file, so reject any the loader cannot build.
+bool AreRecordsValid(const SceneView& view) noexcept {
+    for(std::size_t i = 0u; i < view.body_count; ++i) {
+        const auto& body = view.bodies[i];
+        if(body.collider_type > SceneColliderType::Polygon) {
+            return false;
+        }
+        //The game's shape code stops at ConvexShape::max_points corners.
+        if(body.collider_type == SceneColliderType::Polygon && (body.polygon_sides < 3u || body.polygon_sides > ConvexShape::max_points)) {
+            return false;
+        }
+        if(!IsBoolByteValid(body, offsetof(SceneBodyRecord, gravity_enabled))
+           || !IsBoolByteValid(body, offsetof(SceneBodyRecord, drag_enabled))
+           || !IsBoolByteValid(body, offsetof(SceneBodyRecord, continuous_collision))) {
+            return false;
+        }
+    }
+    for(std::size_t i = 0u; i < view.joint_count; ++i) {
+        if(view.joints[i].type > SceneJointType::Cable) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+namespace SceneFile {
+
+bool Save(const std::filesystem::path& filepath, const SceneView& view) noexcept {
+    auto header = SceneFileHeader{};
+    header.version = current_version;
+    header.physics_desc_size = static_cast<uint32_t>(sizeof(PhysicsSystemDesc));
+    header.body_record_size = static_cast<uint32_t>(sizeof(SceneBodyRecord));
+    header.joint_record_size = static_cast<uint32_t>(sizeof(SceneJointRecord));
+    header.body_count = static_cast<uint32_t>(view.body_count);
+    header.joint_count = static_cast<uint32_t>(view.joint_count);
+    header.physics_desc_offset = AlignBlock(sizeof(SceneFileHeader));
+    header.bodies_offset = AlignBlock(header.physics_desc_offset + sizeof(PhysicsSystemDesc));
+    header.joints_offset = AlignBlock(header.bodies_offset + sizeof(SceneBodyRecord) * view.body_count);
+    const auto file_size = header.joints_offset + sizeof(SceneJointRecord) * view.joint_count;
+
+    //Assemble the file in memory so it is written with a single call.
+    const auto physics = view.physics ? *view.physics : PhysicsSystemDesc{};
+    std::vector<unsigned char> buffer(static_cast<std::size_t>(file_size), 0u);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + header.physics_desc_offset, &physics, sizeof(physics));
+    if(view.body_count) {
+        std::memcpy(buffer.data() + header.bodies_offset, view.bodies, sizeof(SceneBodyRecord) * view.body_count);
+    }
+    if(view.joint_count) {
+        std::memcpy(buffer.data() + header.joints_offset, view.joints, sizeof(SceneJointRecord) * view.joint_count);
+    }
+
+    std::error_code ec{};
+    if(filepath.has_parent_path()) {
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+    }
+    std::ofstream ofs{filepath, std::ios_base::binary | std::ios_base::trunc};
+    if(!ofs) {
+        return false;
+    }
+    ofs.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(ofs);
+}
+
+bool Build(Scene& scene, const std::filesystem::path& filepath, LoadProgress* progress /*= nullptr*/) noexcept {
+    std::error_code ec{};
+    if(!std::filesystem::exists(filepath, ec)) {
+        return false;
+    }
+    auto file = MappedSceneFile{};
+    if(!file.Open(filepath)) {
+        return false;
+    }
+    scene.Build(file.GetView(), progress);
+    return true;
+}
+
+std::filesystem::path GetFilepath(const std::string& name) noexcept {
+    return std::filesystem::path{g_scene_folderpath} / (name + extension);
+}
+
+std::filesystem::path GetExportFilepath(const std::string& name) noexcept {
+    return std::filesystem::path{g_scene_export_folderpath} / (name + extension);
+}
+
+std::filesystem::path GetLoadFilepath(const std::string& name, bool exported) noexcept {
+    return exported ? GetExportFilepath(name) : GetFilepath(name);
+}
+
+} // namespace SceneFile
+
+bool MappedSceneFile::Open(const std::filesystem::path& filepath) noexcept {
+    Close();
+    if(!_file.Open(filepath)) {
+        return false;
+    }
+    const auto* data = _file.GetData();
+    const auto size = _file.GetSize();
+    if(size < sizeof(SceneFileHeader)) {
+        Close();
+        return false;
+    }
+    auto header = SceneFileHeader{};
+    std::memcpy(&header, data, sizeof(header));
+    const auto expected = SceneFileHeader{};
+    const auto is_valid = std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0
+                          && header.version == SceneFile::current_version
+                          && header.physics_desc_size == sizeof(PhysicsSystemDesc)
+                          && header.body_record_size == sizeof(SceneBodyRecord)
+                          && header.joint_record_size == sizeof(SceneJointRecord)
+                          && IsBlockInFile(header.physics_desc_offset, sizeof(PhysicsSystemDesc), size)
+                          && IsBlockInFile(header.bodies_offset, uint64_t{sizeof(SceneBodyRecord)} * header.body_count, size)
+                          && IsBlockInFile(header.joints_offset, uint64_t{sizeof(SceneJointRecord)} * header.joint_count, size);
+    if(!is_valid) {
+        Close();
+        return false;
+    }
+    //The mapping is page aligned and every block is 16-byte aligned, so the records are read in place.
+    _view.physics = reinterpret_cast<const PhysicsSystemDesc*>(data + header.physics_desc_offset);
+    _view.bodies = reinterpret_cast<const SceneBodyRecord*>(data + header.bodies_offset);
+    _view.body_count = header.body_count;
+    _view.joints = reinterpret_cast<const SceneJointRecord*>(data + header.joints_offset);
+    _view.joint_count = header.joint_count;
+    if(!AreRecordsValid(_view)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedSceneFile::Close() noexcept {
+    _file.Close();
+    _view = SceneView{};
+}
+
+const SceneView& MappedSceneFile::GetView() const noexcept {
+    return _view;
+}
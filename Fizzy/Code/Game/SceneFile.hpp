@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Game/MappedFile.hpp"
+#include "Game/Scene.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+//Binary scene file layout:
+//  SceneFileHeader
+//  PhysicsSystemDesc              at physics_desc_offset
+//  SceneBodyRecord[body_count]    at bodies_offset
+//  SceneJointRecord[joint_count]  at joints_offset
+//Blocks are aligned so a mapped file can be read in place. Records are stored
+//as raw bytes; the size fields reject files written with a different layout.
+struct SceneFileHeader {
+    char magic[4]{'F', 'Z', 'S', 'N'};
+    uint32_t version{};
+    uint32_t physics_desc_size{};
+    uint32_t body_record_size{};
+    uint32_t joint_record_size{};
+    uint32_t body_count{};
+    uint32_t joint_count{};
+    uint32_t reserved{};
+    uint64_t physics_desc_offset{};
+    uint64_t bodies_offset{};
+    uint64_t joints_offset{};
+};
+
+namespace SceneFile {
+
+inline constexpr uint32_t current_version = 2u;
+inline constexpr const char* extension = ".fzscene";
+
+[[nodiscard]] bool Save(const std::filesystem::path& filepath, const SceneView& view) noexcept;
+//Maps the file and builds the scene from it without registering it; see
+//Scene::Build. Returns false if the file is missing or invalid.
+[[nodiscard]] bool Build(Scene& scene, const std::filesystem::path& filepath, LoadProgress* progress = nullptr) noexcept;
+//Path of a named scene in the scene folder.
+[[nodiscard]] std::filesystem::path GetFilepath(const std::string& name) noexcept;
+//Path the Export scene buttons write a named scene to. It is kept out of the
+//scene folder so exporting never replaces the scene a demo loads by default.
+[[nodiscard]] std::filesystem::path GetExportFilepath(const std::string& name) noexcept;
+//The exported scene's path if exported is set, the scene folder's otherwise.
+[[nodiscard]] std::filesystem::path GetLoadFilepath(const std::string& name, bool exported) noexcept;
+
+} // namespace SceneFile
+
+//A scene file mapped into memory. The view points into the mapping and stays
+//valid until the file is closed.
+class MappedSceneFile {
+public:
+    MappedSceneFile() = default;
+    MappedSceneFile(const MappedSceneFile& other) = delete;
+    MappedSceneFile(MappedSceneFile&& other) = delete;
+    MappedSceneFile& operator=(const MappedSceneFile& other) = delete;
+    MappedSceneFile& operator=(MappedSceneFile&& other) = delete;
+    ~MappedSceneFile() = default;
+
+    [[nodiscard]] bool Open(const std::filesystem::path& filepath) noexcept;
+    void Close() noexcept;
+
+    [[nodiscard]] const SceneView& GetView() const noexcept;
+
+protected:
+private:
+    MappedFile _file{};
+    SceneView _view{};
+};
@@ -0,0 +1,214 @@
+#include "Game/SceneQuery.hpp"
+
+#include "Game/JobSystem.hpp"
+#include "Game/Scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+//Queries per job system chunk in the batched forms.
+constexpr std::size_t query_chunk_size = 64u;
+
+ConvexShape MakeCircleShape(float radius) noexcept {
+    auto shape = ConvexShape{};
+    shape.point_count = 1u;
+    shape.radius = radius;
+    return shape;
+}
+
+//The area's corners relative to its center.
+ConvexShape MakeBoundsShape(const AABB2& area) noexcept {
+    const auto half_extents = (area.maxs - area.mins) * 0.5f;
+    auto shape = ConvexShape{};
+    shape.points[0] = Vector2{-half_extents.x, -half_extents.y};
+    shape.points[1] = Vector2{half_extents.x, -half_extents.y};
+    shape.points[2] = Vector2{half_extents.x, half_extents.y};
+    shape.points[3] = Vector2{-half_extents.x, half_extents.y};
+    shape.point_count = 4u;
+    return shape;
+}
+
+AABB2 MakeBoundsAround(const Vector2& point, float half_extent) noexcept {
+    return AABB2{point - Vector2{half_extent, half_extent}, point + Vector2{half_extent, half_extent}};
+}
+
+} // namespace
+
+void SceneQuery::Rebuild(Scene& scene) noexcept {
+    _scene = &scene;
+    _broadphase = &scene.UpdateBroadphase();
+    const auto count = scene.GetBodyCount();
+    _positions.resize(count);
+    _orientations.resize(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        const auto& body = scene.GetBody(i);
+        _positions[i] = body.GetPosition();
+        _orientations[i] = body.GetOrientationDegrees();
+    }
+}
+
+std::size_t SceneQuery::GetBodyCount() const noexcept {
+    return _positions.size();
+}
+
+SceneQueryHit SceneQuery::PickPoint(const Vector2& point) const noexcept {
+    auto candidates = std::vector<uint32_t>{};
+    return PickPoint(point, candidates);
+}
+
+SceneQueryHit SceneQuery::CastRay(const SceneRay& ray) const noexcept {
+    auto candidates = std::vector<uint32_t>{};
+    return CastRay(ray, candidates);
+}
+
+SceneQueryHit SceneQuery::FindNearest(const Vector2& point, float max_distance) const noexcept {
+    auto candidates = std::vector<uint32_t>{};
+    return FindNearest(point, max_distance, candidates);
+}
+
+void SceneQuery::OverlapBounds(const AABB2& area, std::vector<uint32_t>& bodies) const noexcept {
+    Overlap(MakeBoundsShape(area), area.CalcCenter(), area, bodies);
+}
+
+void SceneQuery::OverlapCircle(const Vector2& center, float radius, std::vector<uint32_t>& bodies) const noexcept {
+    Overlap(MakeCircleShape(radius), center, MakeBoundsAround(center, radius), bodies);
+}
+
+void SceneQuery::PickPoints(const std::vector<Vector2>& points, std::vector<SceneQueryHit>& hits) const noexcept {
+    hits.resize(points.size());
+    g_theJobSystem.ParallelFor(points.size(), query_chunk_size, [this, &points, &hits](std::size_t first, std::size_t last) {
+        auto candidates = std::vector<uint32_t>{};
+        for(auto i = first; i < last; ++i) {
+            hits[i] = PickPoint(points[i], candidates);
+        }
+    });
+}
+
+void SceneQuery::CastRays(const std::vector<SceneRay>& rays, std::vector<SceneQueryHit>& hits) const noexcept {
+    hits.resize(rays.size());
+    g_theJobSystem.ParallelFor(rays.size(), query_chunk_size, [this, &rays, &hits](std::size_t first, std::size_t last) {
+        auto candidates = std::vector<uint32_t>{};
+        for(auto i = first; i < last; ++i) {
+            hits[i] = CastRay(rays[i], candidates);
+        }
+    });
+}
+
+void SceneQuery::FindNearest(const std::vector<Vector2>& points, float max_distance, std::vector<SceneQueryHit>& hits) const noexcept {
+    hits.resize(points.size());
+    g_theJobSystem.ParallelFor(points.size(), query_chunk_size, [this, &points, max_distance, &hits](std::size_t first, std::size_t last) {
+        auto candidates = std::vector<uint32_t>{};
+        for(auto i = first; i < last; ++i) {
+            hits[i] = FindNearest(points[i], max_distance, candidates);
+        }
+    });
+}
+
+void SceneQuery::OverlapCircles(const std::vector<Vector2>& centers, float radius, SceneOverlapResults& results) const noexcept {
+    const auto count = centers.size();
+    //Chunks always start at a multiple of the chunk size, so each one owns a slot.
+    auto chunk_bodies = std::vector<std::vector<uint32_t>>((count + query_chunk_size - 1u) / query_chunk_size);
+    results.offsets.assign(count + 1u, 0u);
+    const auto shape = MakeCircleShape(radius);
+    g_theJobSystem.ParallelFor(count, query_chunk_size, [&](std::size_t first, std::size_t last) {
+        auto& bodies = chunk_bodies[first / query_chunk_size];
+        auto overlaps = std::vector<uint32_t>{};
+        for(auto i = first; i < last; ++i) {
+            Overlap(shape, centers[i], MakeBoundsAround(centers[i], radius), overlaps);
+            bodies.insert(std::end(bodies), std::begin(overlaps), std::end(overlaps));
+            results.offsets[i + 1u] = overlaps.size();
+        }
+    });
+    for(std::size_t i = 0u; i < count; ++i) {
+        results.offsets[i + 1u] += results.offsets[i];
+    }
+    results.bodies.clear();
+    results.bodies.reserve(results.offsets.back());
+    for(const auto& bodies : chunk_bodies) {
+        results.bodies.insert(std::end(results.bodies), std::begin(bodies), std::end(bodies));
+    }
+}
+
+SceneQueryHit SceneQuery::PickPoint(const Vector2& point, std::vector<uint32_t>& candidates) const noexcept {
+    FindCandidates(AABB2{point, point}, candidates);
+    const auto point_shape = MakeCircleShape(0.0f);
+    auto result = SceneQueryHit{};
+    for(const auto body : candidates) {
+        if(result.hit && body < result.body) {
+            continue;
+        }
+        if(CalcShapeSeparation(point_shape, point, GetShape(body), _positions[body]).distance <= 0.0f) {
+            result = SceneQueryHit{true, body, 0.0f, point, Vector2::ZERO};
+        }
+    }
+    return result;
+}
+
+SceneQueryHit SceneQuery::CastRay(const SceneRay& ray, std::vector<uint32_t>& candidates) const noexcept {
+    const auto area = AABB2{Vector2{(std::min)(ray.start.x, ray.end.x), (std::min)(ray.start.y, ray.end.y)}
+                          , Vector2{(std::max)(ray.start.x, ray.end.x), (std::max)(ray.start.y, ray.end.y)}};
+    FindCandidates(area, candidates);
+    const auto point_shape = MakeCircleShape(0.0f);
+    const auto displacement = ray.end - ray.start;
+    auto first_hit = TimeOfImpact{};
+    auto first_body = uint32_t{};
+    for(const auto body : candidates) {
+        const auto hit = CalcTimeOfImpact(point_shape, ray.start, displacement, GetShape(body), _positions[body]);
+        if(hit.hit && (!first_hit.hit || hit.t < first_hit.t)) {
+            first_hit = hit;
+            first_body = body;
+        }
+    }
+    if(!first_hit.hit) {
+        return SceneQueryHit{};
+    }
+    const auto length = std::sqrt(displacement.x * displacement.x + displacement.y * displacement.y);
+    return SceneQueryHit{true, first_body, first_hit.t * length, ray.start + displacement * first_hit.t, first_hit.normal};
+}
+
+SceneQueryHit SceneQuery::FindNearest(const Vector2& point, float max_distance, std::vector<uint32_t>& candidates) const noexcept {
+    auto result = SceneQueryHit{};
+    if(_positions.empty()) {
+        return result;
+    }
+    const auto point_shape = MakeCircleShape(0.0f);
+    //Widen the search until the closest body found is inside it: any closer
+    //body would have had bounds within the searched area.
+    auto search_extent = (std::min)(_broadphase->GetCellSize(), max_distance);
+    while(true) {
+        FindCandidates(MakeBoundsAround(point, search_extent), candidates);
+        for(const auto body : candidates) {
+            const auto separation = CalcShapeSeparation(point_shape, point, GetShape(body), _positions[body]);
+            if(separation.distance <= max_distance && (!result.hit || separation.distance < result.distance)) {
+                const auto normal = separation.distance > 0.0f ? separation.normal : Vector2::ZERO;
+                result = SceneQueryHit{true, body, separation.distance, point + normal * separation.distance, normal};
+            }
+        }
+        if((result.hit && result.distance <= search_extent) || search_extent >= max_distance) {
+            return result;
+        }
+        search_extent = (std::min)(search_extent * 2.0f, max_distance);
+    }
+}
+
+void SceneQuery::Overlap(const ConvexShape& shape, const Vector2& position, const AABB2& area, std::vector<uint32_t>& bodies) const noexcept {
+    FindCandidates(area, bodies);
+    bodies.erase(std::remove_if(std::begin(bodies), std::end(bodies), [&](uint32_t body) {
+        return CalcShapeSeparation(shape, position, GetShape(body), _positions[body]).distance > 0.0f;
+    }), std::end(bodies));
+    std::sort(std::begin(bodies), std::end(bodies));
+}
+
+void SceneQuery::FindCandidates(const AABB2& area, std::vector<uint32_t>& candidates) const noexcept {
+    if(!_broadphase) {
+        candidates.clear();
+        return;
+    }
+    _broadphase->Query(area, candidates);
+}
+
+ConvexShape SceneQuery::GetShape(uint32_t body) const noexcept {
+    return ConvexShape::FromRecord(_scene->GetBodyRecord(body), _orientations[body]);
+}
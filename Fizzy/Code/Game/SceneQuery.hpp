@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Vector2.hpp"
+
+#include "Game/ContinuousCollision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Scene;
+class SceneBroadphase;
+
+struct SceneRay {
+    Vector2 start{};
+    Vector2 end{};
+};
+
+struct SceneQueryHit {
+    bool hit = false;
+    uint32_t body{};
+    //From the query point or ray start to point; 0 for a point inside the body.
+    float distance{};
+    //The query point for picks, where the ray meets the body, or the body's closest point.
+    Vector2 point{};
+    //Unit direction from the query towards the body. Zero when the query starts inside it.
+    Vector2 normal{};
+};
+
+//Bodies touched by each query of a batch, stored flat: the bodies of query
+//i are bodies[offsets[i], offsets[i + 1]).
+struct SceneOverlapResults {
+    std::vector<uint32_t> bodies{};
+    std::vector<std::size_t> offsets{};
+};
+
+//Answers "what is here" about a scene from a snapshot of its bodies. Rebuild
+//copies every body's position and orientation and brings the scene's shared
+//SceneBroadphase up to date, so it costs no more hashing than the step's
+//other passes already did. Each query takes the candidates whose bounds it
+//touches from that broadphase and tests them exactly against the bodies'
+//shapes. Queries only read, so any number of them can run at once, and the
+//batched forms split their queries across g_theJobSystem. The scene updates
+//its broadphase after each physics step, so rebuild once per step before
+//querying; bodies moved or added since are not seen until then.
+class SceneQuery {
+public:
+    SceneQuery() = default;
+    //Points into the scene and its broadphase, which are not copied with it.
+    SceneQuery(const SceneQuery& other) = delete;
+    SceneQuery(SceneQuery&& other) = delete;
+    SceneQuery& operator=(const SceneQuery& other) = delete;
+    SceneQuery& operator=(SceneQuery&& other) = delete;
+    ~SceneQuery() = default;
+
+    void Rebuild(Scene& scene) noexcept;
+    [[nodiscard]] std::size_t GetBodyCount() const noexcept;
+
+    //The highest-indexed body containing point, which is the one drawn on top.
+    [[nodiscard]] SceneQueryHit PickPoint(const Vector2& point) const noexcept;
+    //The first body the segment from ray.start to ray.end meets.
+    [[nodiscard]] SceneQueryHit CastRay(const SceneRay& ray) const noexcept;
+    //The body closest to point, if one is within max_distance.
+    [[nodiscard]] SceneQueryHit FindNearest(const Vector2& point, float max_distance) const noexcept;
+    //Replace the contents of bodies with every body touching the area, in index order.
+    void OverlapBounds(const AABB2& area, std::vector<uint32_t>& bodies) const noexcept;
+    void OverlapCircle(const Vector2& center, float radius, std::vector<uint32_t>& bodies) const noexcept;
+
+    //Batched forms. hits[i] answers the i-th query.
+    void PickPoints(const std::vector<Vector2>& points, std::vector<SceneQueryHit>& hits) const noexcept;
+    void CastRays(const std::vector<SceneRay>& rays, std::vector<SceneQueryHit>& hits) const noexcept;
+    void FindNearest(const std::vector<Vector2>& points, float max_distance, std::vector<SceneQueryHit>& hits) const noexcept;
+    void OverlapCircles(const std::vector<Vector2>& centers, float radius, SceneOverlapResults& results) const noexcept;
+
+protected:
+private:
+    //Each takes a scratch vector so batched queries reuse one per chunk.
+    [[nodiscard]] SceneQueryHit PickPoint(const Vector2& point, std::vector<uint32_t>& candidates) const noexcept;
+    [[nodiscard]] SceneQueryHit CastRay(const SceneRay& ray, std::vector<uint32_t>& candidates) const noexcept;
+    [[nodiscard]] SceneQueryHit FindNearest(const Vector2& point, float max_distance, std::vector<uint32_t>& candidates) const noexcept;
+    void Overlap(const ConvexShape& shape, const Vector2& position, const AABB2& area, std::vector<uint32_t>& bodies) const noexcept;
+    //Empty before the first Rebuild.
+    void FindCandidates(const AABB2& area, std::vector<uint32_t>& candidates) const noexcept;
+    [[nodiscard]] ConvexShape GetShape(uint32_t body) const noexcept;
+
+    const Scene* _scene{};
+    const SceneBroadphase* _broadphase{};
+    std::vector<Vector2> _positions{};
+    std::vector<float> _orientations{};
+};
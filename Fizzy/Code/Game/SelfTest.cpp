@@ -0,0 +1,150 @@
+#include "Game/SelfTest.hpp"
+
+#include "Game/ObjectPool.hpp"
+#include "Game/Scene.hpp"
+
+#include <utility>
+
+namespace {
+
+class SelfTestContext {
+public:
+    SelfTestContext(SelfTestResult& result, const char* group) noexcept
+        : _result{&result}
+        , _group{group}
+    {
+        /* DO NOTHING */
+    }
+
+    void Check(bool passed, const char* what) noexcept {
+        ++_result->check_count;
+        if(!passed) {
+            _result->failures.push_back(std::string{_group} + ": " + what);
+        }
+    }
+
+private:
+    SelfTestResult* _result{};
+    const char* _group{};
+};
+
+//Counts its live instances, so the checks can see what the pool destroyed.
+struct PoolItem {
+    explicit PoolItem(int value) noexcept
+        : value{value}
+    {
+        ++live_count;
+    }
+    PoolItem(const PoolItem& other) = delete;
+    PoolItem(PoolItem&& other) noexcept
+        : value{other.value}
+    {
+        ++live_count;
+    }
+    PoolItem& operator=(const PoolItem& other) = delete;
+    PoolItem& operator=(PoolItem&& other) = delete;
+    ~PoolItem() noexcept {
+        --live_count;
+    }
+
+    static inline int live_count = 0;
+    int value{};
+};
+
+void CheckObjectPool(SelfTestResult& result) noexcept {
+    auto test = SelfTestContext{result, "ObjectPool"};
+    //Small chunks so the checks cross chunk boundaries.
+    using Pool = ObjectPool<PoolItem, 4u>;
+    {
+        auto pool = Pool{};
+        std::vector<Pool::Handle> handles{};
+        for(int i = 0; i < 10; ++i) {
+            handles.push_back(pool.emplace_back(i));
+        }
+        const auto* const last = pool.Get(handles[9]);
+        const auto* const kept = pool.Get(handles[2]);
+        test.Check(pool.size() == 10u && PoolItem::live_count == 10, "ten elements after ten adds");
+
+        test.Check(pool.erase(handles[4]), "erasing a live handle succeeds");
+        test.Check(PoolItem::live_count == 9, "erase destroys the element");
+        test.Check(!pool.IsValid(handles[4]) && !pool.Get(handles[4]), "a handle is rejected after its element is erased");
+        test.Check(!pool.erase(handles[4]), "erasing a stale handle fails");
+        test.Check(pool.size() == 9u && &pool[4] == last, "the last element takes the erased index");
+        test.Check(pool.Get(handles[9]) == last && pool.Get(handles[2]) == kept, "erase does not move the other elements");
+
+        const auto reused = pool.emplace_back(42);
+        test.Check(reused.slot == handles[4].slot, "a new element reuses the freed slot");
+        test.Check(!pool.IsValid(handles[4]) && pool.Get(reused) && pool.Get(reused)->value == 42, "the old handle stays stale when its slot is reused");
+        test.Check(pool.GetHandle(pool.size() - 1u) == reused, "GetHandle returns the handle of an index");
+
+        pool.pop_back();
+        test.Check(!pool.IsValid(reused) && pool.size() == 9u, "pop_back erases the last index");
+
+        pool.clear();
+        test.Check(pool.empty() && PoolItem::live_count == 0, "clear destroys every element");
+        test.Check(!pool.IsValid(handles[0]) && !pool.IsValid(handles[9]), "clear makes every handle stale");
+
+        pool.shrink_to_fit();
+        const auto after_shrink = pool.emplace_back(7);
+        test.Check(!pool.IsValid(handles[0]) && !pool.IsValid(handles[9]), "handles stay stale after shrink_to_fit reuses their slots");
+        test.Check(pool.Get(after_shrink) && pool.Get(after_shrink)->value == 7, "the pool refills after shrink_to_fit");
+
+        auto moved = std::move(pool);
+        test.Check(moved.Get(after_shrink) && moved.size() == 1u, "a moved pool keeps its handles");
+    }
+    test.Check(PoolItem::live_count == 0, "destroying the pool destroys its elements");
+}
+
+//Three bodies, a rod between the first two and a cable between the last two.
+SceneDesc CreateRestoreScene() noexcept {
+    auto desc = SceneDesc{};
+    for(int i = 0; i < 3; ++i) {
+        desc.bodies.push_back(MakeBodyRecord(SceneColliderType::Circle, Vector2{100.0f + 60.0f * static_cast<float>(i), 100.0f}, Vector2{10.0f, 10.0f}));
+    }
+    desc.joints.push_back(SceneJointRecord{SceneJointType::Rod, 0u, 1u, 60.0f});
+    desc.joints.push_back(SceneJointRecord{SceneJointType::Cable, 1u, 2u, 60.0f});
+    return desc;
+}
+
+void CheckSceneRestore(SelfTestResult& result, SceneJointSolver solver, const char* group) noexcept {
+    auto test = SelfTestContext{result, group};
+    auto scene = Scene{};
+    test.Check(!scene.RestoreSnapshot(), "restoring without a capture fails");
+    scene.SetJointSolver(solver);
+    scene.Load(CreateRestoreScene().GetView());
+    scene.CaptureSnapshot();
+    const auto* const kept = &scene.GetBody(0u);
+    const auto captured_position = scene.GetBody(0u).GetPosition();
+
+    scene.GetBody(0u).SetPosition(captured_position + Vector2{50.0f, 0.0f}, true);
+    scene.AddBody(MakeBodyRecord(SceneColliderType::Circle, Vector2{300.0f, 300.0f}, Vector2{10.0f, 10.0f}));
+    scene.AddBody(MakeBodyRecord(SceneColliderType::AABB, Vector2{400.0f, 300.0f}, Vector2{10.0f, 10.0f}));
+    scene.DetachJoint(0u, true);
+    test.Check(scene.GetBodyCount() == 5u && !scene.IsJointIntact(0u), "the scene changed after the capture");
+
+    test.Check(scene.RestoreSnapshot(), "restoring after spawns and a detach succeeds");
+    test.Check(scene.GetBodyCount() == 3u, "bodies added after the capture are removed");
+    test.Check(&scene.GetBody(0u) == kept, "the captured bodies do not move in memory");
+    const auto& restored_position = scene.GetBody(0u).GetPosition();
+    test.Check(restored_position.x == captured_position.x && restored_position.y == captured_position.y, "the captured positions are restored");
+    test.Check(scene.IsRegistered() && scene.GetJoints().size() == 2u, "the scene stays registered with every joint");
+    test.Check(scene.IsJointIntact(0u) && scene.IsJointIntact(1u), "detached joints are reattached");
+    test.Check(scene.Export().bodies.size() == 3u, "the removed bodies' records are dropped");
+
+    scene.AddBody(MakeBodyRecord(SceneColliderType::Circle, Vector2{300.0f, 300.0f}, Vector2{10.0f, 10.0f}));
+    test.Check(scene.RestoreSnapshot() && scene.GetBodyCount() == 3u, "the snapshot restores again after more spawns");
+}
+
+} // namespace
+
+namespace SelfTest {
+
+SelfTestResult Run() noexcept {
+    auto result = SelfTestResult{};
+    CheckObjectPool(result);
+    CheckSceneRestore(result, SceneJointSolver::Engine, "Scene restore (engine joints)");
+    CheckSceneRestore(result, SceneJointSolver::Parallel, "Scene restore (parallel joints)");
+    return result;
+}
+
+} // namespace SelfTest
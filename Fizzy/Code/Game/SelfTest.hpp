@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct SelfTestResult {
+    std::size_t check_count = 0u;
+    //One line per failed check, naming the group and what went wrong.
+    std::vector<std::string> failures{};
+};
+
+//Checks of game-side bookkeeping that a change can quietly break and a
+//benchmark would not notice, run by FizzyHeadless --self-test. Each group
+//builds what it checks from scratch, so the groups do not depend on each
+//other or on the state the command line picked.
+namespace SelfTest {
+
+//Needs the physics system and job system initialized.
+[[nodiscard]] SelfTestResult Run() noexcept;
+
+} // namespace SelfTest
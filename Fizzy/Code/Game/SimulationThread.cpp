@@ -0,0 +1,70 @@
+#include "Game/SimulationThread.hpp"
+
+#include <chrono>
+#include <utility>
+
+SimulationThread::~SimulationThread() noexcept {
+    Shutdown();
+}
+
+void SimulationThread::Start(Job job) noexcept {
+    Wait();
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        if(!_is_running) {
+            _is_running = true;
+            _thread = std::thread(&SimulationThread::ThreadLoop, this);
+        }
+        _job = std::move(job);
+        _is_busy = true;
+    }
+    _signal.notify_all();
+}
+
+float SimulationThread::Wait() noexcept {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _signal.wait(lock, [this]() { return !_is_busy; });
+    if(!_has_result) {
+        return 0.0f;
+    }
+    _has_result = false;
+    return _job_milliseconds;
+}
+
+void SimulationThread::Shutdown() noexcept {
+    Wait();
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _is_running = false;
+    }
+    _signal.notify_all();
+    if(_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void SimulationThread::ThreadLoop() noexcept {
+    using clock = std::chrono::steady_clock;
+    for(;;) {
+        auto job = Job{};
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _signal.wait(lock, [this]() { return !_is_running || (_is_busy && _job); });
+            if(!_is_running) {
+                return;
+            }
+            job = std::move(_job);
+            _job = Job{};
+        }
+        const auto start = clock::now();
+        job();
+        const auto elapsed = std::chrono::duration<float, std::milli>{clock::now() - start}.count();
+        {
+            std::scoped_lock<std::mutex> lock(_mutex);
+            _job_milliseconds = elapsed;
+            _has_result = true;
+            _is_busy = false;
+        }
+        _signal.notify_all();
+    }
+}
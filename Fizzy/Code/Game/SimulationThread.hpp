@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//One thread that runs a job handed to it by Start while the caller carries
+//on, until the caller Waits for it. The handoffs through Start and Wait order
+//everything the caller did before Start before the job, and everything the
+//job did before whatever follows Wait, so data the two take turns at needs no
+//locks of its own.
+class SimulationThread {
+public:
+    using Job = std::function<void()>;
+
+    SimulationThread() = default;
+    SimulationThread(const SimulationThread& other) = delete;
+    SimulationThread(SimulationThread&& other) = delete;
+    SimulationThread& operator=(const SimulationThread& other) = delete;
+    SimulationThread& operator=(SimulationThread&& other) = delete;
+    ~SimulationThread() noexcept;
+
+    //Waits for any job still running, then starts job. Starts the thread the first time.
+    void Start(Job job) noexcept;
+    //Blocks until the current job is done. Returns how long it took in
+    //milliseconds, or 0 if no job was started since the last Wait.
+    float Wait() noexcept;
+    void Shutdown() noexcept;
+
+protected:
+private:
+    void ThreadLoop() noexcept;
+
+    std::thread _thread{};
+    std::mutex _mutex{};
+    std::condition_variable _signal{};
+    Job _job{};
+    float _job_milliseconds{};
+    //Between Start and the job finishing.
+    bool _is_busy = false;
+    //A finished job no Wait has returned the time of yet.
+    bool _has_result = false;
+    bool _is_running = false;
+};
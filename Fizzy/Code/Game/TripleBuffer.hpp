@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+//Hands values from one writer thread to one reader thread without locks.
+//The writer fills GetWriteBuffer() and calls Publish. The reader calls
+//Acquire and reads GetReadBuffer(), which is left alone until its next
+//Acquire however often the writer publishes in the meantime. Moving is only
+//safe while neither side is in use.
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer& other) = delete;
+    TripleBuffer(TripleBuffer&& other) noexcept
+        : _buffers{std::move(other._buffers)}
+        , _ready{other._ready.load(std::memory_order_relaxed)}
+        , _write_index{other._write_index}
+        , _read_index{other._read_index}
+    {
+        /* DO NOTHING */
+    }
+    TripleBuffer& operator=(const TripleBuffer& other) = delete;
+    TripleBuffer& operator=(TripleBuffer&& other) noexcept {
+        if(this != &other) {
+            _buffers = std::move(other._buffers);
+            _ready.store(other._ready.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            _write_index = other._write_index;
+            _read_index = other._read_index;
+        }
+        return *this;
+    }
+    ~TripleBuffer() = default;
+
+    [[nodiscard]] T& GetWriteBuffer() noexcept {
+        return _buffers[_write_index];
+    }
+
+    //Makes the write buffer the newest value and takes the spare one to write next.
+    void Publish() noexcept {
+        const auto previous = _ready.exchange(static_cast<uint8_t>(_write_index | fresh_bit), std::memory_order_acq_rel);
+        _write_index = previous & index_mask;
+    }
+
+    //Swaps in the newest published value. Returns false if nothing was published since the last Acquire.
+    bool Acquire() noexcept {
+        if(!(_ready.load(std::memory_order_relaxed) & fresh_bit)) {
+            return false;
+        }
+        const auto previous = _ready.exchange(static_cast<uint8_t>(_read_index), std::memory_order_acq_rel);
+        _read_index = previous & index_mask;
+        return true;
+    }
+
+    [[nodiscard]] const T& GetReadBuffer() const noexcept {
+        return _buffers[_read_index];
+    }
+
+protected:
+private:
+    static inline constexpr uint8_t index_mask = 0b011u;
+    static inline constexpr uint8_t fresh_bit = 0b100u;
+
+    std::array<T, 3> _buffers{};
+    //Index of the buffer between the two sides, plus fresh_bit if the writer published it since the reader last took one.
+    std::atomic<uint8_t> _ready{1u};
+    std::size_t _write_index{0u};
+    std::size_t _read_index{2u};
+};